@@ -0,0 +1,154 @@
+#!/bin/sh
+# 시뮬레이터/예측기 처리량 벤치마크 및 히트 수 회귀 검사
+#
+# 사용법: bench/run_bench.sh [--update-golden]
+#   결과:  $BENCH_OUT/results.csv (기본 BENCH_OUT=/tmp/t30bench)
+#   golden: bench/golden.txt 의 히트 수와 다르면 종료 코드 1
+#   BENCH_CFLAGS 로 빌드 옵션 변경 (예: BENCH_CFLAGS='-O1 -g -fsanitize=address,undefined')
+#   XGBOOST_ROOT 가 설정되어 있으면 xg.c 도 빌드해 특징 추출 처리량/예측 지연을 측정
+#   (예측 지연은 XG_MODEL 모델 파일이 있을 때만)
+
+set -e
+cd "$(dirname "$0")/.."
+OUT=${BENCH_OUT:-/tmp/t30bench}
+GOLDEN=bench/golden.txt
+POLICIES="CLOCK_PRO_T1_B4_LOGS_B2 CLOCK_PRO_T3_B2_LOGS_B4 CLOCK_T1 CLOCK_T3 FIFO LFU LFU_ARC LRU LRU_ARC CLOCK_PRO S3_FIFO SIEVE LIRS"
+BUFFERS="256 1024 4096"
+# 작은 버퍼 + 옵션 회귀 (정책:버퍼:옵션, 옵션의 ',' 는 공백으로). TinyLFU 재적재/선반입이 큐 정책 상태를 깨던 경우
+EDGE_CASES="LIRS:1:--tinylfu=10 LIRS:2:--tinylfu=10 LIRS:1:--readahead=64 LIRS:2:--readahead=64 LIRS:2:--tinylfu=10,--readahead=64"
+# 장치 모델 회귀 (정책:버퍼:옵션). 동기 미스/write-back 과 비동기 flush/선반입 I/O 가 큐 깊이 > 1 의 같은 큐를 나눠 씀
+# golden 값은 "히트 수:평균 장치 대기 us:p99 us:p99.9 us"
+DEVICE_CASES="LRU:1024:--dev-model=nvme,--dev-qd=4,--flush-high=20,--readahead=16 S3_FIFO:1024:--dev-model=sata,--dev-qd=8,--flush-high=30,--flush-order=lba,--readahead=32"
+TRACES="hotcold loop scanmix"
+REQUESTS=100000
+mkdir -p "$OUT"
+
+# --- 빌드 ---
+gcc ${BENCH_CFLAGS:--O2} -pthread test30.c -o "$OUT/test30"
+
+# --- 고정 합성 트레이스 (Park-Miller 난수, awk 구현과 무관하게 재현 가능) ---
+gen_trace() {
+    awk -v kind="$1" -v n="$REQUESTS" '
+    function rnd() { seed = (seed * 16807) % 2147483647; return seed / 2147483647 }
+    BEGIN {
+        seed = 12345; scan = 0
+        for (i = 0; i < n; i++) {
+            if (kind == "hotcold") {            # 80% 요청이 10% 페이지에 집중
+                page = (rnd() < 0.8) ? int(rnd() * 2000) : 2000 + int(rnd() * 18000)
+                op = (rnd() < 0.3) ? "W" : "R"
+            } else if (kind == "loop") {        # 버퍼보다 큰 작업 집합을 반복 순회
+                page = (rnd() < 0.9) ? i % 3000 : int(rnd() * 50000)
+                op = (rnd() < 0.1) ? "W" : "R"
+            } else {                            # 작은 hot set 사이에 긴 순차 scan
+                if (scan == 0 && rnd() < 0.0002) { scan = 2000; base = int(rnd() * 100000) }
+                if (scan > 0) { page = base + (2000 - scan); scan-- }
+                else page = int(rnd() * 1000)
+                op = (rnd() < 0.2) ? "W" : "R"
+            }
+            print page * 8, op
+        }
+    }' > "$OUT/$1.txt"
+}
+for t in $TRACES; do gen_trace "$t"; done
+
+# --- 정책 x 버퍼 크기 처리량 ---
+RESULTS="$OUT/results.csv"
+NEW_GOLDEN="$OUT/golden.txt"
+echo "trace,policy,buffer,requests,seconds,req_per_sec,hits,golden_hits,status" > "$RESULTS"
+: > "$NEW_GOLDEN"
+failed=0
+for t in $TRACES; do
+    for p in $POLICIES; do
+        for b in $BUFFERS; do
+            start=$(date +%s%N)
+            hits=$("$OUT/test30" "$b" "$p" "$OUT/$t.txt" 0 2>/dev/null | awk -F'|' '/캐시 히트 수/ { gsub(/[^0-9]/, "", $2); print $2 }')
+            end=$(date +%s%N)
+            rm -f "$OUT/$t.txt_"*.fio.log
+            secs=$(awk -v a="$start" -v b="$end" 'BEGIN { printf "%.4f", (b - a) / 1e9 }')
+            rps=$(awk -v n="$REQUESTS" -v s="$secs" 'BEGIN { printf "%.0f", (s > 0) ? n / s : 0 }')
+            golden=
+            [ -f "$GOLDEN" ] && golden=$(awk -v t="$t" -v p="$p" -v b="$b" '$1 == t && $2 == p && $3 == b { print $4 }' "$GOLDEN")
+            status=ok
+            if [ -z "$golden" ]; then status=no_golden
+            elif [ "$golden" != "$hits" ]; then status=MISMATCH; failed=1
+            fi
+            echo "$t $p $b $hits" >> "$NEW_GOLDEN"
+            echo "$t,$p,$b,$REQUESTS,$secs,$rps,$hits,$golden,$status" >> "$RESULTS"
+            printf '%-8s %-24s %5s  %10s req/s  hits %-8s %s\n' "$t" "$p" "$b" "$rps" "$hits" "$status"
+        done
+    done
+done
+
+# --- 작은 버퍼 + 옵션 회귀 (비정상 종료도 실패) ---
+for t in $TRACES; do
+    for c in $EDGE_CASES; do
+        p=${c%%:*}; rest=${c#*:}; b=${rest%%:*}; opts=$(echo "${rest#*:}" | tr ',' ' ')
+        name="$p$(echo ",${rest#*:}" | sed 's/,--/+/g')"
+        # shellcheck disable=SC2086
+        if out=$("$OUT/test30" "$b" "$p" "$OUT/$t.txt" 0 $opts 2>&1); then
+            hits=$(printf '%s\n' "$out" | awk -F'|' '/캐시 히트 수/ { gsub(/[^0-9]/, "", $2); print $2 }')
+        else
+            hits=CRASH
+        fi
+        rm -f "$OUT/$t.txt_"*.fio.log
+        golden=
+        [ -f "$GOLDEN" ] && golden=$(awk -v t="$t" -v p="$name" -v b="$b" '$1 == t && $2 == p && $3 == b { print $4 }' "$GOLDEN")
+        status=ok
+        if [ "$hits" = CRASH ] || printf '%s' "$out" | grep -q 'runtime error'; then status=CRASH; failed=1
+        elif [ -z "$golden" ]; then status=no_golden
+        elif [ "$golden" != "$hits" ]; then status=MISMATCH; failed=1
+        fi
+        echo "$t $name $b $hits" >> "$NEW_GOLDEN"
+        echo "$t,$name,$b,$REQUESTS,,,$hits,$golden,$status" >> "$RESULTS"
+        printf '%-8s %-24s %5s  %10s        hits %-8s %s\n' "$t" "$name" "$b" "" "$hits" "$status"
+    done
+done
+
+# --- 장치 모델 회귀: 히트 수에 더해 큐 대기와 꼬리 지연도 비교 ---
+for t in $TRACES; do
+    for c in $DEVICE_CASES; do
+        p=${c%%:*}; rest=${c#*:}; b=${rest%%:*}; opts=$(echo "${rest#*:}" | tr ',' ' ')
+        name="$p$(echo ",${rest#*:}" | sed 's/,--/+/g')"
+        # shellcheck disable=SC2086
+        if out=$("$OUT/test30" "$b" "$p" "$OUT/$t.txt" 0 $opts 2>&1); then
+            value=$(printf '%s\n' "$out" | awk -F'|' -v p="$p" '
+                /캐시 히트 수/ { gsub(/[^0-9]/, "", $2); hits = $2 }
+                /평균 장치 대기/ { wait = $0; sub(/.*평균 장치 대기 /, "", wait); sub(/ us.*/, "", wait) }
+                $1 ~ "^ " p " " { split($0, f, " "); p99 = f[5] ":" f[6] }
+                END { print hits ":" wait ":" p99 }')
+        else
+            value=CRASH
+        fi
+        rm -f "$OUT/$t.txt_"*.fio.log
+        golden=
+        [ -f "$GOLDEN" ] && golden=$(awk -v t="$t" -v p="$name" -v b="$b" '$1 == t && $2 == p && $3 == b { print $4 }' "$GOLDEN")
+        status=ok
+        if [ "$value" = CRASH ] || printf '%s' "$out" | grep -q 'runtime error'; then status=CRASH; failed=1
+        elif [ -z "$golden" ]; then status=no_golden
+        elif [ "$golden" != "$value" ]; then status=MISMATCH; failed=1
+        fi
+        echo "$t $name $b $value" >> "$NEW_GOLDEN"
+        echo "$t,$name,$b,$REQUESTS,,,$value,$golden,$status" >> "$RESULTS"
+        printf '%-8s %-24s %5s  %10s        dev  %-18s %s\n' "$t" "$name" "$b" "" "$value" "$status"
+    done
+done
+
+# --- 예측기 (xg.c) ---
+if [ -n "$XGBOOST_ROOT" ]; then
+    gcc -O2 xg.c -o "$OUT/predictor" -I"$XGBOOST_ROOT/include" -L"$XGBOOST_ROOT/lib" -lxgboost -lm
+    model=-
+    [ -n "$XG_MODEL" ] && [ -f "$XG_MODEL" ] && model=$XG_MODEL
+    LD_LIBRARY_PATH="$XGBOOST_ROOT/lib:$LD_LIBRARY_PATH" "$OUT/predictor" --bench "$OUT/hotcold.txt" "$model" 10000 1000 \
+        | awk -F, '/^BENCH,/ { print; print "xg,"$2",,,,"$3",,," >> "'"$RESULTS"'" }'
+fi
+
+if [ "$1" = "--update-golden" ]; then
+    cp "$NEW_GOLDEN" "$GOLDEN"
+    echo "golden 갱신: $GOLDEN"
+    exit 0
+fi
+echo "결과: $RESULTS"
+if [ $failed -ne 0 ]; then
+    echo "히트 수가 golden 과 다릅니다." >&2
+    exit 1
+fi
@@ -5,6 +5,36 @@
 #include <ctype.h>   // For tolower
 #include <limits.h>  // For ULLONG_MAX, UINT_MAX
 #include <errno.h>   // For errno and strerror
+#include <time.h>    // For clock_gettime
+#include <unistd.h>  // For fork, pipe, sysconf (--label)
+#include <sys/wait.h>
+#include <sys/mman.h>  // For mmap (--restore)
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <pthread.h>   // For --concurrent (빌드 시 -pthread)
+#include <stdatomic.h>
+
+// xg.c 예측기와 같은 특징 추출 코드 (--label). libm 을 링크하지 않으므로 log2 는 자체 구현 사용
+static double gen_log(double x);
+#define TRACE_FEATURES_LOG2(x) (gen_log(x) / 0.69314718055994530942)
+#include "trace_features.h"
+
+// 단계별 프로파일링 (기본은 컴파일에서 제외)
+//   -DT30_PROFILE      : rdtsc 로 단계별 사이클 측정
+//   -DT30_PROFILE_PERF : perf_event_open 으로 cycles/instructions/cache-misses 추가 측정 (Linux)
+#if defined(T30_PROFILE_PERF) && !defined(T30_PROFILE)
+#define T30_PROFILE
+#endif
+#ifdef T30_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef T30_PROFILE_PERF
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#endif
 
 // --- 기본 설정 ---
 #define MAX_BUFFER_SIZE 65000     // 버퍼의 최대 크기 (필요시 조정)
@@ -15,14 +45,102 @@
 #define SECTOR_SIZE 512           // 표준 섹터 크기 (바이트)
 #define SECTORS_PER_PAGE 8        // 페이지당 섹터 수 (예: 4KB 페이지 / 512B 섹터 LBA)
 #define INVALID_PAGE ULLONG_MAX   // 유효하지 않은 페이지 ID
+#define TRACE_TEXT_MAX 80          // 텍스트 트레이스 한 줄의 최대 길이 ("@시각 LBA Op 길이", 줄바꿈 제외)
+#define MAX_REQUEST_PAGES 65536ULL // 요청 하나가 걸칠 수 있는 최대 페이지 수 (4KB 페이지면 256MB), 넘으면 경고 후 무시
 
 // Operation Types
 #define OP_READ 0
 #define OP_WRITE 1
+#define OP_TRIM 2   // FIO 로그 전용: zbd 모드의 fio는 zone 범위 trim을 zone reset 으로 처리
+
+// --- 더티 페이지 flusher 설정 ---
+#define FLUSH_DEFAULT_BATCH 32            // 한 번에 flush 할 페이지 수
+#define FLUSH_MAX_CLEAN_WINDOW 64         // 청결 희생자 선호 시 건너뛸 수 있는 최대 더티 후보 수
+#define ZNS_COST_DEFAULT_PENALTY 8        // --zns-cost 에서 비순차 write-back 이 될 더티 후보에 더하는 비용 (후보 순위 단위)
+
+// --- 선반입(readahead) 설정 ---
+#define RA_DEFAULT_MIN_WINDOW 4           // 스트림 감지 직후 선반입 윈도우 (페이지)
+#define RA_DEFAULT_STREAMS 32             // 동시에 추적하는 스트림 수
+#define RA_MAX_STREAMS 256
+#define RA_DEFAULT_REGION_PAGES 256       // 새 스트림의 stride 를 감지하는 영역 크기 (페이지)
+#define RA_DEFAULT_MAX_PCT 25             // 참조되지 않은 선반입 페이지가 차지할 수 있는 버퍼 비율 (%)
+#define RA_TRIGGER_CONFIDENCE 2           // stride 가 연속으로 이만큼 맞으면 선반입 시작
+#define RANGE_PROBE_BATCH 256             // 다중 페이지 요청에서 한 번에 인덱스를 조회하는 페이지 수
+#define ACCESS_BATCH 64                   // access_batch 로 한 번에 넘기는 요청 수
+#define ACCESS_PREFETCH_AHEAD 8           // 이만큼 앞선 요청의 색인 버킷을, 절반만큼 앞선 요청의 프레임을 prefetch
+
+// --- 프로파일링 단계 ---
+typedef enum {
+    PROF_OTHER,     // 요청 처리 중 아래 단계에 속하지 않는 나머지 (히트 처리, 적재, 선반입, flush 판단 등)
+    PROF_INDEX,     // 버퍼 인덱스 조회
+    PROF_VICTIM,    // 희생자 선택
+    PROF_GHOST,     // 고스트 리스트 탐색/추가/삭제
+    PROF_ADAPT,     // ARC p/q 조정 및 적재 리스트 결정
+    PROF_LOG,       // write_fio_log (ZNS 검사, FIO 로그, 장치 모델)
+    PROF_PHASES
+} ProfPhase;
+
+#ifdef T30_PROFILE
+#define PROF_BEGIN(phase) prof_begin(phase)
+#define PROF_END() prof_end()
+#else
+#define PROF_BEGIN(phase) ((void)0)
+#define PROF_END() ((void)0)
+#endif
+
+// --- 트레이스 형식 ---
+#define TRACE_BINARY_MAGIC "T30TRACE"   // 바이너리 트레이스 파일 시작 8바이트
+#define TRACE_BINARY_VERSION 1
+#define TRACE_FLAG_HAS_TIME 0x01         // 바이너리 레코드의 time_ns 가 유효함
+#define GEN_MAX_PHASES 256
+#define GEN_MAX_STREAMS 1024
+#define GEN_MAX_ZIPF_PAGES (1ULL << 24)    // zipf alias 테이블 최대 크기 (페이지)
+#define GEN_OUT_BUFFER (4 << 20)           // 생성기 출력 버퍼 크기
+#define GEN_ZIPF_AHEAD 16                  // zipf alias 칸을 이만큼 앞서 뽑아 캐시 미스를 겹침
+#define LABEL_DEFAULT_WINDOW 100000        // --label 창 크기 (요청 수)
+
+// --- 체크포인트 ---
+#define CKPT_MAGIC "T30CKPT"               // 체크포인트 파일 시작 8바이트 (NUL 포함)
+#define CKPT_VERSION 2
+
+// --- 해시 샤드 시뮬레이션 ---
+#define SHARD_MAX 256                      // --shards 최대 값
+#define SHARD_PIPE_BUFFER (1 << 16)        // 파서 -> 샤드 큐 stdio 버퍼 크기
+
+// --- 동시 접근 버퍼 풀 모드 ---
+#define CONC_MAX_THREADS 256
+#define CONC_STRIPES 1024                  // lock-free CLOCK 페이지 색인 잠금 stripe 수 (2의 거듭제곱)
+#define CONC_CHUNK 64                      // 스레드가 한 번에 가져가는 요청 수
+
+// --- 장치 지연/큐잉 모델 설정 ---
+#define DEV_MAX_CHANNELS 64
+#define DEV_MAX_QUEUE_DEPTH 4096
+#define DEV_DEFAULT_HIT_NS 200            // 버퍼 히트 1 페이지 처리 시간 (ns)
+#define HIST_SUB_BITS 7                   // 지연 히스토그램 정밀도: 2^(SUB_BITS-1) 하위 구간 (상대 오차 < 1.6%)
+#define HIST_HALF (1 << (HIST_SUB_BITS - 1))
+#define HIST_MAX_SHIFT 41                 // 2^48 ns (약 78시간) 까지 기록
+#define HIST_SLOTS ((HIST_MAX_SHIFT + 2) * HIST_HALF)
 
 // --- ZNS 관련 설정 ---
 #define INVALID_ZONE ULLONG_MAX
 #define MAX_ZONES 131072 // 최대 Zone 개수 가정 (예: 512GB / 4MB Zone), 필요시 조정
+#define ZONE_TABLE_INITIAL_CAPACITY 64 // 희소 Zone 테이블 초기 슬롯 수 (2의 거듭제곱)
+#define LSL_DEFAULT_GC_THRESHOLD 1     // 로그 구조 계층: 여유 Zone 이 이 값 이하가 되면 GC 수행
+
+// Zone 상태 (NVMe ZNS Zone State Machine)
+typedef enum {
+    ZONE_EMPTY = 0,
+    ZONE_IMPLICIT_OPEN,
+    ZONE_EXPLICIT_OPEN,
+    ZONE_CLOSED,
+    ZONE_FULL
+} ZoneCondition;
+
+// --- FIO 로그 writer 설정 ---
+#define FIO_LOG_BUF_SIZE (1 << 20)       // 로그 출력 버퍼 크기 (바이트)
+#define FIO_LOG_LINE_MAX 96              // 로그 한 줄의 최대 길이 (장치명 + 동작 + 숫자 2개)
+#define FIO_COALESCE_MAX_WINDOW 64       // 병합 대기열(재정렬 윈도우) 최대 길이
+#define FIO_COALESCE_DEFAULT_WINDOW 16   // --fio-coalesce 지정 시 기본 윈도우
 
 // --- 교체 정책 정의 ---
 typedef enum {
@@ -34,7 +152,12 @@ typedef enum {
     LFU = 5,                     // 2. T3(전체버퍼)을 LFU 캐시로 사용... -> 값 변경
     LFU_ARC = 6,                 // 4. T3/T4 기반 원래 ARC -> 값 변경
     LRU = 7,                     // 1. T1(전체버퍼)을 LRU 캐시로 사용... -> 값 변경
-    LRU_ARC = 8                  // 3. T1/T2 기반 원래 ARC -> 값 변경
+    LRU_ARC = 8,                 // 3. T1/T2 기반 원래 ARC -> 값 변경
+    SYNTHETIC = 9,               // label_encoder.json 의 합성 트레이스 클래스 (교체 정책 아님, P 9 는 무시됨)
+    CLOCK_PRO = 10,              // hot/cold/test 세 바늘과 적응형 cold 할당을 쓰는 CLOCK-Pro
+    S3_FIFO = 11,                // small/main/ghost FIFO 큐 (S3-FIFO)
+    SIEVE = 12,                  // 방문 비트 + 꼬리에서 머리로 가는 바늘 하나의 FIFO (SIEVE)
+    LIRS = 13                    // 재참조 거리(IRR)로 LIR/HIR 를 나누는 스택 S + 큐 Q (LIRS)
 } ReplacementPolicy;
 
 const char* policy_names[] = {
@@ -46,8 +169,19 @@ const char* policy_names[] = {
     "LFU",                     // Index 5
     "LFU_ARC",                 // Index 6
     "LRU",                     // Index 7
-    "LRU_ARC"                  // Index 8
+    "LRU_ARC",                 // Index 8
+    "SYNTHETIC",               // Index 9 (예약)
+    "CLOCK_PRO",               // Index 10
+    "S3_FIFO",                 // Index 11
+    "SIEVE",                   // Index 12
+    "LIRS"                     // Index 13
 };
+#define NUM_POLICIES ((int)(sizeof(policy_names) / sizeof(policy_names[0])))
+#define NUM_LABEL_POLICIES SYNTHETIC  // XGBoost 라벨 클래스에 있는 정책 (코드 0~8), 오라클 라벨은 이 정책들만 비교
+// 정책별 특수화 경로 생성용 목록 (새 정책은 enum, policy_names 와 함께 여기에도 추가)
+#define FOR_EACH_POLICY(X) \
+    X(CLOCK_PRO_T1_B4_LOGS_B2) X(CLOCK_PRO_T3_B2_LOGS_B4) X(CLOCK_T1) X(CLOCK_T3) X(FIFO) \
+    X(LFU) X(LFU_ARC) X(LRU) X(LRU_ARC) X(CLOCK_PRO) X(S3_FIFO) X(SIEVE) X(LIRS)
 
 // --- 버퍼 프레임 구조체 ---
 typedef struct {
@@ -55,21 +189,34 @@ typedef struct {
     unsigned long long load_time;       // 페이지 로드 시간 (FIFO, LFU tie-break)
     unsigned long long last_access_time;// 마지막 접근 시간 (LRU계열 정책용)
     unsigned int access_count;          // 접근 빈도 (LFU계열 정책용)
-    int list_type; // 현재 정책에 따른 실제 리스트 타입
-                   // LRU: 1 (T1_ref 개념) -> LRU는 이제 7, list_type 1은 여전히 T1 참조용으로 사용될 수 있음
-                   // LFU: 3 (T3_ref 개념) -> LFU는 이제 5, list_type 3은 여전히 T3 참조용으로 사용될 수 있음
-                   // LRU_ARC: 1(T1), 2(T2) -> LRU_ARC는 이제 8
-                   // LFU_ARC: 3(T3), 4(T4) -> LFU_ARC는 이제 6
-                   // CLOCK_T1, CLOCK_PRO_T1...: 1 (T1 캐시) -> CLOCK_T1은 2, CLOCK_PRO_T1...은 0
-                   // CLOCK_T3, CLOCK_PRO_T3...: 3 (T3 캐시) -> CLOCK_T3은 3, CLOCK_PRO_T3...은 1
     int is_dirty;  // Dirty flag (0: clean, 1: dirty)
     int ref_arc_list_type; // LRU/LFU 실행 중, 참조용 ARC 시뮬레이션에서의 리스트 타입
                            // LRU policy: 1 (T1_ref), 2 (T2_ref)
                            // LFU policy: 3 (T3_ref), 4 (T4_ref)
                            // 0 if not applicable or page is invalid
-    int ref_bit;           // CLOCK 알고리즘용 참조 비트 (0 또는 1)
+    int prefetched;        // 선반입(readahead)으로 적재된 뒤 아직 참조되지 않은 페이지
 } BufferFrame;
 
+// --- 프레임 hot 필드 (SoA) ---
+// CLOCK 스윕과 희생자 후보 필터가 읽는 필드만 BufferFrame 밖의 조밀한 배열로 분리한다.
+// 유효/참조/리스트별 비트맵은 64 프레임을 한 word 로 검사하고, 타임스탬프/카운터 같은 cold 필드는
+// 후보로 걸러진 프레임에서만 읽는다. 비트맵은 set_frame_page/set_frame_list/set_frame_ref 로만 갱신.
+#define FRAME_WORDS ((MAX_BUFFER_SIZE + 63) / 64)
+#define FRAME_LIST_TYPES 5            // list_type 값 0~4 (0: FIFO/미지정, 1~4: T1~T4)
+typedef struct {
+    unsigned long long valid[FRAME_WORDS];                  // page_id != INVALID_PAGE
+    unsigned long long ref[FRAME_WORDS];                    // CLOCK 참조 비트
+    unsigned long long list_bits[FRAME_LIST_TYPES][FRAME_WORDS]; // list_type 별 프레임 집합 (무효 프레임 비트가 남을 수 있으므로 valid 와 AND)
+    unsigned char list_type[MAX_BUFFER_SIZE]; // 현재 정책에 따른 실제 리스트 타입
+                   // LRU: 1 (T1_ref 개념) -> LRU는 이제 7, list_type 1은 여전히 T1 참조용으로 사용될 수 있음
+                   // LFU: 3 (T3_ref 개념) -> LFU는 이제 5, list_type 3은 여전히 T3 참조용으로 사용될 수 있음
+                   // LRU_ARC: 1(T1), 2(T2) -> LRU_ARC는 이제 8
+                   // LFU_ARC: 3(T3), 4(T4) -> LFU_ARC는 이제 6
+                   // CLOCK_T1, CLOCK_PRO_T1...: 1 (T1 캐시) -> CLOCK_T1은 2, CLOCK_PRO_T1...은 0
+                   // CLOCK_T3, CLOCK_PRO_T3...: 3 (T3 캐시) -> CLOCK_T3은 3, CLOCK_PRO_T3...은 1
+    int free_hint;                                          // 빈 프레임이 있을 수 있는 가장 낮은 word
+} FrameHot;
+
 // --- ARC 상태 구조체 ---
 typedef struct {
     // For T1/T2 (LRU_ARC) and T1 (LRU policy reference)
@@ -95,9 +242,614 @@ typedef struct {
     int q_clk_hand; // CLOCK_T3 또는 CLOCK_PRO_T3 계열 정책의 T3 파티션 핸드
 } ARCState;
 
+// --- CLOCK-Pro 상태 ---
+// 상주 페이지와 시험 기간(test period) 중인 비상주 cold 페이지 메타데이터를 하나의 원형 리스트에 두고
+// HANDhot(hot 강등), HANDcold(cold 교체), HANDtest(시험 기간 종료) 세 바늘이 같은 방향으로 돈다.
+// 노드 0..MAX_BUFFER_SIZE-1 은 같은 번호의 버퍼 프레임(참조 비트는 frame_hot.ref), 그 뒤는 비상주 노드.
+// 리스트 머리(새로 들어오거나 옮겨지는 자리)는 HANDhot 바로 뒤.
+#define CLOCKPRO_NODES (2 * MAX_BUFFER_SIZE + 1)   // 상주 m 개 + 비상주 최대 m+1 개
+#define CLOCKPRO_HOT  0x1
+#define CLOCKPRO_TEST 0x2
+#define CLOCKPRO_RESTRICT_PROBE 64 // --tenants: cold 바늘이 이만큼 지나도 제한 안의 희생자가 없으면 직접 고름
+typedef struct {
+    int next[CLOCKPRO_NODES];
+    int prev[CLOCKPRO_NODES];
+    unsigned char flags[CLOCKPRO_NODES];          // CLOCKPRO_HOT / CLOCKPRO_TEST
+    unsigned long long nonres_page[CLOCKPRO_NODES]; // 비상주 노드의 page_id
+    int free_nonres[MAX_BUFFER_SIZE + 1];         // 반환된 비상주 노드 스택
+    int free_count;
+    int nonres_used;                              // 한 번도 쓰이지 않은 비상주 노드의 시작 오프셋
+    int hand_hot, hand_cold, hand_test;           // -1 이면 리스트가 빔
+    int cold_target;                              // 상주 cold 페이지 목표 수 m_c (hot 한도는 m - m_c)
+    int hot_count, cold_count, nonres_count;
+    unsigned long long promotions, demotions, test_refaults, test_expired;
+} ClockProState;
+
+// --- FIFO 큐 정책 상태 (S3_FIFO, SIEVE) ---
+// 프레임 번호를 노드로 쓰는 이중 연결 큐. 머리(head)가 가장 최근 적재, next 는 꼬리 쪽 이웃.
+// 히트는 S3_FIFO 의 freq 또는 SIEVE 의 방문 비트(frame_hot.ref)만 바꾸고 큐를 건드리지 않는다.
+#define FIFOQ_SMALL 0                 // S3_FIFO 의 S (SIEVE 는 이 큐 하나만 사용)
+#define FIFOQ_MAIN  1                 // S3_FIFO 의 M
+#define S3FIFO_SMALL_PCT 10           // S 목표 크기 (버퍼의 %)
+#define S3FIFO_MAX_FREQ 3             // 2비트 포화 카운터
+#define S3FIFO_PROMOTE_FREQ 1         // S 꼬리에서 이 횟수 이상 히트한 페이지는 M 으로 (미만이면 G 로)
+typedef struct {
+    int next[MAX_BUFFER_SIZE];
+    int prev[MAX_BUFFER_SIZE];
+    unsigned char queue[MAX_BUFFER_SIZE];  // FIFOQ_SMALL / FIFOQ_MAIN
+    unsigned char freq[MAX_BUFFER_SIZE];   // S3_FIFO 접근 빈도 (0..S3FIFO_MAX_FREQ)
+    int head[2], tail[2], size[2];         // -1 이면 빈 큐
+    int sieve_hand;                        // SIEVE 바늘 (-1 이면 다음 교체는 꼬리부터)
+    unsigned long long ghost[MAX_BUFFER_SIZE]; // S3_FIFO 의 G: page_id 링 (INVALID_PAGE 는 이미 재적재된 항목)
+    int ghost_pos, ghost_count;
+    unsigned long long small_to_main, main_reinserts, ghost_hits, sieve_passes;
+} FifoQueueState;
+
+// --- LIRS 상태 ---
+// 스택 S 에는 LIR 페이지와 S 안에서 참조된 상주/비상주 HIR 페이지가 최근 참조 순으로 있고 바닥은 항상 LIR 이다.
+// 큐 Q 는 상주 HIR 페이지 (머리가 다음 교체 대상). 노드 번호는 CLOCK-Pro 와 같이 0..MAX_BUFFER_SIZE-1 이
+// 버퍼 프레임, 그 뒤가 비상주 HIR 노드이며 비상주 노드는 생성 순서 리스트로 lirs.nonres_limit 개까지만 둔다.
+#define LIRS_HIR_PCT 1                // 상주 HIR 목표 (버퍼의 %, 최소 1 프레임)
+#define LIRS_NONRES_PCT 300           // 비상주 HIR 상한 (버퍼의 %)
+#define LIRS_NONRES_MAX (MAX_BUFFER_SIZE * (LIRS_NONRES_PCT / 100) + 1)
+#define LIRS_NODES (MAX_BUFFER_SIZE + LIRS_NONRES_MAX)
+#define LIRS_LIR  0x1
+#define LIRS_IN_S 0x2
+typedef struct {
+    int s_next[LIRS_NODES];                    // 스택 S: next 는 바닥 쪽, -1 이면 끝
+    int s_prev[LIRS_NODES];
+    unsigned char flags[LIRS_NODES];           // LIRS_LIR / LIRS_IN_S
+    int q_next[MAX_BUFFER_SIZE];               // 큐 Q: next 는 꼬리(최근) 쪽
+    int q_prev[MAX_BUFFER_SIZE];
+    unsigned long long nonres_page[LIRS_NONRES_MAX]; // 비상주 노드 (node - MAX_BUFFER_SIZE) 의 page_id
+    int n_next[LIRS_NONRES_MAX];               // 비상주 노드 생성 순서 (상한을 넘으면 가장 오래된 것부터 정리)
+    int n_prev[LIRS_NONRES_MAX];
+    int free_nonres[LIRS_NONRES_MAX];
+    int free_count, nonres_used;
+    int s_top, s_bottom, q_head, q_tail, n_head, n_tail;
+    int lir_target, nonres_limit;
+    int lir_count, hir_count, nonres_count;
+    unsigned long long promotions, demotions, nonres_refaults, nonres_expired, pruned;
+} LirsState;
+
+// --- TinyLFU 승인 필터 (모든 정책 앞단) ---
+// 접근마다 doorkeeper bloom 필터를 먼저 거치고, 이미 본 페이지만 count-min sketch 에 센다.
+// 기록이 sample_size 에 이르면 카운터를 절반으로 줄이고 doorkeeper 를 비운다 (노화).
+// 버퍼가 가득 찬 미스에서 정책이 고른 희생자보다 추정 빈도가 높지 않은 후보는 적재하지 않는다.
+#define TINYLFU_ROWS 4
+#define TINYLFU_MAX_COUNT 15          // 4비트 포화 카운터 (바이트 하나에 하나)
+#define TINYLFU_MIN_WIDTH 64
+#define TINYLFU_DEFAULT_SAMPLE_FACTOR 10
+#define TINYLFU_MAX_SAMPLE_FACTOR 1000
+typedef struct {
+    int enabled;
+    int sample_factor;                // 노화 주기 = sample_factor x 버퍼 크기 기록
+    unsigned char *sketch;            // TINYLFU_ROWS 행 x (width_mask + 1) 카운터
+    unsigned long long width_mask;
+    unsigned long long *door;         // doorkeeper 비트맵
+    unsigned long long door_mask;     // 비트 수 - 1
+    unsigned long long additions, sample_size;
+    unsigned char kept[MAX_BUFFER_SIZE]; // 1: 승인 거절로 교체를 면한 뒤 아직 히트가 없는 프레임
+    // 통계
+    unsigned long long admits, rejects, agings;
+    unsigned long long saved_reads;   // kept 프레임의 첫 히트 (거절하지 않았다면 다시 읽었을 페이지)
+    unsigned long long kept_dirty;    // 거절로 미뤄진 더티 희생자 write-back
+    unsigned long long write_arounds; // 거절된 쓰기 미스를 버퍼를 거치지 않고 장치에 쓴 횟수
+} TinyLfu;
+
+// --- 테넌트 분할 (utility-based cache partitioning) ---
+// Qureshi, Patt. "Utility-Based Cache Partitioning" (MICRO 2006)
+// 페이지 구간 -> 테넌트 맵으로 접근을 나누고, 테넌트마다 페이지 해시로 1/2^UCP_SAMPLE_SHIFT 만 샘플링한
+// LRU 스택(UMON)으로 할당 크기별 히트 수(miss-ratio curve)를 모은다. interval 접근마다 lookahead 탐욕 알고리즘으로
+// 전체 히트가 최대가 되게 버퍼를 bucket_count 조각 단위로 다시 나누고 카운터를 절반으로 줄인다.
+// 버퍼가 가득 찬 미스는 요청 테넌트가 할당량 이상이면 자기 프레임에서, 아니면 할당량을 가장 많이 넘은 테넌트에서 교체.
+#define UCP_MAX_TENANTS 16
+#define UCP_BUCKETS 64                // 할당 단위 수 (버퍼가 이보다 작으면 프레임 단위)
+#define UCP_SAMPLE_SHIFT 5            // UMON 샘플링 1/32
+#define UCP_DEFAULT_INTERVAL 50000    // 재할당 주기 (접근 수)
+typedef struct {
+    unsigned long long first, last;   // 페이지 구간 (양 끝 포함)
+    int tenant;
+} TenantRange;
+
+typedef struct {
+    int enabled;
+    int num_tenants;                  // 맵의 가장 큰 테넌트 번호 + 1 (맵에 없는 페이지는 테넌트 0)
+    TenantRange *ranges;              // first 오름차순, 겹치지 않음
+    int num_ranges;
+    unsigned long long interval, accesses;
+    int bucket_count;
+    int stack_cap;                    // 테넌트별 UMON 스택 길이
+    unsigned long long *stacks;       // [num_tenants][stack_cap], 앞이 MRU
+    int stack_len[UCP_MAX_TENANTS];
+    unsigned long long way_hits[UCP_MAX_TENANTS][UCP_BUCKETS]; // 스택 거리 구간별 샘플 히트
+    int buckets[UCP_MAX_TENANTS];
+    int quota[UCP_MAX_TENANTS];       // 프레임 수 (합이 buffer_size)
+    int occupancy[UCP_MAX_TENANTS];
+    const unsigned long long *victim_bits; // 희생자 선택 중에만 설정: frame_candidates 를 이 테넌트 프레임으로 제한
+    int victim_tenant;                // victim_bits 의 테넌트 (victim_bits 가 NULL 이 아닐 때만 의미)
+    unsigned char frame_tenant[MAX_BUFFER_SIZE];
+    unsigned long long tenant_bits[UCP_MAX_TENANTS][FRAME_WORDS];
+    // 통계
+    unsigned long long hits[UCP_MAX_TENANTS], misses[UCP_MAX_TENANTS];
+    unsigned long long evicted[UCP_MAX_TENANTS];  // 이 테넌트 프레임이 교체된 횟수
+    unsigned long long stolen[UCP_MAX_TENANTS];   // 그중 다른 테넌트의 미스 때문에 교체된 횟수
+    unsigned long long reallocations;
+} Ucp;
+
+// --tenants 에서 큐 기반 정책(S3_FIFO, SIEVE, LIRS)이 쓰는 테넌트별 부분 리스트. 정책 큐에는 머리/꼬리 삽입과
+// 임의 삭제만 있으므로 같은 연산을 그 프레임 테넌트의 리스트에도 하면 테넌트 안의 순서가 정책 큐와 같다.
+// 프레임 하나는 한 번에 한 리스트(list 0 또는 1)에만 있다
+typedef struct {
+    int next[MAX_BUFFER_SIZE], prev[MAX_BUFFER_SIZE];
+    int head[2][UCP_MAX_TENANTS], tail[2][UCP_MAX_TENANTS], size[2][UCP_MAX_TENANTS];
+    int hand[UCP_MAX_TENANTS];        // SIEVE 테넌트별 바늘 (-1 이면 꼬리부터)
+} TenantChain;
+
+// --- ZNS Zone 구조체 ---
+// 한 번이라도 접근된 Zone만 희소 해시 테이블에 저장됨. 테이블에 없는 Zone은 EMPTY.
+typedef struct {
+    unsigned long long zone_id;       // INVALID_ZONE 이면 빈 슬롯
+    unsigned long long write_pointer; // 다음 순차 쓰기 위치 (페이지 ID)
+    unsigned long long last_write_seq;// 마지막 쓰기 순번 (암시적 close / finish 대상 선택용)
+    ZoneCondition state;
+    int open_pos;                     // open_zone_ids 내 위치 (-1: open 아님)
+    int active_pos;                   // active_zone_ids 내 위치 (-1: active 아님)
+} ZoneEntry;
+
+typedef struct {
+    ZoneEntry *slots;
+    unsigned long long capacity;      // 2의 거듭제곱
+    unsigned long long used;
+    // open(IMPLICIT/EXPLICIT) 및 active(open + CLOSED) Zone 목록
+    unsigned long long *open_zone_ids;
+    int open_count, open_capacity;
+    unsigned long long *active_zone_ids;
+    int active_count, active_capacity;
+    int max_open;                     // 0 이면 제한 없음
+    int max_active;                   // 0 이면 제한 없음
+    unsigned long long write_seq;
+    FILE *event_file;                 // reset/finish/open/close 기록 (선택)
+    // 통계
+    unsigned long long violations;
+    unsigned long long implicit_opens, explicit_opens;
+    unsigned long long implicit_closes, explicit_closes;
+    unsigned long long finishes, resets;
+    int peak_open, peak_active;
+} ZoneTable;
+
+// --- 백그라운드 flusher 모델 ---
+// 더티 프레임 수가 high_mark 에 도달하면 low_mark 이하가 될 때까지 batch_size 단위로 write-back.
+typedef enum {
+    FLUSH_ORDER_LBA = 0,  // LBA 오름차순, 직전 batch 다음 위치부터 이어서 (엘리베이터)
+    FLUSH_ORDER_ZONE      // 더티 페이지가 가장 많은 Zone 부터, Zone 내부는 LBA 오름차순
+} FlushOrder;
+
+typedef struct {
+    int enabled;
+    int high_mark;                // 더티 프레임 수 (버퍼 크기 대비 비율에서 계산)
+    int low_mark;
+    int batch_size;
+    FlushOrder order;
+    unsigned long long lba_cursor;
+    int *scratch;                 // 더티 프레임 인덱스 정렬 버퍼
+    unsigned long long runs;      // high_mark 도달로 깨어난 횟수
+    unsigned long long batches;   // 기록한 batch 수
+    unsigned long long pages;     // flush 한 페이지 수
+} Flusher;
+
+// --- ZNS 비용 인지 희생자 선택 ---
+// 정책 순서상 앞선 (window + 1)개 후보를 "순위 + write-back 비용" 으로 비교한다.
+// 비용은 clean 0, Zone 쓰기 포인터에 맞는 순차 write-back 1, 그 밖의 더티 페이지 penalty.
+typedef struct {
+    int window;                       // 0 이면 비활성 (최대 FLUSH_MAX_CLEAN_WINDOW)
+    int penalty;
+    unsigned long long picks;         // 정책의 첫 후보 대신 다른 후보를 고른 횟수
+    unsigned long long picked_clean;  // 그중 clean 후보
+    unsigned long long picked_seq;    // 그중 순차 write-back 더티 후보
+} ZnsCost;
+
+// --- 선반입(readahead) 엔진 ---
+// 영역별로 순차/stride 스트림을 감지해 다음 페이지들을 미리 적재한다.
+// 참조되지 않은 선반입 페이지는 별도의 prefetch list(FIFO)로 추적하며,
+// 상한을 넘으면 가장 오래된 것부터 버린다 (낭비된 선반입).
+typedef struct {
+    int valid;
+    unsigned long long last_page;
+    long long stride;                   // 0 이면 아직 stride 미확정
+    int confidence;                     // stride 가 연속으로 맞은 횟수
+    int window;                         // 스트림별 선반입 윈도우 (페이지 수)
+    unsigned long long prefetched_upto; // 이미 선반입을 요청한 마지막 페이지
+    unsigned long long last_use;        // 스트림 슬롯 LRU 교체용
+} ReadaheadStream;
+
+typedef struct {
+    int enabled;
+    int min_window, max_window;
+    int cur_max_window;                 // 적중/낭비에 따라 AIMD 로 조정되는 윈도우 상한
+    int region_pages;
+    int num_streams;
+    ReadaheadStream streams[RA_MAX_STREAMS];
+    unsigned long long use_clock;
+    // prefetch list: 참조되지 않은 선반입 프레임 (원형 큐, 항목은 page_id 로 유효성 확인)
+    int *list_frames;
+    unsigned long long *list_pages;
+    int list_head, list_count, list_capacity;
+    int unused_count;                   // 실제로 아직 참조되지 않은 선반입 페이지 수
+    int max_unused;                     // unused_count 상한
+    // 통계
+    unsigned long long triggers;        // 선반입 발생 횟수
+    unsigned long long pages;           // 선반입한 페이지 수
+    unsigned long long ios;             // 선반입 읽기 I/O 수 (연속 구간 단위)
+    unsigned long long hits;            // 선반입 페이지가 참조된 횟수
+    unsigned long long wasted;          // 참조되지 않고 버려진 선반입 페이지 수
+    unsigned long long dirty_evictions; // 선반입 적재가 밀어낸 더티 희생자 수 (요청 경로 stall 이 아님)
+} Readahead;
+
+// --- 지연 히스토그램 (HDR 방식 로그-선형 구간, ns 단위) ---
+typedef struct {
+    unsigned long long counts[HIST_SLOTS];
+    unsigned long long count;
+    unsigned long long sum_ns;
+    unsigned long long max_ns;
+} LatencyHistogram;
+
+// --- 장치 지연/큐잉 모델 ---
+// 모든 장치 I/O 는 채널 중 가장 먼저 비는 곳에서 서비스되고, 장치에 동시에 걸린 I/O 는 queue_depth 로 제한된다.
+// 요청 처리 중 발생한 동기 I/O(미스 읽기, 교체 시 write-back)는 차례로 요청의 완료 시각을 늦추고,
+// flusher/선반입 I/O 는 요청을 기다리게 하지 않지만 채널과 큐를 점유한다.
+typedef struct {
+    const char *name;
+    unsigned long long read_ns, write_ns, reset_ns; // 4KB 페이지 하나의 서비스 시간, Zone reset 시간
+    unsigned long long xfer_ns;                     // 다중 페이지 I/O 에서 추가 페이지당 전송 시간
+    int channels;
+    int queue_depth;
+} DevicePreset;
+
+typedef struct {
+    int enabled;
+    DevicePreset cfg;
+    unsigned long long hit_ns;
+    unsigned long long channel_free_ns[DEV_MAX_CHANNELS];
+    unsigned long long *inflight;       // 진행 중 I/O 의 완료 시각 (min-heap)
+    int inflight_count;
+    unsigned long long now_ns;          // 호스트 시계 (closed-loop: 직전 요청 완료 시각)
+    int in_request;
+    int async_depth;                    // 0 보다 크면 요청 경로 밖의 I/O (flusher, 선반입)
+    unsigned long long req_arrival_ns, req_done_ns;
+    // 통계
+    unsigned long long ios[3];          // OP_READ / OP_WRITE / OP_TRIM
+    unsigned long long queue_wait_ns;   // 큐 깊이/채널 대기 시간 합
+    unsigned long long busy_ns;         // 채널 서비스 시간 합
+    LatencyHistogram policy_hist[NUM_POLICIES];
+    unsigned long long policy_elapsed_ns[NUM_POLICIES];
+    LatencyHistogram epoch_hist;        // 현재 정책 구간(epoch)
+    int epoch_index, epoch_start_line;
+    unsigned long long epoch_start_ns;
+    // open-loop 재생
+    int open_loop;
+    int speed_pct;                      // 도착 간격 배속 (100 = 트레이스 그대로, 200 = 두 배 빠르게)
+    int time_origin_set;
+    unsigned long long time_origin_ns;  // 첫 타임스탬프 (시뮬레이션 시각 0)
+    unsigned long long last_done_ns;    // 지금까지 완료된 요청 중 가장 늦은 완료 시각
+    long long req_hits_start, req_misses_start;
+} DeviceModel;
+
+// --- 구간별 지표 출력 ---
+typedef struct {
+    long long hits, misses;
+    unsigned long long evictions, dirty_evictions;
+    unsigned long long ghost_hits[5];
+    unsigned long long zns_violations;
+} MetricsCounters;
+
+typedef struct {
+    int enabled;
+    FILE *fp;
+    int json;                           // 0: CSV, 1: JSON Lines
+    unsigned long long every;           // N 요청마다 interval 행 (0 이면 epoch 행만)
+    MetricsCounters interval_base, epoch_base;
+    unsigned long long interval_start_req, epoch_start_req;
+    int interval_start_line;
+    int epoch_index, epoch_start_line;
+    unsigned long long rows;
+} MetricsWriter;
+
+// --- 트레이스 읽기 ---
+// 텍스트: [@<시각_us>] <LBA> <r|w> [길이_섹터] 또는 [@<시각_us>] P <정책코드>
+// 바이너리: TRACE_BINARY_MAGIC, 버전(u32), 레코드 크기(u32) 헤더 뒤에 BinaryTraceRecord 가 이어짐 (호스트 바이트 순서)
+typedef struct {
+    unsigned long long time_ns;     // flags & TRACE_FLAG_HAS_TIME 일 때만 유효
+    unsigned long long lba;         // 정책 변경 레코드면 정책 코드
+    unsigned int len_sectors;       // 0 이면 단일 페이지 요청
+    unsigned char op;               // 'R', 'W', 'P'
+    unsigned char flags;
+    unsigned short reserved;
+} BinaryTraceRecord;
+
+typedef enum { TRACE_REQUEST, TRACE_POLICY } TraceRecordKind;
+
+typedef struct {
+    TraceRecordKind kind;
+    int policy_code;
+    unsigned long long lba;
+    int operation_type;
+    unsigned long long len_sectors;     // 0 이면 단일 페이지 요청
+    int has_time;
+    unsigned long long time_ns;
+} TraceRecord;
+
+typedef struct {
+    FILE *fp;
+    int binary;
+    int line_num;                       // 텍스트는 줄 번호, 바이너리는 레코드 번호
+} TraceReader;
+
+// --- 합성 트레이스 생성기 ---
+typedef enum { GEN_ZIPF, GEN_UNIFORM, GEN_SCAN, GEN_LOOP, GEN_ZONE } GenPattern;
+
+typedef struct {
+    GenPattern pattern;
+    unsigned long long requests;
+    unsigned long long base_page, pages;    // 구간이 접근하는 페이지 영역 [base, base+pages)
+    double theta;                           // zipf 편중도 (0 이면 균등)
+    int scramble;                           // zipf 순위를 영역 전체에 흩뿌림
+    unsigned long long run_pages;           // scan 한 번의 길이
+    int write_pct;
+    unsigned int len_pages;                 // 요청당 페이지 수
+    int streams;                            // zone: 동시 순차 쓰기 스트림 수
+    int policy_code;                        // 구간 시작 시 P 라인 (-1 이면 없음)
+    double iat_us;                          // 평균 도착 간격 (지수 분포, 0 이면 타임스탬프 없음)
+} GenPhase;
+
+typedef struct {
+    float prob;                             // 이 칸을 그대로 쓸 확률
+    unsigned int alias;                     // 아니면 이 순위
+} GenAliasEntry;
+
+typedef struct {
+    unsigned long long rng;
+    unsigned long long time_ns;
+    GenAliasEntry *alias;                   // zipf 순위 샘플링용 alias 테이블
+    unsigned long long alias_size;          // 0 이면 테이블 없음
+    double alias_theta;                     // 테이블을 만든 theta
+    unsigned int zipf_ahead[GEN_ZIPF_AHEAD]; // 미리 뽑아 prefetch 해 둔 alias 칸
+    int zipf_ahead_pos;
+    unsigned long long cursor, run_left;    // scan/loop 위치
+    unsigned long long *stream_pos;         // zone 스트림별 다음 쓰기 페이지 (영역 내 오프셋, ULLONG_MAX: 새 Zone 없음)
+    unsigned long long zone_next;           // zone: 아직 쓰지 않은 다음 Zone (영역 내 번호)
+    char *out;
+    size_t out_len;
+    unsigned long long records, bytes;
+} TraceGenerator;
+
+// --- 오라클 라벨 생성 (창마다 모든 정책을 같은 예열 상태에서 재생) ---
+typedef struct {
+    int window;
+    int policy;
+    long long hits, misses;
+} LabelResult;                              // 자식 -> 부모 파이프 메시지 (PIPE_BUF 이하라 원자적으로 기록됨)
+
+typedef struct {
+    int first_line, last_line;
+    unsigned long long requests;
+    TraceFeatures features;
+    int start_policy;                       // 창 시작 시 부모 궤적의 정책 (스냅샷 상태)
+    int results;                            // 도착한 정책 결과 수
+    long long hits[NUM_POLICIES];
+} LabelWindow;
+
+typedef struct {
+    FILE *out;
+    unsigned long long window_requests;
+    int jobs, running;
+    int follow;                             // -1: 창마다 최고 정책으로 궤적을 이어감, 아니면 고정 정책
+    int pipe_rd, pipe_wr;
+    LabelWindow *windows;
+    int num_windows, capacity, next_row;
+    unsigned long long label_counts[NUM_POLICIES];
+} LabelRunner;
+
+// --- 체크포인트 / what-if ---
+// 파일: CKPT_MAGIC, 버전(u32), 섹션 수(u32) 뒤에 섹션 {id(u32), 예약(u32), 크기(u64), 내용, 8바이트 정렬 패딩}
+// 구조체 섹션은 그대로 기록하므로 같은 빌드(같은 구조체 배치)에서만 복원 가능 (크기로 검사)
+typedef enum {
+    CKPT_CORE = 1, CKPT_FRAMES, CKPT_FRAME_HOT, CKPT_ARC, CKPT_GHOST_B1, CKPT_GHOST_B2, CKPT_GHOST_B3, CKPT_GHOST_B4,
+    CKPT_ZONES, CKPT_ZONE_SLOTS, CKPT_ZONE_OPEN, CKPT_ZONE_ACTIVE,
+    CKPT_FLUSHER, CKPT_READAHEAD, CKPT_RA_FRAMES, CKPT_RA_PAGES,
+    CKPT_LSL, CKPT_LSL_L2P_KEYS, CKPT_LSL_L2P_VALUES, CKPT_LSL_P2L_KEYS, CKPT_LSL_P2L_VALUES,
+    CKPT_LSL_VALID, CKPT_LSL_HOME, CKPT_LSL_FREE, CKPT_LSL_GC_HEAP, CKPT_LSL_GC_POS,
+    CKPT_DEVICE, CKPT_DEV_INFLIGHT, CKPT_CLOCKPRO, CKPT_FIFOQ, CKPT_LIRS, CKPT_TINYLFU, CKPT_TLFU_SKETCH, CKPT_TLFU_DOOR,
+    CKPT_UCP, CKPT_UCP_STACKS, CKPT_UCP_CHAIN,
+    CKPT_SECTIONS
+} CheckpointSection;
+
+typedef struct {
+    int buffer_size;
+    int current_policy, previous_policy;
+    int global_clk_hand;
+    int dirty_pages;
+    int trace_binary, trace_line_num;
+    int zones_enabled, lsl_enabled, flusher_enabled, readahead_enabled, device_enabled, tinylfu_enabled, ucp_enabled;
+    unsigned long long zone_size_pages;
+    unsigned long long current_time;
+    long long hits, misses;
+    unsigned long long dirty_eviction_stalls, clean_victim_picks, evictions;
+    unsigned long long zns_cost_picks, zns_cost_picked_clean, zns_cost_picked_seq;
+    unsigned long long evict_seq_writebacks, evict_nonseq_writebacks;
+    unsigned long long ghost_hits[5];
+    unsigned long long trace_offset;        // 다음 레코드의 트레이스 파일 위치
+    unsigned long long trace_size;          // 저장 시점의 트레이스 파일 크기 (복원 시 확인용)
+    unsigned long long requests, range_pages; // 처리한 요청 수 / 접근 페이지 수
+} CheckpointCore;
+
+typedef struct {
+    int p, t1_size, t2_size, b1_size, b2_size;
+    int q, t3_size, t4_size, b3_size, b4_size;
+    int p_clk_hand, q_clk_hand;
+} CheckpointArc;
+
+typedef struct {
+    void *map;
+    size_t map_len;
+    const unsigned char *data[CKPT_SECTIONS];
+    unsigned long long size[CKPT_SECTIONS];
+} CheckpointFile;
+
+typedef struct {
+    int policy;
+    unsigned long long requests;            // 분기 이후 처리한 요청 수
+    long long hits, misses;                 // 분기 이후
+    long long total_hits, total_misses;     // 트레이스 처음부터
+    unsigned long long evictions, dirty_evictions, zns_violations;
+} WhatIfResult;
+
+// 파서 -> 샤드 큐 원소 (범위 요청은 청크 경계에서 잘라 각 샤드로 보냄)
+typedef struct {
+    unsigned long long seq;                 // 트레이스 레코드 순번 (FIO 로그 병합 순서)
+    int line_num;
+    TraceRecord rec;
+} ShardMessage;
+
+// 샤드 FIO 로그 색인: 순번 seq 레코드를 처리하는 동안 lines 줄이 기록됨
+typedef struct {
+    unsigned long long seq;
+    unsigned long long lines;
+} ShardLogMark;
+
+typedef struct {
+    int shard, frames;
+    unsigned long long requests, pages;     // 받은 요청(청크 단위 조각) 수, 접근 페이지 수
+    long long hits, misses;
+    unsigned long long evictions, dirty_eviction_stalls, clean_victim_picks, ghost_hits[5];
+    unsigned long long zns_cost_picks, zns_cost_picked_clean, zns_cost_picked_seq, evict_seq_writebacks, evict_nonseq_writebacks;
+    unsigned long long ios_submitted, ios_written, dirty_flushed;
+    unsigned long long zone_used, zone_violations, zone_implicit_opens, zone_explicit_opens;
+    unsigned long long zone_implicit_closes, zone_explicit_closes, zone_finishes, zone_resets;
+    int zone_peak_open, zone_peak_active;
+    unsigned long long flusher_runs, flusher_batches, flusher_pages;
+    unsigned long long tlfu_admits, tlfu_rejects, tlfu_agings, tlfu_saved_reads, tlfu_kept_dirty, tlfu_write_arounds;
+} ShardResult;
+
+typedef struct {
+    int count;                              // 0 이면 비활성
+    unsigned long long chunk_pages;         // 같은 샤드로 가는 연속 페이지 수 (ZNS 활성 시 Zone 크기)
+    int dirty_flushed;                      // 샤드들이 종료 시 플러시한 더티 페이지 합
+    ShardResult results[SHARD_MAX];
+} ShardRunner;
+
+// --- 초 단위 시계열 ---
+typedef struct {
+    unsigned long long arrivals, completions;
+    unsigned long long hits, misses;    // 도착한 초 기준 페이지 히트/미스
+    unsigned long long latency_sum_ns;  // 완료된 초 기준
+    int dirty_pages;                    // 그 초에 마지막으로 도착한 요청 시점의 더티 프레임 수
+} TimeSeriesBucket;
+
+typedef struct {
+    int enabled;
+    TimeSeriesBucket *buckets;
+    unsigned long long count, capacity;
+} TimeSeries;
+
+// --- 64비트 키/값 해시 맵 (open addressing, 선형 탐사) ---
+typedef struct {
+    unsigned long long *keys;   // INVALID_PAGE 이면 빈 슬롯
+    unsigned long long *values;
+    unsigned long long capacity; // 2의 거듭제곱
+    unsigned long long count;
+} U64Map;
+
+// lock-free CLOCK 프레임: 히트 경로는 ref_bit 만 atomic 으로 세우고, 교체는 busy 를 CAS 로 잡은 스레드만 수행
+typedef struct {
+    _Atomic unsigned long long page_id;
+    atomic_uchar ref_bit;
+    atomic_uchar busy;
+} ConcFrame;
+
+// 페이지 색인 stripe (stripe 별 mutex + U64Map, 캐시 라인 공유를 피하도록 정렬)
+typedef struct {
+    pthread_mutex_t lock;
+    U64Map map;
+} __attribute__((aligned(64))) ConcStripe;
+
+typedef struct {
+    pthread_t tid;
+    long long hits, misses;
+    unsigned long long evictions, retries;   // retries: 희생자 stripe 잠금 실패로 다음 프레임을 본 횟수
+} __attribute__((aligned(64))) ConcWorker;
+
+typedef struct {
+    const TraceRecord *recs;
+    unsigned long long count;
+    atomic_ullong next;                      // 다음에 가져갈 요청 위치
+    int lock_free;                           // 1: lock-free CLOCK, 0: 전역 mutex 아래 기존 정책 경로
+    pthread_mutex_t big_lock;
+    ConcFrame *frames;
+    int frame_count;
+    ConcStripe *stripes;
+    atomic_ullong hand;
+} ConcurrentPool;
+
+// --- 로그 구조 쓰기 계층 (ZNS) ---
+// 더티 페이지 write-back 을 활성 Zone의 쓰기 포인터에 덧붙이고 LBA->물리 페이지 매핑을 유지.
+// 매핑에 없는 페이지는 원래 위치(홈 LBA)에 있다고 간주한다.
+typedef struct {
+    int enabled;
+    unsigned long long logical_zones;   // 홈 LBA 공간의 Zone 수 (0 .. logical_zones-1)
+    unsigned long long total_zones;     // logical_zones + 예비(over-provisioning) Zone 수
+    unsigned long long gc_threshold;    // 여유 Zone 수가 이 값 이하이면 GC (복사용 Zone 확보)
+    U64Map lba_to_phys;                 // 재배치된 페이지: LBA 페이지 -> 물리 페이지
+    U64Map phys_to_lba;                 // 로그에 기록된 유효 페이지: 물리 페이지 -> LBA 페이지
+    unsigned int *valid_pages;          // Zone 별 유효 페이지 수
+    unsigned char *home_intact;         // 1: 아직 reset 되지 않아 홈 데이터가 남은 논리 Zone
+    unsigned long long *free_zones;     // 여유 Zone FIFO (원형 큐)
+    unsigned long long free_head, free_count;
+    unsigned long long *gc_heap;        // GC 후보 Zone 최소 힙 (유효 페이지 수, Zone 번호 순): 홈 데이터 Zone + 다 쓴 로그 Zone
+    unsigned long long *gc_pos;         // Zone 의 힙 위치 (INVALID_ZONE: 후보 아님)
+    unsigned long long gc_heap_size;
+    unsigned long long active_zone;     // 현재 덧붙이기 대상 Zone (INVALID_ZONE: 없음)
+    int in_gc;
+    int out_of_range_warned;
+    // 통계 (정책별)
+    unsigned long long host_writes[NUM_POLICIES];  // 캐시에서 내려온 write-back 페이지 수
+    unsigned long long gc_copies[NUM_POLICIES];    // GC 유효 페이지 복사 수
+    unsigned long long gc_runs[NUM_POLICIES];
+    unsigned long long redirected_reads;
+    unsigned long long out_of_range_writes;        // 논리 Zone 범위 밖이라 로그를 거치지 않고 제자리에 쓴 페이지 수 (WA 에서 제외)
+} LogStructuredLayer;
+
+// --- FIO 로그 writer 구조체 ---
+typedef struct {
+    unsigned long long offset_bytes;
+    unsigned long long length_bytes;
+    int operation_type;
+} FioPendingIO;
+
+typedef struct {
+    FILE *fp;
+    char *buf;                 // 직접 포맷한 로그 라인을 모아두는 버퍼
+    size_t len;
+    // 병합(coalescing) 단계: 인접한 같은 방향 I/O를 max_io_bytes 까지 합침
+    int window;                // 대기열 길이 (0이면 병합 비활성, 즉시 기록)
+    unsigned long long max_io_bytes;
+    FioPendingIO pending[FIO_COALESCE_MAX_WINDOW]; // [0]이 가장 오래된 요청
+    int pending_count;
+    unsigned long long ios_submitted; // 시뮬레이터가 요청한 I/O 수
+    unsigned long long ios_written;   // 실제 로그에 기록된 I/O 수 (병합 후)
+} FioLogWriter;
+
+// 정책별로 특수화된 미스/히트 경로 (정책 epoch 마다 한 번 선택)
+typedef struct {
+    int (*load)(unsigned long long page_id, int operation_type, int is_prefetch);
+    void (*hit)(int frame_idx, int operation_type);
+} PolicyPath;
+
 // --- 전역 변수 및 상태 ---
 BufferFrame buffer[MAX_BUFFER_SIZE];
+FrameHot frame_hot;           // buffer[] 의 hot 필드 (유효/참조 비트맵, list_type)
 int buffer_size = 0;
+U64Map page_index = {0};      // page_id -> 버퍼 프레임 인덱스 (find_in_buffer 용)
 ReplacementPolicy current_policy;
 ReplacementPolicy previous_policy_for_state_carryover; // 정책 변경 시 상태 이전 결정용
 unsigned long long current_time = 0;
@@ -105,9 +857,47 @@ long long hits = 0;
 long long misses = 0;
 ARCState arc_state; // LRU/LFU일때도 참조용으로 사용됨, CLOCK_PRO 계열에서도 사용
 FILE *log_file = NULL;
+FioLogWriter fio_log = {0}; // log_file 앞단의 버퍼링/병합 writer
+const PolicyPath *policy_path = NULL; // current_policy 의 특수화 경로 (select_policy_path)
 int global_clk_hand = 0; // 단순 CLOCK_T1, CLOCK_T3 정책용 (ARCState 핸드와 구분될 때)
+ClockProState clockpro;  // CLOCK_PRO 정책 상태 (다른 정책에서 전환될 때 clockpro_rebuild 로 다시 구성)
+U64Map clockpro_nonres = {0}; // 비상주 cold 페이지 page_id -> CLOCK-Pro 노드
+FifoQueueState fifoq;         // S3_FIFO / SIEVE 정책 상태 (전환 시 fifoq_rebuild)
+U64Map fifoq_ghost_index = {0}; // S3_FIFO G 의 page_id -> 링 위치
+LirsState lirs;               // LIRS 정책 상태 (전환 시 lirs_rebuild)
+U64Map lirs_nonres = {0};     // 비상주 HIR page_id -> LIRS 노드
+TinyLfu tinylfu = {0};        // 선택적 TinyLFU 승인 필터 (--tinylfu)
+Ucp ucp = {0};                // 선택적 테넌트 분할 (--tenants)
+TenantChain fifoq_chain;      // --tenants: S3_FIFO 의 S/M, SIEVE 큐의 테넌트별 부분 리스트
+TenantChain lirs_chain;       // --tenants: LIRS 의 Q (list 0) 와 S 안의 LIR 순서 (list 1)
 unsigned long long zone_size_pages_global = 0; // 전역 존 크기 (페이지 단위)
-unsigned long long zone_write_pointers[MAX_ZONES]; // 각 Zone의 현재 쓰기 포인터 (페이지 ID)
+ZoneTable zone_table = {0}; // 희소 Zone 상태 테이블 (접근된 Zone만 저장)
+LogStructuredLayer lsl = {0}; // 선택적 로그 구조 쓰기 계층
+Flusher flusher = {0};        // 선택적 백그라운드 flusher
+Readahead readahead = {0};    // 선택적 선반입 엔진
+DeviceModel device = {0};     // 선택적 장치 지연/큐잉 모델
+TimeSeries timeseries = {0};  // 선택적 초 단위 시계열
+MetricsWriter metrics = {0};  // 선택적 구간별 지표 출력
+LabelRunner label = {0};      // --label 오라클 라벨 생성 상태
+ShardRunner shard = {0};      // --shards 해시 샤드 시뮬레이션 상태
+ConcurrentPool conc = {0};    // --concurrent 동시 접근 버퍼 풀 상태
+// 장치 모델 프리셋 (시간은 ns). --dev-* 옵션으로 개별 값을 덮어쓸 수 있음
+const DevicePreset device_presets[] = {
+    // 이름    읽기      쓰기      reset     추가 페이지 채널 큐 깊이
+    {"nvme",  80000,    20000,    50000,    2000,       8,   128},
+    {"zns",   80000,    25000,    2000000,  2000,       8,   64},
+    {"sata",  150000,   60000,    100000,   8000,       4,   32},
+    {"hdd",   8000000,  8000000,  0,        30000,      1,   32},
+};
+int dirty_pages = 0;          // 현재 버퍼 내 더티 프레임 수
+unsigned long long dirty_eviction_stalls = 0; // 교체 경로에서 동기 write-back 이 일어난 횟수
+int clean_victim_window = 0;  // 0보다 크면 희생자 선택 시 최대 이 수만큼의 더티 후보를 건너뜀
+unsigned long long clean_victim_picks = 0;    // 청결 희생자 선호로 희생자가 바뀐 횟수
+ZnsCost zns_cost = {0, ZNS_COST_DEFAULT_PENALTY, 0, 0, 0}; // --zns-cost 비용 인지 희생자 선택
+unsigned long long evict_seq_writebacks = 0;    // 교체 write-back 중 Zone 쓰기 포인터에 맞는 순차 쓰기 (ZNS, 로그 구조 계층 제외)
+unsigned long long evict_nonseq_writebacks = 0; // 교체 write-back 중 비순차 쓰기 (FULL Zone 포함)
+unsigned long long evictions = 0;             // 정책이 유효 페이지를 희생자로 내보낸 횟수
+unsigned long long ghost_hits[5] = {0};       // 미스 페이지가 B1..B4 고스트 리스트에서 발견된 횟수 (인덱스 1..4)
 
 // Utility function MAX and MIN
 #ifndef MAX
@@ -117,30 +907,300 @@ unsigned long long zone_write_pointers[MAX_ZONES]; // 각 Zone의 현재 쓰기
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #endif
 
+#ifdef T30_PROFILE
+// --- 단계별 프로파일러 ---
+// 단계는 중첩될 수 있으며 (예: ARC 조정 중 고스트 탐색), 안쪽 단계가 도는 동안 바깥 단계의 시간은 멈춘다.
+// 따라서 단계별 합계는 서로 겹치지 않는 배타적 시간이다.
+#define PROF_MAX_DEPTH 16
+#define PROF_EVENTS 3   // cycles, instructions, cache-misses (perf)
+
+static const char *prof_phase_names[PROF_PHASES] = { "기타", "인덱스 조회", "희생자 선택", "고스트 관리", "ARC 조정", "로그/장치" };
+
+typedef struct {
+    unsigned long long ticks[NUM_POLICIES][PROF_PHASES];
+    unsigned long long calls[NUM_POLICIES][PROF_PHASES];
+    unsigned long long events[NUM_POLICIES][PROF_PHASES][PROF_EVENTS];
+    unsigned long long requests[NUM_POLICIES];
+    int stack[PROF_MAX_DEPTH];
+    int depth;
+    unsigned long long mark_ticks;
+    unsigned long long mark_events[PROF_EVENTS];
+    unsigned long long start_ticks;
+    struct timespec start_time;
+    int perf_fd;            // perf 이벤트 그룹 리더, 없으면 -1
+} Profiler;
+
+static Profiler prof = { .perf_fd = -1 };
+
+static inline unsigned long long prof_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+#ifdef T30_PROFILE_PERF
+static int prof_perf_open(unsigned long long config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+static inline void prof_read_events(unsigned long long *out) {
+#ifdef T30_PROFILE_PERF
+    if (prof.perf_fd >= 0) {
+        unsigned long long buf[1 + PROF_EVENTS];
+        if (read(prof.perf_fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf)) {
+            for (int i = 0; i < PROF_EVENTS; i++) out[i] = buf[1 + i];
+            return;
+        }
+    }
+#endif
+    (void)out;
+}
+
+static void prof_init() {
+    prof.start_ticks = prof_ticks();
+    clock_gettime(CLOCK_MONOTONIC, &prof.start_time);
+#ifdef T30_PROFILE_PERF
+    prof.perf_fd = prof_perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (prof.perf_fd >= 0 &&
+        (prof_perf_open(PERF_COUNT_HW_INSTRUCTIONS, prof.perf_fd) < 0 || prof_perf_open(PERF_COUNT_HW_CACHE_MISSES, prof.perf_fd) < 0)) {
+        close(prof.perf_fd);
+        prof.perf_fd = -1;
+    }
+    if (prof.perf_fd < 0) {
+        fprintf(stderr, "경고: perf_event_open 실패 (%s). rdtsc 측정만 사용합니다.\n", strerror(errno));
+    } else {
+        ioctl(prof.perf_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(prof.perf_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+// 현재 단계에 지난 구간을 더하고 측정 기준점을 옮김
+static inline void prof_charge() {
+    unsigned long long now = prof_ticks();
+    unsigned long long ev[PROF_EVENTS] = {0};
+    prof_read_events(ev);
+    if (prof.depth > 0) {
+        int phase = prof.stack[prof.depth - 1];
+        prof.ticks[current_policy][phase] += now - prof.mark_ticks;
+        for (int i = 0; i < PROF_EVENTS; i++) prof.events[current_policy][phase][i] += ev[i] - prof.mark_events[i];
+    }
+    prof.mark_ticks = now;
+    memcpy(prof.mark_events, ev, sizeof(ev));
+}
+
+static inline void prof_begin(ProfPhase phase) {
+    prof_charge();
+    if (prof.depth < PROF_MAX_DEPTH) prof.stack[prof.depth] = phase;
+    prof.depth++;
+    prof.calls[current_policy][phase]++;
+    if (phase == PROF_OTHER && prof.depth == 1) prof.requests[current_policy]++;
+}
+
+static inline void prof_end() {
+    prof_charge();
+    if (prof.depth > 0) prof.depth--;
+}
+
+static void prof_report() {
+    struct timespec now_time;
+    clock_gettime(CLOCK_MONOTONIC, &now_time);
+    double elapsed_ns = (now_time.tv_sec - prof.start_time.tv_sec) * 1e9 + (now_time.tv_nsec - prof.start_time.tv_nsec);
+    double ticks_per_ns = (elapsed_ns > 0) ? (double)(prof_ticks() - prof.start_ticks) / elapsed_ns : 1.0;
+    printf("------------------------------------------------------------------------------------\n");
+    printf(" 단계별 프로파일 (rdtsc %.3f tick/ns%s)\n", ticks_per_ns, (prof.perf_fd >= 0) ? ", perf 카운터" : "");
+    for (int p = 0; p < NUM_POLICIES; p++) {
+        if (prof.requests[p] == 0) continue;
+        unsigned long long total = 0;
+        for (int ph = 0; ph < PROF_PHASES; ph++) total += prof.ticks[p][ph];
+        printf(" %s: 요청 %llu, 요청당 %.1f ns\n", policy_names[p], prof.requests[p], total / ticks_per_ns / prof.requests[p]);
+        for (int ph = 0; ph < PROF_PHASES; ph++) {
+            if (prof.calls[p][ph] == 0) continue;
+            printf("   %-12s 호출 %12llu  합계 %10.3f ms  요청당 %8.1f ns  %5.1f%%", prof_phase_names[ph], prof.calls[p][ph],
+                   prof.ticks[p][ph] / ticks_per_ns / 1e6, prof.ticks[p][ph] / ticks_per_ns / prof.requests[p],
+                   (total == 0) ? 0.0 : 100.0 * prof.ticks[p][ph] / total);
+            if (prof.perf_fd >= 0) {
+                printf("  | 요청당 cycles %.0f, instr %.0f, cache-miss %.2f",
+                       (double)prof.events[p][ph][0] / prof.requests[p], (double)prof.events[p][ph][1] / prof.requests[p],
+                       (double)prof.events[p][ph][2] / prof.requests[p]);
+            }
+            printf("\n");
+        }
+    }
+#ifdef T30_PROFILE_PERF
+    if (prof.perf_fd >= 0) close(prof.perf_fd);
+#endif
+}
+#endif
+
 // --- 함수 프로토타입 ---
 void initialize_buffer();
 void initialize_arc_state(int full_reset);
-void initialize_zone_write_pointers(); // Zone 쓰기 포인터 초기화 함수
+int zns_init(int max_open, int max_active, FILE *event_file); // Zone 테이블 초기화 (O(1))
+ZoneEntry* zns_get_zone(unsigned long long zone_id, int create);
+int zns_write(unsigned long long page_id, unsigned int num_pages);
+int zns_open_zone(unsigned long long zone_id);
+void zns_close_zone(unsigned long long zone_id);
+void zns_finish_zone(unsigned long long zone_id);
+void zns_reset_zone(unsigned long long zone_id);
+void zns_free();
+int u64map_init(U64Map *map, unsigned long long initial_capacity);
+unsigned long long u64map_get(const U64Map *map, unsigned long long key);
+void u64map_put(U64Map *map, unsigned long long key, unsigned long long value);
+void u64map_remove(U64Map *map, unsigned long long key);
+void u64map_free(U64Map *map);
+int lsl_init(unsigned long long logical_zones, unsigned long long spare_zones, unsigned long long gc_threshold);
+unsigned long long lsl_translate(unsigned long long page_id);
+void lsl_write_page(unsigned long long page_id);
+void lsl_free();
+void read_page_from_device(unsigned long long page_id);
+void read_pages_from_device(unsigned long long first_page_id, unsigned long long num_pages);
+int readahead_init(int min_window, int max_window, int num_streams, int region_pages, int max_pct);
+void readahead_on_access(unsigned long long page_id, int operation_type);
+void readahead_note_hit(int frame_idx);
+void readahead_note_wasted(int frame_idx);
+void readahead_free();
+void tinylfu_reset();
+void tinylfu_free();
+int ucp_load_map(const char *path);
+void ucp_reset();
+void ucp_free();
+int ucp_tenant_of(unsigned long long page_id);
+void release_frame(int frame_idx);
+int device_init(const DevicePreset *cfg, unsigned long long hit_ns);
+void device_submit(int operation_type, unsigned long long length_bytes);
+void device_request_begin(unsigned long long num_pages, int has_time, unsigned long long time_ns);
+void device_request_end();
+void device_epoch_report(int end_line);
+void device_free();
+int trace_open(TraceReader *reader, FILE *fp);
+int trace_next(TraceReader *reader, TraceRecord *rec);
+int trace_request_length_ok(const TraceRecord *rec, int line_num);
+void write_binary_trace_header(FILE *fp);
+int encode_binary_trace_record(BinaryTraceRecord *out, const TraceRecord *rec);
+int generate_trace_main(int argc, char *argv[]);
+int label_run(TraceReader *trace, const char *out_path, unsigned long long window_requests, int jobs, int follow,
+              unsigned long long warmup_requests);
+void timeseries_record(unsigned long long arrival_ns, unsigned long long done_ns, unsigned long long hit_pages, unsigned long long miss_pages);
+int timeseries_write(const char *path);
+void timeseries_free();
+int metrics_open(const char *path, int json, unsigned long long every);
+void metrics_emit_interval(unsigned long long requests, int line_num);
+void metrics_emit_epoch(unsigned long long requests, int end_line);
+void metrics_close();
 int find_in_buffer(unsigned long long page_id);
+void set_frame_page(int frame_idx, unsigned long long page_id);
 int find_empty_slot();
 int evict_fifo();
 void arc_remove_from_ghost(unsigned long long page_id, unsigned long long* list, int* list_size);
 void arc_add_to_ghost_mru(unsigned long long page_id, unsigned long long* list, int* list_size, int max_ghost_size);
 int find_in_arc_ghost(unsigned long long page_id, const unsigned long long* list, int list_size);
 void handle_dirty_eviction(int victim_idx);
+void write_back_page(unsigned long long page_id);
+int flusher_init(int high_pct, int low_pct, int batch_size, FlushOrder order);
+void flusher_maybe_run();
+void flusher_free();
 void write_fio_log(unsigned long long start_lba, unsigned int num_sectors, int operation_type); // ZNS 순차 쓰기 검사 추가
+int fio_log_init(FILE *fp, int window, unsigned long long max_io_bytes);
+void fio_log_submit(unsigned long long offset_bytes, unsigned long long length_bytes, int operation_type);
+void fio_log_barrier();
+void fio_log_close();
 unsigned long long lba_to_page_id(unsigned long long lba);
+int policy_code_from_name(const char *name);
 int evict_arc_internal_lru(int target_list_type_val);
 int evict_arc_internal_lfu(int target_list_type_val);
 int arc_find_victim_lru_arc(unsigned long long page_id_to_load);
 int arc_find_victim_lfu_arc(unsigned long long page_id_to_load);
-int evict_via_clock_policy(int *hand_ptr, int list_type_filter_active, int target_list_type, BufferFrame* buffer_frames, int current_buffer_size, const char* policy_name_for_log);
+int evict_via_clock_policy(int *hand_ptr, int list_type_filter_active, int target_list_type, int current_buffer_size, const char* policy_name_for_log);
+int load_page_into_buffer(unsigned long long page_id, int operation_type, int is_prefetch);
+void select_policy_path();
 void access_page(unsigned long long lba_address, unsigned long long page_id, int operation_type);
+void access_range(unsigned long long first_page_id, unsigned long long num_pages, int operation_type);
+void switch_policy(ReplacementPolicy new_policy, int verbose);
+int checkpoint_save(const char *path, const TraceReader *trace, unsigned long long requests, unsigned long long range_pages);
+int checkpoint_restore(const char *path, TraceReader *trace, unsigned long long *requests, unsigned long long *range_pages);
+int whatif_fork(TraceReader *trace, const char *trace_path, const int *policies, int count, unsigned long long requests);
+void whatif_child_finish(unsigned long long requests);
+int shard_run(TraceReader *trace, const char *log_path, unsigned long long *requests, unsigned long long *range_pages);
+int concurrent_run(TraceReader *trace, const int *thread_counts, int num_thread_counts, const int *policies, int num_policies);
+int policy_code_valid(long code);
+int parse_policy_list(const char *list, int *out);
+void clockpro_reset();
+void clockpro_rebuild();
+int clockpro_evict();
+void clockpro_admit(int frame_idx, unsigned long long page_id, int is_prefetch);
+void clockpro_drop(int frame_idx);
+void clockpro_restore(int frame_idx, unsigned long long page_id);
+void lirs_reset();
+void lirs_rebuild();
+int lirs_evict();
+void lirs_admit(int frame_idx, unsigned long long page_id, int is_prefetch);
+void lirs_hit(int frame_idx);
+void lirs_drop(int frame_idx);
+void lirs_restore(int frame_idx, unsigned long long page_id);
+void fifoq_reset();
+void fifoq_rebuild(ReplacementPolicy policy);
+int s3fifo_evict();
+int sieve_evict();
+void fifoq_admit(ReplacementPolicy policy, int frame_idx, unsigned long long page_id, int is_prefetch);
+void fifoq_drop(int frame_idx);
+void fifoq_restore(ReplacementPolicy policy, int frame_idx, unsigned long long page_id);
+int apply_policy_record(int code, int line_num, unsigned long long requests);
+unsigned long long simulate_request(const TraceRecord *rec, int line_num);
+void access_batch(const TraceRecord *recs, const int *line_nums, int count, unsigned long long *pages);
 // void print_buffer_state(); // 주석 처리
 
 
 // --- 함수 구현 ---
 
+// 교체 정책 코드인지 (예약 코드 SYNTHETIC 제외)
+int policy_code_valid(long code) {
+    return code >= 0 && code < NUM_POLICIES && code != SYNTHETIC;
+}
+
+// 정책 이름 (대소문자 무시) -> 정책 코드, 없으면 -1
+int policy_code_from_name(const char *name) {
+    for (int i = 0; i < NUM_POLICIES; i++) {
+        if (policy_code_valid(i) && strcasecmp(name, policy_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// "all" 또는 쉼표로 구분한 정책 이름 목록 -> 중복 없는 정책 코드 배열 (최대 NUM_POLICIES 개), 잘못된 이름이면 -1
+int parse_policy_list(const char *list, int *out) {
+    int count = 0;
+    if (strcasecmp(list, "all") == 0) {
+        for (int p = 0; p < NUM_POLICIES; p++) {
+            if (policy_code_valid(p)) out[count++] = p;
+        }
+        return count;
+    }
+    char names[256];
+    snprintf(names, sizeof(names), "%s", list);
+    for (char *tok = strtok(names, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        int code = policy_code_from_name(tok);
+        if (code < 0) { fprintf(stderr, "오류: 잘못된 정책 이름 '%s'.\n", tok); return -1; }
+        int dup = 0;
+        for (int i = 0; i < count; i++) dup |= (out[i] == code);
+        if (!dup) out[count++] = code;
+    }
+    return count;
+}
+
 unsigned long long lba_to_page_id(unsigned long long lba) {
     if (SECTORS_PER_PAGE == 0) {
          fprintf(stderr, "Error: SECTORS_PER_PAGE cannot be zero.\n");
@@ -150,38 +1210,40 @@ unsigned long long lba_to_page_id(unsigned long long lba) {
 }
 
 void initialize_buffer() {
+    if (page_index.keys == NULL) {
+        if (u64map_init(&page_index, (unsigned long long)buffer_size * 2) != 0) {
+            fprintf(stderr, "Error: Failed to allocate page index.\n");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        for (unsigned long long i = 0; i < page_index.capacity; i++) page_index.keys[i] = INVALID_PAGE;
+        page_index.count = 0;
+    }
     for (int i = 0; i < buffer_size; i++) {
         buffer[i].page_id = INVALID_PAGE;
         buffer[i].load_time = 0;
         buffer[i].last_access_time = 0;
         buffer[i].access_count = 0;
-        buffer[i].list_type = 0;
         buffer[i].is_dirty = 0;
         buffer[i].ref_arc_list_type = 0;
-        buffer[i].ref_bit = 0;
+        buffer[i].prefetched = 0;
     }
+    memset(&frame_hot, 0, sizeof(frame_hot));
+    memset(frame_hot.list_bits[0], 0xff, sizeof(frame_hot.list_bits[0])); // 모든 프레임 list_type 0
     hits = 0;
     misses = 0;
     current_time = 0;
+    dirty_pages = 0;
     // previous_policy_for_state_carryover = FIFO; // FIFO는 이제 4
     // 초기 정책 설정은 main에서 하므로, 여기서 특정 값으로 고정할 필요는 없음.
     // main에서 current_policy가 설정된 후 previous_policy_for_state_carryover = current_policy;로 설정됨.
     global_clk_hand = 0;
-}
-
-// Zone 쓰기 포인터 초기화 함수
-void initialize_zone_write_pointers() {
-    if (zone_size_pages_global == 0) {
-        //fprintf(stderr, "Warning: Zone size is 0, ZNS constraints disabled.\n");
-        return; // Zone 크기가 0이면 ZNS 기능을 사용하지 않음
-    }
-    // 모든 Zone의 시작 페이지 ID로 쓰기 포인터 초기화
-    // 실제로는 Zone 상태(Empty, Open 등)에 따라 달라져야 함
-    // 여기서는 단순화를 위해 모든 Zone이 비어있고 쓰기 가능하다고 가정
-    for (int i = 0; i < MAX_ZONES; i++) {
-        zone_write_pointers[i] = (unsigned long long)i * zone_size_pages_global;
-    }
-    // printf("Initialized %d zone write pointers.\n", MAX_ZONES); // 디버깅용
+    clockpro_reset();
+    fifoq_reset();
+    lirs_reset();
+    tinylfu_reset();
+    ucp_reset();
+    select_policy_path();
 }
 
 
@@ -223,109 +1285,1039 @@ void initialize_arc_state(int full_reset) {
 }
 
 int find_in_buffer(unsigned long long page_id) {
-    for (int i = 0; i < buffer_size; i++) {
-        if (buffer[i].page_id == page_id) return i;
-    }
-    return -1;
+    unsigned long long frame_idx = u64map_get(&page_index, page_id);
+    return (frame_idx == INVALID_PAGE) ? -1 : (int)frame_idx;
 }
 
-int find_empty_slot() {
-    for (int i = 0; i < buffer_size; i++) {
-        if (buffer[i].page_id == INVALID_PAGE) return i;
+// 프레임의 page_id 를 바꾸면서 page_index 와 유효 비트맵을 함께 갱신 (INVALID_PAGE 는 빈 슬롯)
+void set_frame_page(int frame_idx, unsigned long long page_id) {
+    unsigned long long bit = 1ULL << (frame_idx & 63);
+    if (buffer[frame_idx].page_id != INVALID_PAGE) {
+        u64map_remove(&page_index, buffer[frame_idx].page_id);
+        if (ucp.enabled) {
+            ucp.occupancy[ucp.frame_tenant[frame_idx]]--;
+            ucp.tenant_bits[ucp.frame_tenant[frame_idx]][frame_idx >> 6] &= ~bit;
+        }
+    }
+    buffer[frame_idx].page_id = page_id;
+    if (page_id != INVALID_PAGE) {
+        u64map_put(&page_index, page_id, (unsigned long long)frame_idx);
+        frame_hot.valid[frame_idx >> 6] |= bit;
+        if (ucp.enabled) {
+            int tenant = ucp_tenant_of(page_id);
+            ucp.frame_tenant[frame_idx] = (unsigned char)tenant;
+            ucp.occupancy[tenant]++;
+            ucp.tenant_bits[tenant][frame_idx >> 6] |= bit;
+        }
+    } else {
+        frame_hot.valid[frame_idx >> 6] &= ~bit;
+        if ((frame_idx >> 6) < frame_hot.free_hint) frame_hot.free_hint = frame_idx >> 6;
     }
-    return -1;
 }
 
-// FIO 로그 작성 함수 (ZNS 순차 쓰기 제약 검사 및 적용)
-void write_fio_log(unsigned long long start_lba, unsigned int num_sectors, int operation_type) {
-    if (log_file == NULL || SECTOR_SIZE <= 0 || num_sectors == 0) return;
+static inline int frame_list(int frame_idx) { return frame_hot.list_type[frame_idx]; }
 
-    unsigned long long offset_bytes = start_lba * SECTOR_SIZE;
-    unsigned long long length_bytes_ull = (unsigned long long)num_sectors * SECTOR_SIZE;
-    unsigned int length_bytes = (length_bytes_ull > UINT_MAX) ? UINT_MAX : (unsigned int)length_bytes_ull;
-    if (length_bytes_ull > UINT_MAX) fprintf(stderr, "Warning: I/O length overflow LBA %llu.\n", start_lba);
+void set_frame_list(int frame_idx, int list_type) {
+    unsigned long long bit = 1ULL << (frame_idx & 63);
+    frame_hot.list_bits[frame_hot.list_type[frame_idx]][frame_idx >> 6] &= ~bit;
+    frame_hot.list_type[frame_idx] = (unsigned char)list_type;
+    frame_hot.list_bits[list_type][frame_idx >> 6] |= bit;
+}
 
-    const char *action_str = (operation_type == OP_READ) ? "read" : "write";
+static inline int frame_ref(int frame_idx) { return (int)((frame_hot.ref[frame_idx >> 6] >> (frame_idx & 63)) & 1); }
 
-    // ZNS 순차 쓰기 제약 검사 (쓰기 작업이고, Zone 크기가 설정된 경우)
-    if (operation_type == OP_WRITE && zone_size_pages_global > 0) {
-        unsigned long long target_page_id = lba_to_page_id(start_lba);
-        unsigned long long zone_id = target_page_id / zone_size_pages_global;
-        unsigned long long zone_start_page = zone_id * zone_size_pages_global;
-        // num_pages 계산 (올림 처리)
-        unsigned int num_pages = (num_sectors + SECTORS_PER_PAGE - 1) / SECTORS_PER_PAGE;
-        if (num_pages == 0 && num_sectors > 0) num_pages = 1; // 최소 1 페이지
+static inline void set_frame_ref(int frame_idx, int ref) {
+    unsigned long long bit = 1ULL << (frame_idx & 63);
+    if (ref) frame_hot.ref[frame_idx >> 6] |= bit;
+    else frame_hot.ref[frame_idx >> 6] &= ~bit;
+}
 
-        // Zone ID 유효성 검사
-        if (zone_id >= MAX_ZONES) {
-            fprintf(stderr, "ZNS Error: Target Zone ID %llu exceeds MAX_ZONES %d for Page %llu. Write skipped.\n",
-                    zone_id, MAX_ZONES, target_page_id);
-            return; // 로그 기록 안 함
-        }
+// word w 의 희생자 후보 비트 (유효 프레임, list_type_filter >= 0 이면 그 리스트만)
+static inline unsigned long long frame_candidates(int w, int list_type_filter) {
+    unsigned long long bits = frame_hot.valid[w];
+    if (list_type_filter >= 0) bits &= frame_hot.list_bits[list_type_filter][w];
+    if (ucp.victim_bits != NULL) bits &= ucp.victim_bits[w];
+    return bits;
+}
 
-        // 현재 Zone의 쓰기 포인터 가져오기
-        unsigned long long current_wp = zone_write_pointers[zone_id];
+// 프레임 하나가 희생자 후보인지 (유효 + --tenants 제한). 큐 기반 정책은 교체 끝에서 걸어가며 이것으로 거른다
+static inline int frame_is_candidate(int frame_idx) {
+    return (int)((frame_candidates(frame_idx >> 6, -1) >> (frame_idx & 63)) & 1);
+}
 
-        // 순차 쓰기 검사
-        if (target_page_id != current_wp) {
-            fprintf(stderr, "ZNS Violation: Non-sequential write attempt on Zone %llu. Target Page: %llu, Expected WP: %llu. Logging write anyway.\n",
-                    zone_id, target_page_id, current_wp);
-            // 실제 ZNS에서는 이 쓰기가 실패해야 하지만, 시뮬레이션에서는 로그는 남김
-        } else {
-            // 순차 쓰기 성공. 쓰기 포인터 업데이트
-            // 주의: 이 업데이트는 쓰기가 Zone 경계를 넘지 않는다고 가정함.
-            // 실제 ZNS에서는 Zone 용량 체크 및 경계 처리 필요.
-            unsigned long long next_wp = current_wp + num_pages;
-            unsigned long long zone_end_page = zone_start_page + zone_size_pages_global;
-            if (next_wp > zone_end_page) {
-                 fprintf(stderr, "ZNS Warning: Write attempt spans across Zone %llu boundary (Target: %llu, End: %llu). Adjusting WP to zone end. Logging write anyway.\n",
-                         zone_id, next_wp, zone_end_page);
-                 zone_write_pointers[zone_id] = zone_end_page; // 실제로는 Zone Full 상태 처리 필요
-            } else {
-                 zone_write_pointers[zone_id] = next_wp;
-                 // printf("ZNS Info: Sequential write success on Zone %llu. New WP: %llu\n", zone_id, next_wp); // 디버깅용
-            }
-        }
-        // --- 추가 ZNS 제약 조건 검사 위치 ---
-        // 1. Zone 상태 확인 (Open/Empty 인가?) - 이 시뮬레이터는 상태 추적 안 함
-        // 2. Zone 용량 확인 (쓰려는 크기가 남은 공간보다 작은가?) - 위에서 간단히 경계 체크로 대체
-        // ------------------------------------
+// 테넌트 부분 리스트 (--tenants 가 꺼져 있으면 아무것도 하지 않음). 프레임의 테넌트는 ucp.frame_tenant
+static void tchain_reset(TenantChain *c) {
+    for (int t = 0; t < UCP_MAX_TENANTS; t++) {
+        for (int l = 0; l < 2; l++) { c->head[l][t] = c->tail[l][t] = -1; c->size[l][t] = 0; }
+        c->hand[t] = -1;
     }
+}
 
-    // FIO 로그 기록 (순차성 위반 여부와 관계없이 기록 - 시뮬레이션 흐름 유지)
-    fprintf(log_file, "%s %s %llu %u\n", DEVICE_NAME, action_str, offset_bytes, length_bytes);
+// after 뒤(꼬리 쪽)에 넣는다. after 가 -1 이면 머리에
+static void tchain_insert_after(TenantChain *c, int list, int after, int frame_idx) {
+    if (!ucp.enabled) return;
+    int t = ucp.frame_tenant[frame_idx];
+    int next = (after != -1) ? c->next[after] : c->head[list][t];
+    c->prev[frame_idx] = after;
+    c->next[frame_idx] = next;
+    if (after != -1) c->next[after] = frame_idx; else c->head[list][t] = frame_idx;
+    if (next != -1) c->prev[next] = frame_idx; else c->tail[list][t] = frame_idx;
+    c->size[list][t]++;
 }
 
+static inline void tchain_push_head(TenantChain *c, int list, int frame_idx) {
+    tchain_insert_after(c, list, -1, frame_idx);
+}
 
-// 더티 페이지 처리 함수 (write_fio_log 호출 시 ZNS 제약 검사 수행됨)
-void handle_dirty_eviction(int victim_idx) {
-    if (victim_idx < 0 || victim_idx >= buffer_size) return;
-    if (buffer[victim_idx].page_id != INVALID_PAGE && buffer[victim_idx].is_dirty) {
-        // write_fio_log 내부에서 ZNS 순차 쓰기 제약 검사 및 WP 업데이트 수행
-        write_fio_log(buffer[victim_idx].page_id * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_WRITE);
-        buffer[victim_idx].is_dirty = 0; // 쓰기 시도 후 dirty 플래그 해제
+static inline void tchain_push_tail(TenantChain *c, int list, int frame_idx) {
+    if (ucp.enabled) tchain_insert_after(c, list, c->tail[list][ucp.frame_tenant[frame_idx]], frame_idx);
+}
+
+static void tchain_unlink(TenantChain *c, int list, int frame_idx) {
+    if (!ucp.enabled) return;
+    int t = ucp.frame_tenant[frame_idx], prev = c->prev[frame_idx], next = c->next[frame_idx];
+    if (c->hand[t] == frame_idx) c->hand[t] = prev;
+    if (prev != -1) c->next[prev] = next; else c->head[list][t] = next;
+    if (next != -1) c->prev[next] = prev; else c->tail[list][t] = prev;
+    c->size[list][t]--;
+}
+
+// 후보 프레임을 인덱스 순서로 순회 (비트맵 word 단위, cold 필드는 본문에서만 읽음)
+#define FOR_EACH_CANDIDATE_FRAME(i, list_type_filter) \
+    for (int w_ = 0; w_ < (buffer_size + 63) >> 6; w_++) \
+        for (unsigned long long m_ = frame_candidates(w_, (list_type_filter)); m_; m_ &= m_ - 1) \
+            for (int i = (w_ << 6) + __builtin_ctzll(m_), once_ = 1; once_; once_ = 0)
+
+// 가장 낮은 인덱스의 빈 프레임. free_hint 아래의 word 는 모두 가득 차 있으므로 건너뛴다
+int find_empty_slot() {
+    if (page_index.count >= (unsigned long long)buffer_size) return -1; // 버퍼가 가득 참
+    int words = (buffer_size + 63) >> 6;
+    for (int w = frame_hot.free_hint; w < words; w++) {
+        unsigned long long free_bits = ~frame_hot.valid[w];
+        if (free_bits == 0) { frame_hot.free_hint = w + 1; continue; }
+        int idx = (w << 6) + __builtin_ctzll(free_bits);
+        if (idx >= buffer_size) break;
+        frame_hot.free_hint = w;
+        return idx;
     }
+    return -1;
 }
 
-int evict_fifo() {
-    if (buffer_size == 0) return -1;
-    int victim_idx = -1;
-    unsigned long long min_load_time = ULLONG_MAX;
-    for (int i = 0; i < buffer_size; i++) {
-        if (buffer[i].page_id != INVALID_PAGE) {
-            if (buffer[i].load_time < min_load_time) {
-                min_load_time = buffer[i].load_time;
-                victim_idx = i;
-            }
+// --- FIO 로그 writer ---
+// fprintf 대신 정수를 직접 포맷해 큰 버퍼에 모아 fwrite 하고,
+// 선택적으로 연속된 같은 방향 I/O를 하나의 큰 요청으로 병합한다.
+
+int fio_log_init(FILE *fp, int window, unsigned long long max_io_bytes) {
+    fio_log.fp = fp;
+    fio_log.len = 0;
+    fio_log.buf = (char*)malloc(FIO_LOG_BUF_SIZE);
+    if (fio_log.buf == NULL) return -1;
+    if (window < 0) window = 0;
+    if (window > FIO_COALESCE_MAX_WINDOW) window = FIO_COALESCE_MAX_WINDOW;
+    if (max_io_bytes > UINT_MAX) max_io_bytes = UINT_MAX;
+    fio_log.window = (max_io_bytes > 0) ? window : 0;
+    fio_log.max_io_bytes = max_io_bytes;
+    fio_log.pending_count = 0;
+    fio_log.ios_submitted = 0;
+    fio_log.ios_written = 0;
+    return 0;
+}
+
+static void fio_log_drain_buffer() {
+    if (fio_log.len > 0 && fio_log.fp != NULL) {
+        if (fwrite(fio_log.buf, 1, fio_log.len, fio_log.fp) != fio_log.len) {
+            fprintf(stderr, "Warning: FIO log write failed: %s\n", strerror(errno));
         }
     }
-    if (victim_idx == -1 && find_empty_slot() == -1 && buffer_size > 0) {
-        victim_idx = 0;
+    fio_log.len = 0;
+}
+
+// 10진수 포맷 (printf 의 %llu 와 동일한 출력)
+static char* fio_log_put_u64(char *p, unsigned long long v) {
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v != 0);
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+}
+
+static void fio_log_emit(unsigned long long offset_bytes, unsigned long long length_bytes, int operation_type) {
+    static const char read_prefix[] = DEVICE_NAME " read ";
+    static const char write_prefix[] = DEVICE_NAME " write ";
+    static const char trim_prefix[] = DEVICE_NAME " trim ";
+
+    if (fio_log.len + FIO_LOG_LINE_MAX > FIO_LOG_BUF_SIZE) fio_log_drain_buffer();
+
+    char *p = fio_log.buf + fio_log.len;
+    if (operation_type == OP_READ) {
+        memcpy(p, read_prefix, sizeof(read_prefix) - 1);
+        p += sizeof(read_prefix) - 1;
+    } else if (operation_type == OP_WRITE) {
+        memcpy(p, write_prefix, sizeof(write_prefix) - 1);
+        p += sizeof(write_prefix) - 1;
+    } else {
+        memcpy(p, trim_prefix, sizeof(trim_prefix) - 1);
+        p += sizeof(trim_prefix) - 1;
     }
-    return victim_idx;
+    p = fio_log_put_u64(p, offset_bytes);
+    *p++ = ' ';
+    p = fio_log_put_u64(p, length_bytes);
+    *p++ = '\n';
+    fio_log.len = (size_t)(p - fio_log.buf);
+    fio_log.ios_written++;
 }
 
-void arc_remove_from_ghost(unsigned long long page_id, unsigned long long* list, int* list_size) {
+static void fio_log_emit_oldest_pending() {
+    FioPendingIO *io = &fio_log.pending[0];
+    fio_log_emit(io->offset_bytes, io->length_bytes, io->operation_type);
+    fio_log.pending_count--;
+    memmove(&fio_log.pending[0], &fio_log.pending[1], fio_log.pending_count * sizeof(FioPendingIO));
+}
+
+// 대기 중인 I/O를 모두 기록 (zone 관리 명령 등 순서가 중요한 지점에서 호출)
+void fio_log_barrier() {
+    while (fio_log.pending_count > 0) fio_log_emit_oldest_pending();
+}
+
+void fio_log_submit(unsigned long long offset_bytes, unsigned long long length_bytes, int operation_type) {
+    if (fio_log.buf == NULL) return;
+    fio_log.ios_submitted++;
+
+    if (fio_log.window == 0) {
+        fio_log_emit(offset_bytes, length_bytes, operation_type);
+        return;
+    }
+
+    // 최신 요청부터 거슬러 올라가며 병합 대상을 찾는다.
+    // 새 I/O와 겹치는 대기 요청을 만나면 그보다 앞선 요청과는 병합하지 않는다
+    // (같은 주소에 대한 요청 순서가 바뀌지 않도록).
+    unsigned long long end_bytes = offset_bytes + length_bytes;
+    for (int i = fio_log.pending_count - 1; i >= 0; i--) {
+        FioPendingIO *io = &fio_log.pending[i];
+        unsigned long long io_end = io->offset_bytes + io->length_bytes;
+        if (io->operation_type == operation_type && io->length_bytes + length_bytes <= fio_log.max_io_bytes) {
+            if (io_end == offset_bytes) {          // 뒤쪽으로 이어짐
+                io->length_bytes += length_bytes;
+                return;
+            }
+            if (end_bytes == io->offset_bytes) {   // 앞쪽으로 이어짐
+                io->offset_bytes = offset_bytes;
+                io->length_bytes += length_bytes;
+                return;
+            }
+        }
+        if (offset_bytes < io_end && io->offset_bytes < end_bytes) break;
+    }
+
+    if (fio_log.pending_count == fio_log.window) fio_log_emit_oldest_pending();
+    FioPendingIO *slot = &fio_log.pending[fio_log.pending_count++];
+    slot->offset_bytes = offset_bytes;
+    slot->length_bytes = length_bytes;
+    slot->operation_type = operation_type;
+}
+
+void fio_log_close() {
+    fio_log_barrier();
+    fio_log_drain_buffer();
+    free(fio_log.buf);
+    fio_log.buf = NULL;
+    fio_log.fp = NULL;
+}
+
+// --- ZNS Zone 상태 머신 ---
+// Zone은 처음 접근될 때 테이블에 추가되므로 초기화 비용은 O(1),
+// 메모리는 실제로 사용된 Zone 수에 비례한다.
+
+static unsigned long long zns_hash(unsigned long long zone_id) {
+    return zone_id * 0x9E3779B97F4A7C15ULL;
+}
+
+static ZoneEntry* zns_alloc_slots(unsigned long long capacity) {
+    ZoneEntry *slots = (ZoneEntry*)malloc(capacity * sizeof(ZoneEntry));
+    if (slots == NULL) return NULL;
+    for (unsigned long long i = 0; i < capacity; i++) slots[i].zone_id = INVALID_ZONE;
+    return slots;
+}
+
+int zns_init(int max_open, int max_active, FILE *event_file) {
+    zns_free();
+    zone_table.capacity = ZONE_TABLE_INITIAL_CAPACITY;
+    zone_table.slots = zns_alloc_slots(zone_table.capacity);
+    if (zone_table.slots == NULL) return -1;
+    zone_table.max_open = max_open;
+    zone_table.max_active = max_active;
+    zone_table.event_file = event_file;
+    return 0;
+}
+
+void zns_free() {
+    free(zone_table.slots);
+    free(zone_table.open_zone_ids);
+    free(zone_table.active_zone_ids);
+    memset(&zone_table, 0, sizeof(zone_table));
+}
+
+static void zns_grow() {
+    unsigned long long new_capacity = zone_table.capacity * 2;
+    ZoneEntry *new_slots = zns_alloc_slots(new_capacity);
+    if (new_slots == NULL) {
+        fprintf(stderr, "ZNS Error: Failed to grow zone table to %llu slots.\n", new_capacity);
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned long long i = 0; i < zone_table.capacity; i++) {
+        if (zone_table.slots[i].zone_id == INVALID_ZONE) continue;
+        unsigned long long pos = zns_hash(zone_table.slots[i].zone_id) & (new_capacity - 1);
+        while (new_slots[pos].zone_id != INVALID_ZONE) pos = (pos + 1) & (new_capacity - 1);
+        new_slots[pos] = zone_table.slots[i];
+    }
+    free(zone_table.slots);
+    zone_table.slots = new_slots;
+    zone_table.capacity = new_capacity;
+}
+
+// Zone 조회. create 가 참이면 없는 Zone을 EMPTY 상태로 추가한다.
+// 반환된 포인터는 다음 생성 호출(테이블 확장) 전까지만 유효함.
+ZoneEntry* zns_get_zone(unsigned long long zone_id, int create) {
+    if (zone_table.slots == NULL || zone_id == INVALID_ZONE) return NULL;
+    unsigned long long mask = zone_table.capacity - 1;
+    unsigned long long pos = zns_hash(zone_id) & mask;
+    while (zone_table.slots[pos].zone_id != INVALID_ZONE) {
+        if (zone_table.slots[pos].zone_id == zone_id) return &zone_table.slots[pos];
+        pos = (pos + 1) & mask;
+    }
+    if (!create) return NULL;
+    if ((zone_table.used + 1) * 2 > zone_table.capacity) {
+        zns_grow();
+        return zns_get_zone(zone_id, create);
+    }
+    ZoneEntry *z = &zone_table.slots[pos];
+    z->zone_id = zone_id;
+    z->write_pointer = zone_id * zone_size_pages_global;
+    z->last_write_seq = 0;
+    z->state = ZONE_EMPTY;
+    z->open_pos = -1;
+    z->active_pos = -1;
+    zone_table.used++;
+    return z;
+}
+
+static void zns_log_event(const char *event, unsigned long long zone_id) {
+    if (zone_table.event_file == NULL) return;
+    fprintf(zone_table.event_file, "%s %llu %llu\n", event, zone_id,
+            zone_id * zone_size_pages_global * SECTORS_PER_PAGE * SECTOR_SIZE);
+}
+
+// open / active 목록 관리 (위치를 ZoneEntry 에 저장해 O(1) 제거)
+static void zns_list_add(unsigned long long **ids, int *count, int *capacity, unsigned long long zone_id, int *pos_out) {
+    if (*count == *capacity) {
+        int new_capacity = (*capacity == 0) ? 16 : *capacity * 2;
+        unsigned long long *grown = (unsigned long long*)realloc(*ids, new_capacity * sizeof(unsigned long long));
+        if (grown == NULL) {
+            fprintf(stderr, "ZNS Error: Failed to grow zone list.\n");
+            exit(EXIT_FAILURE);
+        }
+        *ids = grown;
+        *capacity = new_capacity;
+    }
+    (*ids)[*count] = zone_id;
+    *pos_out = (*count)++;
+}
+
+static void zns_list_remove(unsigned long long *ids, int *count, int pos, int is_open_list) {
+    (*count)--;
+    if (pos != *count) {
+        ids[pos] = ids[*count];
+        ZoneEntry *moved = zns_get_zone(ids[pos], 0);
+        if (is_open_list) moved->open_pos = pos; else moved->active_pos = pos;
+    }
+}
+
+static void zns_set_state(ZoneEntry *z, ZoneCondition new_state) {
+    int was_open = (z->state == ZONE_IMPLICIT_OPEN || z->state == ZONE_EXPLICIT_OPEN);
+    int was_active = was_open || z->state == ZONE_CLOSED;
+    int is_open = (new_state == ZONE_IMPLICIT_OPEN || new_state == ZONE_EXPLICIT_OPEN);
+    int is_active = is_open || new_state == ZONE_CLOSED;
+
+    if (was_open && !is_open) {
+        zns_list_remove(zone_table.open_zone_ids, &zone_table.open_count, z->open_pos, 1);
+        z->open_pos = -1;
+    } else if (!was_open && is_open) {
+        zns_list_add(&zone_table.open_zone_ids, &zone_table.open_count, &zone_table.open_capacity, z->zone_id, &z->open_pos);
+    }
+    if (was_active && !is_active) {
+        zns_list_remove(zone_table.active_zone_ids, &zone_table.active_count, z->active_pos, 0);
+        z->active_pos = -1;
+    } else if (!was_active && is_active) {
+        zns_list_add(&zone_table.active_zone_ids, &zone_table.active_count, &zone_table.active_capacity, z->zone_id, &z->active_pos);
+    }
+    z->state = new_state;
+    zone_table.peak_open = MAX(zone_table.peak_open, zone_table.open_count);
+    zone_table.peak_active = MAX(zone_table.peak_active, zone_table.active_count);
+}
+
+// 가장 오래전에 쓰인 Zone 선택 (only_implicit: 암시적으로 열린 Zone만)
+static unsigned long long zns_pick_lru(const unsigned long long *ids, int count, int only_implicit, unsigned long long exclude) {
+    unsigned long long best = INVALID_ZONE, best_seq = ULLONG_MAX;
+    for (int i = 0; i < count; i++) {
+        if (ids[i] == exclude) continue;
+        ZoneEntry *z = zns_get_zone(ids[i], 0);
+        if (only_implicit && z->state != ZONE_IMPLICIT_OPEN) continue;
+        if (z->last_write_seq < best_seq) { best_seq = z->last_write_seq; best = ids[i]; }
+    }
+    return best;
+}
+
+// zone_id 를 open 하기 위한 open/active 자원 확보.
+// active 한도 초과 시 가장 오래된 active Zone을 finish, open 한도 초과 시 암시적 open Zone을 close.
+static int zns_reserve_resources(unsigned long long zone_id, int needs_active) {
+    if (needs_active && zone_table.max_active > 0 && zone_table.active_count >= zone_table.max_active) {
+        unsigned long long victim = zns_pick_lru(zone_table.active_zone_ids, zone_table.active_count, 0, zone_id);
+        if (victim == INVALID_ZONE) return -1;
+        zns_finish_zone(victim);
+    }
+    if (zone_table.max_open > 0 && zone_table.open_count >= zone_table.max_open) {
+        unsigned long long victim = zns_pick_lru(zone_table.open_zone_ids, zone_table.open_count, 1, zone_id);
+        if (victim == INVALID_ZONE) return -1; // 모두 명시적으로 열린 Zone (Too Many Open Zones)
+        ZoneEntry *vz = zns_get_zone(victim, 0);
+        zns_set_state(vz, ZONE_CLOSED);
+        zone_table.implicit_closes++;
+    }
+    return 0;
+}
+
+// 명시적 open. 성공 시 0, 자원 부족 또는 FULL 이면 -1
+int zns_open_zone(unsigned long long zone_id) {
+    ZoneEntry *z = zns_get_zone(zone_id, 1);
+    if (z == NULL || z->state == ZONE_FULL) return -1;
+    if (z->state == ZONE_EXPLICIT_OPEN) return 0;
+    if (z->state != ZONE_IMPLICIT_OPEN) {
+        if (zns_reserve_resources(zone_id, z->state == ZONE_EMPTY) != 0) return -1;
+        z = zns_get_zone(zone_id, 0);
+    }
+    zns_set_state(z, ZONE_EXPLICIT_OPEN);
+    zone_table.explicit_opens++;
+    zns_log_event("open", zone_id);
+    return 0;
+}
+
+void zns_close_zone(unsigned long long zone_id) {
+    ZoneEntry *z = zns_get_zone(zone_id, 0);
+    if (z == NULL || (z->state != ZONE_IMPLICIT_OPEN && z->state != ZONE_EXPLICIT_OPEN)) return;
+    // 한 번도 쓰이지 않은 Zone을 닫으면 EMPTY 로 돌아감
+    zns_set_state(z, (z->write_pointer == zone_id * zone_size_pages_global) ? ZONE_EMPTY : ZONE_CLOSED);
+    zone_table.explicit_closes++;
+    zns_log_event("close", zone_id);
+}
+
+void zns_finish_zone(unsigned long long zone_id) {
+    ZoneEntry *z = zns_get_zone(zone_id, 1);
+    if (z == NULL || z->state == ZONE_FULL) return;
+    z->write_pointer = (zone_id + 1) * zone_size_pages_global;
+    zns_set_state(z, ZONE_FULL);
+    zone_table.finishes++;
+    zns_log_event("finish", zone_id);
+}
+
+// Zone reset: FIO 로그에는 zone 전체 범위 trim 으로 기록
+void zns_reset_zone(unsigned long long zone_id) {
+    ZoneEntry *z = zns_get_zone(zone_id, 1);
+    if (z == NULL) return;
+    unsigned long long zone_start_page = zone_id * zone_size_pages_global;
+    z->write_pointer = zone_start_page;
+    zns_set_state(z, ZONE_EMPTY);
+    zone_table.resets++;
+    zns_log_event("reset", zone_id);
+    fio_log_barrier();
+    fio_log_submit(zone_start_page * SECTORS_PER_PAGE * SECTOR_SIZE,
+                   zone_size_pages_global * SECTORS_PER_PAGE * SECTOR_SIZE, OP_TRIM);
+    device_submit(OP_TRIM, zone_size_pages_global * SECTORS_PER_PAGE * SECTOR_SIZE);
+}
+
+// 순차 쓰기 검사 및 Zone 상태 전이. 순차 쓰기면 0, 위반이면 -1.
+int zns_write(unsigned long long page_id, unsigned int num_pages) {
+    unsigned long long zone_id = page_id / zone_size_pages_global;
+    unsigned long long zone_end_page = (zone_id + 1) * zone_size_pages_global;
+    ZoneEntry *z = zns_get_zone(zone_id, 1);
+
+    if (z->state == ZONE_FULL) {
+        fprintf(stderr, "ZNS Violation: Write to FULL Zone %llu. Target Page: %llu. Logging write anyway.\n",
+                zone_id, page_id);
+        zone_table.violations++;
+        return -1;
+    }
+    if (page_id != z->write_pointer) {
+        fprintf(stderr, "ZNS Violation: Non-sequential write attempt on Zone %llu. Target Page: %llu, Expected WP: %llu. Logging write anyway.\n",
+                zone_id, page_id, z->write_pointer);
+        zone_table.violations++;
+        return -1;
+    }
+
+    // EMPTY/CLOSED Zone에 대한 쓰기는 암시적 open 을 유발
+    if (z->state == ZONE_EMPTY || z->state == ZONE_CLOSED) {
+        if (zns_reserve_resources(zone_id, z->state == ZONE_EMPTY) != 0) {
+            fprintf(stderr, "ZNS Violation: Too many open zones (all explicitly opened) for write on Zone %llu. Logging write anyway.\n",
+                    zone_id);
+            zone_table.violations++;
+            return -1;
+        }
+        z = zns_get_zone(zone_id, 0);
+        zns_set_state(z, ZONE_IMPLICIT_OPEN);
+        zone_table.implicit_opens++;
+    }
+
+    z->last_write_seq = ++zone_table.write_seq;
+    unsigned long long next_wp = z->write_pointer + num_pages;
+    if (next_wp > zone_end_page) {
+        fprintf(stderr, "ZNS Warning: Write attempt spans across Zone %llu boundary (Target: %llu, End: %llu). Adjusting WP to zone end. Logging write anyway.\n",
+                zone_id, next_wp, zone_end_page);
+        next_wp = zone_end_page;
+    }
+    z->write_pointer = next_wp;
+    if (next_wp == zone_end_page) zns_set_state(z, ZONE_FULL); // 용량 소진 시 FULL 로 전이 (자원 반환)
+    return 0;
+}
+
+// --- 64비트 해시 맵 ---
+
+static unsigned long long u64map_slot(unsigned long long key, unsigned long long capacity) {
+    return (key * 0x9E3779B97F4A7C15ULL) >> 17 & (capacity - 1);
+}
+
+int u64map_init(U64Map *map, unsigned long long initial_capacity) {
+    unsigned long long capacity = 16;
+    while (capacity < initial_capacity) capacity *= 2;
+    map->keys = (unsigned long long*)malloc(capacity * sizeof(unsigned long long));
+    map->values = (unsigned long long*)malloc(capacity * sizeof(unsigned long long));
+    if (map->keys == NULL || map->values == NULL) {
+        free(map->keys); free(map->values);
+        map->keys = map->values = NULL;
+        return -1;
+    }
+    for (unsigned long long i = 0; i < capacity; i++) map->keys[i] = INVALID_PAGE;
+    map->capacity = capacity;
+    map->count = 0;
+    return 0;
+}
+
+void u64map_free(U64Map *map) {
+    free(map->keys);
+    free(map->values);
+    map->keys = map->values = NULL;
+    map->capacity = map->count = 0;
+}
+
+// 키가 없으면 INVALID_PAGE 반환
+unsigned long long u64map_get(const U64Map *map, unsigned long long key) {
+    unsigned long long mask = map->capacity - 1;
+    for (unsigned long long pos = u64map_slot(key, map->capacity); map->keys[pos] != INVALID_PAGE; pos = (pos + 1) & mask) {
+        if (map->keys[pos] == key) return map->values[pos];
+    }
+    return INVALID_PAGE;
+}
+
+static void u64map_grow(U64Map *map) {
+    U64Map grown;
+    if (u64map_init(&grown, map->capacity * 2) != 0) {
+        fprintf(stderr, "Error: Failed to grow hash map to %llu slots.\n", map->capacity * 2);
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned long long i = 0; i < map->capacity; i++) {
+        if (map->keys[i] != INVALID_PAGE) u64map_put(&grown, map->keys[i], map->values[i]);
+    }
+    u64map_free(map);
+    *map = grown;
+}
+
+void u64map_put(U64Map *map, unsigned long long key, unsigned long long value) {
+    if ((map->count + 1) * 4 > map->capacity * 3) u64map_grow(map);
+    unsigned long long mask = map->capacity - 1;
+    unsigned long long pos = u64map_slot(key, map->capacity);
+    while (map->keys[pos] != INVALID_PAGE && map->keys[pos] != key) pos = (pos + 1) & mask;
+    if (map->keys[pos] == INVALID_PAGE) {
+        map->keys[pos] = key;
+        map->count++;
+    }
+    map->values[pos] = value;
+}
+
+// 삭제 후 뒤따르는 클러스터를 앞으로 당겨 tombstone 없이 탐사 체인을 유지
+void u64map_remove(U64Map *map, unsigned long long key) {
+    unsigned long long mask = map->capacity - 1;
+    unsigned long long pos = u64map_slot(key, map->capacity);
+    while (map->keys[pos] != key) {
+        if (map->keys[pos] == INVALID_PAGE) return;
+        pos = (pos + 1) & mask;
+    }
+    unsigned long long hole = pos;
+    for (unsigned long long next = (hole + 1) & mask; map->keys[next] != INVALID_PAGE; next = (next + 1) & mask) {
+        unsigned long long home = u64map_slot(map->keys[next], map->capacity);
+        // next 의 원래 위치가 (hole, next] 구간 밖이면 hole 로 옮길 수 있음
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            map->keys[hole] = map->keys[next];
+            map->values[hole] = map->values[next];
+            hole = next;
+        }
+    }
+    map->keys[hole] = INVALID_PAGE;
+    map->count--;
+}
+
+// --- 로그 구조 쓰기 계층 ---
+
+int lsl_init(unsigned long long logical_zones, unsigned long long spare_zones, unsigned long long gc_threshold) {
+    lsl_free();
+    if (zone_size_pages_global == 0 || spare_zones == 0 || gc_threshold == 0 || gc_threshold >= spare_zones) return -1;
+    lsl.logical_zones = logical_zones;
+    lsl.total_zones = logical_zones + spare_zones;
+    lsl.gc_threshold = gc_threshold;
+    lsl.valid_pages = (unsigned int*)malloc(lsl.total_zones * sizeof(unsigned int));
+    lsl.home_intact = (unsigned char*)calloc(lsl.total_zones, 1);
+    lsl.free_zones = (unsigned long long*)malloc(lsl.total_zones * sizeof(unsigned long long));
+    lsl.gc_heap = (unsigned long long*)malloc(lsl.total_zones * sizeof(unsigned long long));
+    lsl.gc_pos = (unsigned long long*)malloc(lsl.total_zones * sizeof(unsigned long long));
+    if (lsl.valid_pages == NULL || lsl.home_intact == NULL || lsl.free_zones == NULL || lsl.gc_heap == NULL || lsl.gc_pos == NULL ||
+        u64map_init(&lsl.lba_to_phys, 1024) != 0 || u64map_init(&lsl.phys_to_lba, 1024) != 0) {
+        lsl_free();
+        return -1;
+    }
+    // 논리 Zone은 홈 데이터로 가득 찬 상태 (모두 같은 유효 페이지 수이므로 번호 순서 그대로 힙), 예비 Zone은 비어 있는 상태로 시작
+    for (unsigned long long z = 0; z < lsl.total_zones; z++) {
+        lsl.valid_pages[z] = (z < logical_zones) ? (unsigned int)zone_size_pages_global : 0;
+        lsl.home_intact[z] = (z < logical_zones);
+        lsl.gc_pos[z] = (z < logical_zones) ? z : INVALID_ZONE;
+        if (z < logical_zones) lsl.gc_heap[z] = z;
+    }
+    lsl.gc_heap_size = logical_zones;
+    lsl.free_head = 0;
+    lsl.free_count = 0;
+    for (unsigned long long z = logical_zones; z < lsl.total_zones; z++) lsl.free_zones[lsl.free_count++] = z;
+    lsl.active_zone = INVALID_ZONE;
+    lsl.enabled = 1;
+    return 0;
+}
+
+void lsl_free() {
+    u64map_free(&lsl.lba_to_phys);
+    u64map_free(&lsl.phys_to_lba);
+    free(lsl.valid_pages);
+    free(lsl.home_intact);
+    free(lsl.free_zones);
+    free(lsl.gc_heap);
+    free(lsl.gc_pos);
+    memset(&lsl, 0, sizeof(lsl));
+}
+
+static int lsl_in_range(unsigned long long page_id) {
+    return page_id / zone_size_pages_global < lsl.logical_zones;
+}
+
+// LBA 페이지의 현재 물리 위치
+unsigned long long lsl_translate(unsigned long long page_id) {
+    if (!lsl.enabled) return page_id;
+    unsigned long long phys = u64map_get(&lsl.lba_to_phys, page_id);
+    return (phys == INVALID_PAGE) ? page_id : phys;
+}
+
+// GC 후보 힙: 유효 페이지가 가장 적은 Zone (같으면 번호가 작은 Zone) 이 맨 위
+static int lsl_gc_less(unsigned long long a, unsigned long long b) {
+    if (lsl.valid_pages[a] != lsl.valid_pages[b]) return lsl.valid_pages[a] < lsl.valid_pages[b];
+    return a < b;
+}
+
+static void lsl_gc_place(unsigned long long pos, unsigned long long zone) {
+    lsl.gc_heap[pos] = zone;
+    lsl.gc_pos[zone] = pos;
+}
+
+// 힙 위치 pos 의 Zone 을 제자리로 (키가 줄었으면 위로, 늘었으면 아래로)
+static void lsl_gc_fix(unsigned long long pos) {
+    unsigned long long zone = lsl.gc_heap[pos];
+    while (pos > 0 && lsl_gc_less(zone, lsl.gc_heap[(pos - 1) / 2])) {
+        lsl_gc_place(pos, lsl.gc_heap[(pos - 1) / 2]);
+        pos = (pos - 1) / 2;
+    }
+    for (;;) {
+        unsigned long long child = pos * 2 + 1;
+        if (child >= lsl.gc_heap_size) break;
+        if (child + 1 < lsl.gc_heap_size && lsl_gc_less(lsl.gc_heap[child + 1], lsl.gc_heap[child])) child++;
+        if (!lsl_gc_less(lsl.gc_heap[child], zone)) break;
+        lsl_gc_place(pos, lsl.gc_heap[child]);
+        pos = child;
+    }
+    lsl_gc_place(pos, zone);
+}
+
+static void lsl_gc_push(unsigned long long zone) {
+    if (lsl.gc_pos[zone] != INVALID_ZONE) return;
+    lsl_gc_place(lsl.gc_heap_size++, zone);
+    lsl_gc_fix(lsl.gc_pos[zone]);
+}
+
+static void lsl_gc_remove(unsigned long long zone) {
+    unsigned long long pos = lsl.gc_pos[zone];
+    if (pos == INVALID_ZONE) return;
+    lsl.gc_pos[zone] = INVALID_ZONE;
+    if (pos == --lsl.gc_heap_size) return;
+    lsl_gc_place(pos, lsl.gc_heap[lsl.gc_heap_size]);
+    lsl_gc_fix(pos);
+}
+
+static void lsl_invalidate(unsigned long long phys) {
+    unsigned long long zone = phys / zone_size_pages_global;
+    if (lsl.valid_pages[zone] > 0) {
+        lsl.valid_pages[zone]--;
+        if (lsl.gc_pos[zone] != INVALID_ZONE) lsl_gc_fix(lsl.gc_pos[zone]);
+    }
+    u64map_remove(&lsl.phys_to_lba, phys);
+}
+
+static unsigned long long lsl_pop_free_zone() {
+    if (lsl.free_count == 0) return INVALID_ZONE;
+    unsigned long long zone = lsl.free_zones[lsl.free_head];
+    lsl.free_head = (lsl.free_head + 1) % lsl.total_zones;
+    lsl.free_count--;
+    return zone;
+}
+
+static void lsl_push_free_zone(unsigned long long zone) {
+    lsl.free_zones[(lsl.free_head + lsl.free_count) % lsl.total_zones] = zone;
+    lsl.free_count++;
+}
+
+static void lsl_collect_garbage();
+
+// 활성 Zone 쓰기 포인터에 한 페이지를 덧붙이고 물리 위치를 반환
+static unsigned long long lsl_append(unsigned long long page_id) {
+    ZoneEntry *z = (lsl.active_zone != INVALID_ZONE) ? zns_get_zone(lsl.active_zone, 1) : NULL;
+    if ((z == NULL || z->state == ZONE_FULL) && !lsl.in_gc && lsl.free_count <= lsl.gc_threshold) {
+        lsl_collect_garbage(); // GC 복사로 새 활성 Zone 이 열렸을 수 있음
+        z = (lsl.active_zone != INVALID_ZONE) ? zns_get_zone(lsl.active_zone, 1) : NULL;
+    }
+    if (z == NULL || z->state == ZONE_FULL) {
+        if (z != NULL) lsl_gc_push(lsl.active_zone); // 다 쓴 활성 Zone 은 이제 GC 후보
+        lsl.active_zone = lsl_pop_free_zone();
+        if (lsl.active_zone == INVALID_ZONE) return INVALID_PAGE;
+        if (zns_open_zone(lsl.active_zone) != 0) {
+            // --zns-max-open/--zns-max-active: 명시적으로 열린 Zone 만 남아 자원을 확보하지 못함. Zone 은 여유 목록으로 돌려놓는다
+            fprintf(stderr, "LSL Error: Cannot open Zone %llu within the open/active zone limits.\n", lsl.active_zone);
+            lsl_push_free_zone(lsl.active_zone);
+            lsl.active_zone = INVALID_ZONE;
+            return INVALID_PAGE;
+        }
+        z = zns_get_zone(lsl.active_zone, 1);
+    }
+    unsigned long long phys = z->write_pointer;
+    write_fio_log(phys * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_WRITE); // WP 에 쓰므로 항상 순차
+
+    unsigned long long old_phys = lsl_translate(page_id);
+    if (old_phys != phys) lsl_invalidate(old_phys);
+    u64map_put(&lsl.lba_to_phys, page_id, phys);
+    u64map_put(&lsl.phys_to_lba, phys, page_id);
+    lsl.valid_pages[phys / zone_size_pages_global]++;
+    return phys;
+}
+
+// 유효 페이지가 가장 적은 Zone을 골라 유효 페이지를 복사한 뒤 reset.
+// 후보 (홈 데이터 Zone, 다 써서 교체된 로그 Zone) 는 lsl.gc_heap 에 있으므로 힙 맨 위만 본다
+static void lsl_collect_garbage() {
+    unsigned long long victim = (lsl.gc_heap_size > 0) ? lsl.gc_heap[0] : INVALID_ZONE;
+    if (victim != INVALID_ZONE && lsl.valid_pages[victim] >= zone_size_pages_global) victim = INVALID_ZONE; // 무효 페이지 없음
+    if (victim == INVALID_ZONE) {
+        fprintf(stderr, "LSL Warning: No zone with invalid pages to collect (free zones: %llu).\n", lsl.free_count);
+        return;
+    }
+
+    lsl.in_gc = 1;
+    lsl.gc_runs[current_policy]++;
+    unsigned long long start = victim * zone_size_pages_global;
+    for (unsigned long long phys = start; phys < start + zone_size_pages_global && lsl.valid_pages[victim] > 0; phys++) {
+        unsigned long long page_id = u64map_get(&lsl.phys_to_lba, phys);
+        if (page_id == INVALID_PAGE) {
+            // 홈 데이터: 해당 LBA 가 다른 곳으로 재배치되지 않았다면 유효
+            if (!lsl.home_intact[victim] || u64map_get(&lsl.lba_to_phys, phys) != INVALID_PAGE) continue;
+            page_id = phys;
+        }
+        write_fio_log(phys * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_READ);
+        if (lsl_append(page_id) == INVALID_PAGE) {
+            fprintf(stderr, "LSL Error: No writable zone while collecting Zone %llu. Zone left intact.\n", victim);
+            lsl.in_gc = 0;
+            return;
+        }
+        lsl.gc_copies[current_policy]++;
+    }
+    lsl_gc_remove(victim);
+    lsl.home_intact[victim] = 0;
+    lsl.valid_pages[victim] = 0;
+    zns_reset_zone(victim);
+    lsl_push_free_zone(victim);
+    lsl.in_gc = 0;
+}
+
+// 더티 페이지 write-back (handle_dirty_eviction 에서 호출)
+void lsl_write_page(unsigned long long page_id) {
+    if (!lsl_in_range(page_id)) {
+        if (!lsl.out_of_range_warned) {
+            fprintf(stderr, "LSL Warning: Page %llu is beyond %llu logical zones. Writing in place (counted in the summary).\n", page_id, lsl.logical_zones);
+            lsl.out_of_range_warned = 1;
+        }
+        lsl.out_of_range_writes++;
+        write_fio_log(page_id * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_WRITE);
+        return;
+    }
+    lsl.host_writes[current_policy]++;
+    if (lsl_append(page_id) == INVALID_PAGE) {
+        fprintf(stderr, "LSL Error: No writable zone. Writing page %llu in place.\n", page_id);
+        write_fio_log(page_id * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_WRITE);
+    }
+}
+
+// 캐시 미스 시 디스크 읽기 (로그 구조 계층 활성 시 매핑을 따라 리다이렉트)
+void read_page_from_device(unsigned long long page_id) {
+    unsigned long long phys = lsl_translate(page_id);
+    if (phys != page_id) lsl.redirected_reads++;
+    write_fio_log(phys * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_READ);
+}
+
+// 연속된 여러 페이지 읽기: 물리적으로 연속된 구간마다 하나의 읽기 I/O 로 기록
+void read_pages_from_device(unsigned long long first_page_id, unsigned long long num_pages) {
+    unsigned long long run_start = INVALID_PAGE, run_len = 0;
+    for (unsigned long long i = 0; i < num_pages; i++) {
+        unsigned long long phys = lsl_translate(first_page_id + i);
+        if (phys != first_page_id + i) lsl.redirected_reads++;
+        if (run_len > 0 && phys == run_start + run_len && (run_len + 1) * SECTORS_PER_PAGE <= UINT_MAX) {
+            run_len++;
+            continue;
+        }
+        if (run_len > 0) write_fio_log(run_start * SECTORS_PER_PAGE, (unsigned int)(run_len * SECTORS_PER_PAGE), OP_READ);
+        run_start = phys;
+        run_len = 1;
+    }
+    if (run_len > 0) write_fio_log(run_start * SECTORS_PER_PAGE, (unsigned int)(run_len * SECTORS_PER_PAGE), OP_READ);
+}
+
+// FIO 로그 작성 함수 (ZNS 순차 쓰기 제약 검사 및 적용)
+void write_fio_log(unsigned long long start_lba, unsigned int num_sectors, int operation_type) {
+    if (log_file == NULL || SECTOR_SIZE <= 0 || num_sectors == 0) return;
+    PROF_BEGIN(PROF_LOG);
+
+    unsigned long long offset_bytes = start_lba * SECTOR_SIZE;
+    unsigned long long length_bytes_ull = (unsigned long long)num_sectors * SECTOR_SIZE;
+    unsigned int length_bytes = (length_bytes_ull > UINT_MAX) ? UINT_MAX : (unsigned int)length_bytes_ull;
+    if (length_bytes_ull > UINT_MAX) fprintf(stderr, "Warning: I/O length overflow LBA %llu.\n", start_lba);
+
+    // ZNS 순차 쓰기 제약 검사 및 Zone 상태 전이 (쓰기 작업이고, Zone 크기가 설정된 경우)
+    if (operation_type == OP_WRITE && zone_size_pages_global > 0) {
+        // num_pages 계산 (올림 처리)
+        unsigned int num_pages = (num_sectors + SECTORS_PER_PAGE - 1) / SECTORS_PER_PAGE;
+        if (num_pages == 0 && num_sectors > 0) num_pages = 1; // 최소 1 페이지
+        // 위반 시 실제 ZNS에서는 쓰기가 실패해야 하지만, 시뮬레이션에서는 로그는 남김
+        zns_write(lba_to_page_id(start_lba), num_pages);
+    }
+
+    // FIO 로그 기록 (순차성 위반 여부와 관계없이 기록 - 시뮬레이션 흐름 유지)
+    fio_log_submit(offset_bytes, length_bytes, operation_type);
+    device_submit(operation_type, length_bytes);
+    PROF_END();
+}
+
+
+// 페이지 write-back (write_fio_log 내부에서 ZNS 순차 쓰기 제약 검사 및 WP 업데이트 수행)
+// 로그 구조 계층 활성 시 홈 LBA 대신 활성 Zone 쓰기 포인터에 덧붙임
+void write_back_page(unsigned long long page_id) {
+    if (lsl.enabled) lsl_write_page(page_id);
+    else write_fio_log(page_id * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_WRITE);
+}
+
+// 더티 페이지 처리 함수 (write_fio_log 호출 시 ZNS 제약 검사 수행됨)
+void handle_dirty_eviction(int victim_idx) {
+    if (victim_idx < 0 || victim_idx >= buffer_size) return;
+    if (buffer[victim_idx].page_id != INVALID_PAGE && buffer[victim_idx].is_dirty) {
+        write_back_page(buffer[victim_idx].page_id);
+        buffer[victim_idx].is_dirty = 0; // 쓰기 시도 후 dirty 플래그 해제
+        dirty_pages--;
+    }
+}
+
+// --- 백그라운드 flusher ---
+
+int flusher_init(int high_pct, int low_pct, int batch_size, FlushOrder order) {
+    flusher_free();
+    if (high_pct <= 0 || high_pct > 100 || low_pct < 0 || low_pct >= high_pct || batch_size <= 0) return -1;
+    flusher.scratch = (int*)malloc(MAX_BUFFER_SIZE * sizeof(int));
+    if (flusher.scratch == NULL) return -1;
+    flusher.high_mark = MAX(1, (int)((long long)buffer_size * high_pct / 100));
+    flusher.low_mark = (int)((long long)buffer_size * low_pct / 100);
+    flusher.batch_size = batch_size;
+    flusher.order = (order == FLUSH_ORDER_ZONE && zone_size_pages_global > 0) ? FLUSH_ORDER_ZONE : FLUSH_ORDER_LBA;
+    flusher.enabled = 1;
+    return 0;
+}
+
+void flusher_free() {
+    free(flusher.scratch);
+    memset(&flusher, 0, sizeof(flusher));
+}
+
+static int compare_frames_by_page_id(const void *a, const void *b) {
+    unsigned long long pa = buffer[*(const int*)a].page_id;
+    unsigned long long pb = buffer[*(const int*)b].page_id;
+    return (pa > pb) - (pa < pb);
+}
+
+static void flusher_write_frame(int frame_idx) {
+    write_back_page(buffer[frame_idx].page_id);
+    buffer[frame_idx].is_dirty = 0;
+    dirty_pages--;
+    flusher.pages++;
+}
+
+// 더티 프레임을 LBA 순으로 정렬한 뒤, 정해진 순서로 batch 를 골라 low_mark 까지 write-back
+void flusher_maybe_run() {
+    if (!flusher.enabled || dirty_pages < flusher.high_mark) return;
+    flusher.runs++;
+    device.async_depth++; // flush I/O 는 요청을 기다리게 하지 않음
+
+    int n = 0;
+    for (int i = 0; i < buffer_size; i++) {
+        if (buffer[i].page_id != INVALID_PAGE && buffer[i].is_dirty) flusher.scratch[n++] = i;
+    }
+    qsort(flusher.scratch, n, sizeof(int), compare_frames_by_page_id);
+
+    if (flusher.order == FLUSH_ORDER_LBA) {
+        // 커서 위치부터 시작해 끝에 도달하면 처음으로 돌아감
+        int start = 0;
+        while (start < n && buffer[flusher.scratch[start]].page_id < flusher.lba_cursor) start++;
+        int done = 0;
+        while (dirty_pages > flusher.low_mark && done < n) {
+            int in_batch = 0;
+            while (in_batch < flusher.batch_size && done < n) {
+                int frame_idx = flusher.scratch[(start + done) % n];
+                flusher_write_frame(frame_idx);
+                flusher.lba_cursor = buffer[frame_idx].page_id + 1;
+                in_batch++;
+                done++;
+            }
+            flusher.batches++;
+        }
+    } else {
+        // Zone 별 구간으로 묶고, 남은 더티 페이지가 가장 많은 Zone 부터 batch 단위로 처리
+        while (dirty_pages > flusher.low_mark && n > 0) {
+            int best_start = 0, best_len = 0;
+            for (int i = 0; i < n; ) {
+                unsigned long long zone = buffer[flusher.scratch[i]].page_id / zone_size_pages_global;
+                int j = i + 1;
+                while (j < n && buffer[flusher.scratch[j]].page_id / zone_size_pages_global == zone) j++;
+                if (j - i > best_len) { best_start = i; best_len = j - i; }
+                i = j;
+            }
+            int take = MIN(best_len, flusher.batch_size);
+            for (int k = 0; k < take; k++) flusher_write_frame(flusher.scratch[best_start + k]);
+            memmove(&flusher.scratch[best_start], &flusher.scratch[best_start + take], (n - best_start - take) * sizeof(int));
+            n -= take;
+            flusher.batches++;
+        }
+    }
+    device.async_depth--;
+}
+
+// --- ZNS 비용 인지 희생자 선택 ---
+
+// 페이지를 지금 write-back 하면 홈 Zone 의 쓰기 포인터에 맞는 순차 쓰기인지.
+// 로그 구조 계층은 항상 활성 Zone 에 덧붙이므로 여기서는 다루지 않는다 (ZNS 비활성과 같이 0)
+static int writeback_is_sequential(unsigned long long page_id) {
+    if (zone_size_pages_global == 0 || lsl.enabled) return 0;
+    unsigned long long zone_id = page_id / zone_size_pages_global;
+    ZoneEntry *z = zns_get_zone(zone_id, 0);
+    if (z == NULL) return page_id == zone_id * zone_size_pages_global;
+    return z->state != ZONE_FULL && page_id == z->write_pointer;
+}
+
+static int zns_victim_cost(int frame_idx) {
+    if (!buffer[frame_idx].is_dirty) return 0;
+    return writeback_is_sequential(buffer[frame_idx].page_id) ? 1 : zns_cost.penalty;
+}
+
+// cand[0..n-1] 은 정책의 교체 순서 (cand[0] 이 원래 희생자). 순위 + 비용이 가장 작은 후보의 위치, 동률이면 앞선 후보
+static int zns_cost_choose(const int *cand, int n) {
+    int best = 0, best_cost = zns_victim_cost(cand[0]);
+    for (int j = 1; j < n && j < best_cost; j++) {
+        int cost = j + zns_victim_cost(cand[j]);
+        if (cost < best_cost) { best = j; best_cost = cost; }
+    }
+    if (best > 0) {
+        zns_cost.picks++;
+        if (buffer[cand[best]].is_dirty) zns_cost.picked_seq++; else zns_cost.picked_clean++;
+    }
+    return best;
+}
+
+// --- 청결 희생자 선호 ---
+// 정책 순서상 가장 앞선 (clean_victim_window + 1)개 후보 중 첫 clean 프레임을 고른다.
+// 후보가 모두 더티면 원래 정책의 희생자를 고른다. --zns-cost 이면 같은 후보 창에서 zns_cost_choose 로 고른다.
+typedef enum {
+    VICTIM_KEY_LOAD_TIME,    // FIFO
+    VICTIM_KEY_ACCESS_TIME,  // LRU
+    VICTIM_KEY_FREQUENCY     // LFU (동률이면 load_time)
+} VictimKey;
+
+static int pick_victim_preferring_clean(int list_type_filter, VictimKey key) {
+    int cand[FLUSH_MAX_CLEAN_WINDOW + 1];
+    unsigned long long cand_k1[FLUSH_MAX_CLEAN_WINDOW + 1], cand_k2[FLUSH_MAX_CLEAN_WINDOW + 1];
+    int limit = MIN(zns_cost.window > 0 ? zns_cost.window : clean_victim_window, FLUSH_MAX_CLEAN_WINDOW) + 1;
+    int n = 0;
+
+    FOR_EACH_CANDIDATE_FRAME(i, list_type_filter) {
+        unsigned long long k1, k2 = 0;
+        if (key == VICTIM_KEY_LOAD_TIME) k1 = buffer[i].load_time;
+        else if (key == VICTIM_KEY_ACCESS_TIME) k1 = buffer[i].last_access_time;
+        else { k1 = buffer[i].access_count; k2 = buffer[i].load_time; }
+
+        // 동일 키는 먼저 스캔된 프레임이 앞서도록 삽입 (기존 선택 결과와 동일한 순서)
+        int pos = n;
+        while (pos > 0 && (k1 < cand_k1[pos - 1] || (k1 == cand_k1[pos - 1] && k2 < cand_k2[pos - 1]))) pos--;
+        if (pos >= limit) continue;
+        int last = (n < limit) ? n : limit - 1;
+        for (int j = last; j > pos; j--) {
+            cand[j] = cand[j - 1]; cand_k1[j] = cand_k1[j - 1]; cand_k2[j] = cand_k2[j - 1];
+        }
+        cand[pos] = i; cand_k1[pos] = k1; cand_k2[pos] = k2;
+        if (n < limit) n++;
+    }
+    if (zns_cost.window > 0) return (n > 0) ? cand[zns_cost_choose(cand, n)] : -1;
+    for (int j = 0; j < n; j++) {
+        if (!buffer[cand[j]].is_dirty) {
+            if (j > 0) clean_victim_picks++;
+            return cand[j];
+        }
+    }
+    return (n > 0) ? cand[0] : -1;
+}
+
+int evict_fifo() {
+    if (buffer_size == 0) return -1;
+    if (clean_victim_window > 0 || zns_cost.window > 0) {
+        int clean_idx = pick_victim_preferring_clean(-1, VICTIM_KEY_LOAD_TIME);
+        if (clean_idx != -1) return clean_idx;
+    }
+    int victim_idx = -1;
+    unsigned long long min_load_time = ULLONG_MAX;
+    FOR_EACH_CANDIDATE_FRAME(i, -1) {
+        if (buffer[i].load_time < min_load_time) {
+            min_load_time = buffer[i].load_time;
+            victim_idx = i;
+        }
+    }
+    if (victim_idx == -1 && find_empty_slot() == -1 && buffer_size > 0) {
+        victim_idx = 0;
+    }
+    return victim_idx;
+}
+
+void arc_remove_from_ghost(unsigned long long page_id, unsigned long long* list, int* list_size) {
+    PROF_BEGIN(PROF_GHOST);
     int found_idx = -1;
     for (int i = 0; i < *list_size; i++) {
         if (list[i] == page_id) {
@@ -340,10 +2332,12 @@ void arc_remove_from_ghost(unsigned long long page_id, unsigned long long* list,
         list[*list_size - 1] = INVALID_PAGE;
         (*list_size)--;
     }
+    PROF_END();
 }
 
 void arc_add_to_ghost_mru(unsigned long long page_id, unsigned long long* list, int* list_size, int max_ghost_size) {
     if (page_id == INVALID_PAGE || max_ghost_size <= 0) return;
+    PROF_BEGIN(PROF_GHOST);
 
     int existing_idx = -1;
     for (int i = 0; i < *list_size; i++) {
@@ -368,89 +2362,128 @@ void arc_add_to_ghost_mru(unsigned long long page_id, unsigned long long* list,
         }
         list[max_ghost_size - 1] = page_id;
     }
+    PROF_END();
 }
 
 
 int find_in_arc_ghost(unsigned long long page_id, const unsigned long long* list, int list_size) {
+    PROF_BEGIN(PROF_GHOST);
+    int found = 0;
     for (int i = 0; i < list_size; i++) {
-        if (list[i] == page_id) return 1;
+        if (list[i] == page_id) { found = 1; break; }
     }
-    return 0;
+    PROF_END();
+    return found;
 }
 
 int evict_arc_internal_lru(int target_list_type_val) {
+    if (clean_victim_window > 0 || zns_cost.window > 0) return pick_victim_preferring_clean(target_list_type_val, VICTIM_KEY_ACCESS_TIME);
     int victim_idx = -1;
     unsigned long long min_access_time = ULLONG_MAX;
-    for(int i = 0; i < buffer_size; ++i) {
-        if (buffer[i].page_id != INVALID_PAGE && buffer[i].list_type == target_list_type_val) {
-             if (buffer[i].last_access_time < min_access_time) {
-                 min_access_time = buffer[i].last_access_time;
-                 victim_idx = i;
-             }
+    FOR_EACH_CANDIDATE_FRAME(i, target_list_type_val) {
+        if (buffer[i].last_access_time < min_access_time) {
+            min_access_time = buffer[i].last_access_time;
+            victim_idx = i;
         }
     }
     return victim_idx;
 }
 
 int evict_arc_internal_lfu(int target_list_type_val) {
+    if (clean_victim_window > 0 || zns_cost.window > 0) return pick_victim_preferring_clean(target_list_type_val, VICTIM_KEY_FREQUENCY);
     int victim_idx = -1;
     unsigned int min_access_count = UINT_MAX;
     unsigned long long oldest_load_time = ULLONG_MAX;
-    for(int i = 0; i < buffer_size; ++i) {
-        if (buffer[i].page_id != INVALID_PAGE && buffer[i].list_type == target_list_type_val) {
-            if (buffer[i].access_count < min_access_count) {
-                min_access_count = buffer[i].access_count;
+    FOR_EACH_CANDIDATE_FRAME(i, target_list_type_val) {
+        if (buffer[i].access_count < min_access_count) {
+            min_access_count = buffer[i].access_count;
+            oldest_load_time = buffer[i].load_time;
+            victim_idx = i;
+        } else if (buffer[i].access_count == min_access_count) {
+            if (buffer[i].load_time < oldest_load_time) {
                 oldest_load_time = buffer[i].load_time;
                 victim_idx = i;
-            } else if (buffer[i].access_count == min_access_count) {
-                if (buffer[i].load_time < oldest_load_time) {
-                    oldest_load_time = buffer[i].load_time;
-                    victim_idx = i;
-                }
             }
         }
     }
     return victim_idx;
 }
 
-int evict_via_clock_policy(int *hand_ptr, int list_type_filter_active, int target_list_type, BufferFrame* buffer_frames, int current_buffer_size, const char* policy_name_for_log) {
-    if (current_buffer_size == 0) return -1;
+// CLOCK 스윕의 [lo, hi) 구간을 64 프레임 word 단위로 훑는다.
+// 후보(유효 + 리스트 필터) 중 참조 비트 0 인 첫 프레임을 돌려주고, pass 0 이면 그 앞에서 지나친 참조 비트를 한 번에 지운다.
+// 청결 희생자 선호로 건너뛴 첫 더티 프레임은 *first_dirty 에 남긴다 (윈도우를 다 못 채우고 스윕이 끝나면 그 프레임을 교체)
+static int clock_sweep_range(int lo, int hi, int pass, int target_list_type, int *dirty_skipped, int *first_dirty) {
+    for (int w = lo >> 6; w <= (hi - 1) >> 6; w++) {
+        unsigned long long mask = ~0ULL;
+        if (w == lo >> 6) mask &= ~0ULL << (lo & 63);
+        if (w == (hi - 1) >> 6 && (hi & 63)) mask &= (1ULL << (hi & 63)) - 1;
+        unsigned long long eligible = frame_candidates(w, target_list_type) & mask;
+        for (unsigned long long cand = eligible & ~frame_hot.ref[w]; cand; cand &= cand - 1) {
+            int bit = __builtin_ctzll(cand);
+            int idx = (w << 6) + bit;
+            if (buffer[idx].is_dirty && *dirty_skipped < clean_victim_window) {
+                if (*first_dirty == -1) *first_dirty = idx;
+                (*dirty_skipped)++;
+                continue;
+            }
+            if (pass == 0) frame_hot.ref[w] &= ~(eligible & ((1ULL << bit) - 1));
+            return idx;
+        }
+        if (pass == 0) frame_hot.ref[w] &= ~eligible;
+    }
+    return -1;
+}
 
-    int initial_hand = *hand_ptr;
-    int first_pass_victim = -1;
+// --zns-cost: 바늘이 victim 다음으로 만날 참조 비트 0 후보를 (비트를 지우지 않고) window 개까지 모아 비용으로 고른다
+static int clock_cost_pick(int victim, int target_list_type, int n_frames) {
+    int cand[FLUSH_MAX_CLEAN_WINDOW + 1], n = 0;
+    cand[n++] = victim;
+    int pos = victim + 1, scanned = 0;
+    while (n <= zns_cost.window && scanned < n_frames - 1) {
+        if (pos >= n_frames) pos = 0;
+        int w = pos >> 6;
+        int span = MIN(MIN((w + 1) << 6, n_frames) - pos, n_frames - 1 - scanned);
+        unsigned long long mask = (span >= 64 ? ~0ULL : (1ULL << span) - 1) << (pos & 63);
+        for (unsigned long long m = frame_candidates(w, target_list_type) & ~frame_hot.ref[w] & mask; m && n <= zns_cost.window; m &= m - 1)
+            cand[n++] = (w << 6) + __builtin_ctzll(m);
+        pos += span;
+        scanned += span;
+    }
+    return cand[zns_cost_choose(cand, n)];
+}
 
-    for (int pass = 0; pass < 2; ++pass) {
-        for (int i = 0; i < current_buffer_size; ++i) {
-            int current_idx = (*hand_ptr + i) % current_buffer_size;
+int evict_via_clock_policy(int *hand_ptr, int list_type_filter_active, int target_list_type, int current_buffer_size, const char* policy_name_for_log) {
+    if (current_buffer_size == 0) return -1;
 
-            if (buffer_frames[current_idx].page_id != INVALID_PAGE) {
-                if (list_type_filter_active && buffer_frames[current_idx].list_type != target_list_type) {
-                    continue;
-                }
+    int initial_hand = *hand_ptr % current_buffer_size;
+    int list_filter = list_type_filter_active ? target_list_type : -1;
+    int dirty_skipped = 0; // 청결 희생자 선호: 참조 비트가 0인 더티 프레임을 건너뛴 수
+    int first_dirty = -1;  // 그중 처음 만난 프레임 (두 바퀴에 청결 후보가 없으면 교체)
 
-                if (buffer_frames[current_idx].ref_bit == 0) {
-                    *hand_ptr = (current_idx + 1) % current_buffer_size;
-                    return current_idx;
-                } else {
-                    if (pass == 0) {
-                        buffer_frames[current_idx].ref_bit = 0;
-                        if (first_pass_victim == -1) {
-                            first_pass_victim = current_idx;
-                        }
-                    }
-                }
+    for (int pass = 0; pass < 2; ++pass) {
+        int victim = clock_sweep_range(initial_hand, current_buffer_size, pass, list_filter, &dirty_skipped, &first_dirty);
+        if (victim == -1 && initial_hand > 0) victim = clock_sweep_range(0, initial_hand, pass, list_filter, &dirty_skipped, &first_dirty);
+        if (victim == -1 && pass == 1) victim = first_dirty; // 더티 후보가 윈도우보다 적음: pick_victim_preferring_clean 처럼 첫 후보
+        if (victim != -1) {
+            if (dirty_skipped > 0 && !buffer[victim].is_dirty) clean_victim_picks++;
+            *hand_ptr = (victim + 1) % current_buffer_size;
+            if (zns_cost.window > 0) {
+                // 청결 희생자 선호와 같이 바늘은 고른 프레임 다음으로 (건너뛴 후보는 참조 비트 0 으로 다음 바퀴에)
+                victim = clock_cost_pick(victim, list_filter, current_buffer_size);
+                *hand_ptr = (victim + 1) % current_buffer_size;
             }
+            return victim;
         }
     }
 
     for (int i = 0; i < current_buffer_size; ++i) {
         int check_idx = (initial_hand + i) % current_buffer_size;
-        if (buffer_frames[check_idx].page_id != INVALID_PAGE) {
-            if (list_type_filter_active && buffer_frames[check_idx].list_type != target_list_type) {
+        if (frame_is_candidate(check_idx)) {
+            if (list_type_filter_active && frame_list(check_idx) != target_list_type) {
                 continue;
             }
             *hand_ptr = (check_idx + 1) % current_buffer_size;
-            fprintf(stderr, "CLOCK Warning (%s): Force evicting page %llu at index %d after full scans (fallback).\n", policy_name_for_log, buffer_frames[check_idx].page_id, check_idx);
+            fprintf(stderr, "CLOCK Warning (%s): Force evicting page %llu at index %d after full scans (fallback).\n", policy_name_for_log, buffer[check_idx].page_id, check_idx);
             return check_idx;
         }
     }
@@ -460,6 +2493,731 @@ int evict_via_clock_policy(int *hand_ptr, int list_type_filter_active, int targe
 }
 
 
+// --- CLOCK-Pro ---
+// Jiang et al. "CLOCK-Pro: An Effective Improvement of the CLOCK Replacement" (USENIX ATC 2005).
+// 히트는 참조 비트만 세우고, 바늘은 미스에서만 움직인다. 각 바늘은 노드를 한 번 지날 때마다 상태를 확정하므로
+// 미스당 이동 거리는 분할 상환 O(1).
+
+void clockpro_reset() {
+    if (clockpro_nonres.keys == NULL) {
+        if (u64map_init(&clockpro_nonres, (unsigned long long)MAX(buffer_size, 1) * 2) != 0) {
+            fprintf(stderr, "Error: Failed to allocate CLOCK-Pro index.\n");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        for (unsigned long long i = 0; i < clockpro_nonres.capacity; i++) clockpro_nonres.keys[i] = INVALID_PAGE;
+        clockpro_nonres.count = 0;
+    }
+    clockpro.free_count = 0;
+    clockpro.nonres_used = 0;
+    clockpro.hand_hot = clockpro.hand_cold = clockpro.hand_test = -1;
+    clockpro.cold_target = MAX(1, buffer_size / 100);
+    clockpro.hot_count = clockpro.cold_count = clockpro.nonres_count = 0;
+}
+
+// 리스트 머리 (HANDhot 바로 뒤) 에 노드 삽입
+static void clockpro_insert_head(int node) {
+    if (clockpro.hand_hot == -1) {
+        clockpro.next[node] = clockpro.prev[node] = node;
+        clockpro.hand_hot = clockpro.hand_cold = clockpro.hand_test = node;
+        return;
+    }
+    int after = clockpro.hand_hot, before = clockpro.prev[after];
+    clockpro.prev[node] = before; clockpro.next[node] = after;
+    clockpro.next[before] = node; clockpro.prev[after] = node;
+}
+
+// 노드를 리스트에서 빼고, 그 노드를 가리키던 바늘은 다음 노드로 옮긴다
+static void clockpro_unlink(int node) {
+    int next = clockpro.next[node];
+    if (next == node) {
+        clockpro.hand_hot = clockpro.hand_cold = clockpro.hand_test = -1;
+        return;
+    }
+    if (clockpro.hand_hot == node) clockpro.hand_hot = next;
+    if (clockpro.hand_cold == node) clockpro.hand_cold = next;
+    if (clockpro.hand_test == node) clockpro.hand_test = next;
+    clockpro.next[clockpro.prev[node]] = next;
+    clockpro.prev[next] = clockpro.prev[node];
+}
+
+static void clockpro_move_head(int node) {
+    clockpro_unlink(node);
+    clockpro_insert_head(node);
+}
+
+static void clockpro_remove_nonres(int node) {
+    clockpro_unlink(node);
+    u64map_remove(&clockpro_nonres, clockpro.nonres_page[node]);
+    clockpro.free_nonres[clockpro.free_count++] = node;
+    clockpro.nonres_count--;
+}
+
+// 시험 기간이 재참조 없이 끝남: cold 할당 감소
+static void clockpro_end_test(int node) {
+    if (node >= MAX_BUFFER_SIZE) clockpro_remove_nonres(node);
+    else clockpro.flags[node] &= ~CLOCKPRO_TEST;
+    clockpro.cold_target = MAX(1, clockpro.cold_target - 1);
+    clockpro.test_expired++;
+}
+
+// 시험 기간 중 재참조: cold 할당 증가
+static void clockpro_note_test_hit() {
+    clockpro.cold_target = MIN(MAX(1, buffer_size - 1), clockpro.cold_target + 1);
+}
+
+// HANDhot: 참조된 hot 페이지는 비트만 지우고, 참조되지 않은 hot 페이지 하나를 cold 로 강등하면 멈춘다.
+// 지나치는 cold 페이지의 시험 기간은 종료
+static void clockpro_run_hand_hot() {
+    while (clockpro.hot_count > 0) {
+        int node = clockpro.hand_hot;
+        clockpro.hand_hot = clockpro.next[node];
+        if (clockpro.flags[node] & CLOCKPRO_HOT) {
+            if (frame_ref(node)) { set_frame_ref(node, 0); continue; }
+            clockpro.flags[node] = 0;
+            clockpro.hot_count--;
+            clockpro.cold_count++;
+            clockpro.demotions++;
+            return;
+        }
+        if (clockpro.flags[node] & CLOCKPRO_TEST) clockpro_end_test(node);
+    }
+}
+
+// HANDtest: 비상주 노드가 m 개를 넘으면 가장 오래된 시험 기간부터 종료
+static void clockpro_run_hand_test() {
+    while (clockpro.nonres_count > buffer_size) {
+        int node = clockpro.hand_test;
+        clockpro.hand_test = clockpro.next[node];
+        if (!(clockpro.flags[node] & CLOCKPRO_HOT) && (clockpro.flags[node] & CLOCKPRO_TEST)) clockpro_end_test(node);
+    }
+}
+
+static void clockpro_balance_hot() {
+    while (clockpro.hot_count > 0 && clockpro.hot_count > buffer_size - clockpro.cold_target) clockpro_run_hand_hot();
+}
+
+// HANDcold: 참조되지 않은 상주 cold 페이지를 교체 대상으로 돌려준다.
+// 참조된 cold 페이지는 시험 기간 중이면 hot 으로 승격, 아니면 시험 기간을 시작하고 리스트 머리로 옮긴다.
+// 시험 기간 중 교체된 페이지는 같은 자리에 비상주 노드로 남는다
+// --zns-cost: cold 바늘이 node 다음 window 칸 안에서 만날 교체 가능 cold 페이지 중 비용으로 고른다
+static int clockpro_cost_pick(int node) {
+    int cand[FLUSH_MAX_CLEAN_WINDOW + 1], n = 0;
+    cand[n++] = node;
+    for (int k = 0, i = clockpro.next[node]; k < zns_cost.window && i != node; k++, i = clockpro.next[i]) {
+        if (i < MAX_BUFFER_SIZE && !(clockpro.flags[i] & CLOCKPRO_HOT) && !frame_ref(i) && frame_is_candidate(i)) cand[n++] = i;
+    }
+    return cand[zns_cost_choose(cand, n)];
+}
+
+// --tenants: 제한된 프레임이 모두 hot 일 때. HANDhot 처럼 참조된 hot 페이지는 비트를 지우며 지나치고,
+// 제한 안의 참조되지 않은 hot 페이지 하나를 (시험 기간 없이) 바로 교체한다
+static int clockpro_evict_hot_candidate() {
+    long limit = 2L * (clockpro.hot_count + clockpro.cold_count + clockpro.nonres_count) + 2;
+    int node = clockpro.hand_hot;
+    for (long k = 0; k < limit && node != -1; k++, node = clockpro.next[node]) {
+        if (node >= MAX_BUFFER_SIZE || !(clockpro.flags[node] & CLOCKPRO_HOT) || !frame_is_candidate(node)) continue;
+        if (frame_ref(node)) { set_frame_ref(node, 0); continue; }
+        clockpro.flags[node] = 0;
+        clockpro.hot_count--;
+        clockpro.demotions++;
+        clockpro_unlink(node);
+        return node;
+    }
+    return -1;
+}
+
+// 제한 안에서 가장 오래전에 접근한 cold 페이지 (없으면 -1)
+static int clockpro_oldest_cold_candidate() {
+    int best = -1;
+    FOR_EACH_CANDIDATE_FRAME(i, -1) {
+        if (clockpro.flags[i] & CLOCKPRO_HOT) continue;
+        if (best == -1 || buffer[i].last_access_time < buffer[best].last_access_time) best = i;
+    }
+    return best;
+}
+
+// cold 페이지 node 를 교체: 시험 기간 중이면 같은 자리에 비상주 노드를 남긴다
+static int clockpro_evict_cold(int node) {
+    clockpro.cold_count--;
+    if (clockpro.flags[node] & CLOCKPRO_TEST) {
+        int ghost = (clockpro.free_count > 0) ? clockpro.free_nonres[--clockpro.free_count] : MAX_BUFFER_SIZE + clockpro.nonres_used++;
+        clockpro.flags[ghost] = CLOCKPRO_TEST;
+        clockpro.nonres_page[ghost] = buffer[node].page_id;
+        u64map_put(&clockpro_nonres, buffer[node].page_id, (unsigned long long)ghost);
+        clockpro.nonres_count++;
+        int prev = clockpro.prev[node], next = clockpro.next[node];
+        if (next == node) prev = next = ghost;
+        clockpro.prev[ghost] = prev; clockpro.next[ghost] = next;
+        clockpro.next[prev] = ghost; clockpro.prev[next] = ghost;
+        if (clockpro.hand_hot == node) clockpro.hand_hot = ghost;
+        if (clockpro.hand_cold == node) clockpro.hand_cold = ghost;
+        if (clockpro.hand_test == node) clockpro.hand_test = ghost;
+        clockpro_run_hand_test();
+    } else {
+        clockpro_unlink(node);
+    }
+    return node;
+}
+
+// --tenants: 제한 밖의 cold 페이지는 교체하지 않고 지나친다 (참조 비트 처리는 그대로). 바늘이
+// CLOCKPRO_RESTRICT_PROBE 칸 안에서 못 찾으면 제한 안의 가장 오래된 cold 페이지, 그것도 없으면 hot 페이지를 교체
+int clockpro_evict() {
+    if (clockpro.hand_cold == -1) return -1;
+    for (int steps = 0;; steps++) {
+        if (ucp.victim_bits != NULL && steps == CLOCKPRO_RESTRICT_PROBE) {
+            int oldest = clockpro_oldest_cold_candidate();
+            return (oldest != -1) ? clockpro_evict_cold(oldest) : clockpro_evict_hot_candidate();
+        }
+        if (clockpro.cold_count == 0) clockpro_run_hand_hot();
+        int node = clockpro.hand_cold;
+        clockpro.hand_cold = clockpro.next[node];
+        if (node >= MAX_BUFFER_SIZE || (clockpro.flags[node] & CLOCKPRO_HOT)) continue;
+        if (frame_ref(node)) {
+            set_frame_ref(node, 0);
+            if (clockpro.flags[node] & CLOCKPRO_TEST) {
+                clockpro.flags[node] = CLOCKPRO_HOT;
+                clockpro.cold_count--;
+                clockpro.hot_count++;
+                clockpro.promotions++;
+                clockpro_note_test_hit();
+                clockpro_move_head(node);
+                clockpro_balance_hot();
+            } else {
+                clockpro.flags[node] |= CLOCKPRO_TEST;
+                clockpro_move_head(node);
+            }
+            continue;
+        }
+        if (!frame_is_candidate(node)) continue;
+        if (zns_cost.window > 0) {
+            int chosen = clockpro_cost_pick(node);
+            if (chosen != node) { clockpro.hand_cold = node; node = chosen; } // 원래 후보가 다음 차례
+        }
+        return clockpro_evict_cold(node);
+    }
+}
+
+// 새로 적재된 프레임을 리스트 머리에 넣는다. 시험 기간 중인 비상주 페이지였다면 hot 으로 적재
+void clockpro_admit(int frame_idx, unsigned long long page_id, int is_prefetch) {
+    unsigned long long ghost = u64map_get(&clockpro_nonres, page_id);
+    if (ghost != INVALID_PAGE) clockpro_remove_nonres((int)ghost);
+    if (ghost != INVALID_PAGE && !is_prefetch) {
+        clockpro.test_refaults++;
+        clockpro_note_test_hit();
+        clockpro.flags[frame_idx] = CLOCKPRO_HOT;
+        clockpro.hot_count++;
+        clockpro_insert_head(frame_idx);
+        clockpro_balance_hot();
+    } else {
+        // 선반입 페이지는 아직 참조되지 않았으므로 시험 기간 없이 cold 로 둔다
+        clockpro.flags[frame_idx] = is_prefetch ? 0 : CLOCKPRO_TEST;
+        clockpro.cold_count++;
+        clockpro_insert_head(frame_idx);
+    }
+}
+
+// 정책 교체 이외의 이유로 비워지는 프레임 (release_frame)
+void clockpro_drop(int frame_idx) {
+    if (clockpro.flags[frame_idx] & CLOCKPRO_HOT) clockpro.hot_count--; else clockpro.cold_count--;
+    clockpro_unlink(frame_idx);
+}
+
+// TinyLFU 가 후보를 거절해 clockpro_evict 의 희생자를 다시 앉힌다: 남긴 비상주 노드를 지우고
+// cold 바늘 바로 앞 (다음에 바늘이 볼 자리) 에 원래 상태 그대로 되돌린다
+void clockpro_restore(int frame_idx, unsigned long long page_id) {
+    unsigned long long ghost = u64map_get(&clockpro_nonres, page_id);
+    if (ghost != INVALID_PAGE) clockpro_remove_nonres((int)ghost);
+    if (clockpro.hand_cold == -1) {
+        clockpro_insert_head(frame_idx);
+    } else {
+        int after = clockpro.hand_cold, before = clockpro.prev[after];
+        clockpro.prev[frame_idx] = before; clockpro.next[frame_idx] = after;
+        clockpro.next[before] = frame_idx; clockpro.prev[after] = frame_idx;
+    }
+    clockpro.hand_cold = frame_idx;
+    if (clockpro.flags[frame_idx] & CLOCKPRO_HOT) clockpro.hot_count++; else clockpro.cold_count++;
+}
+
+// 다른 정책에서 전환: 상주 페이지를 모두 시험 기간 없는 cold 페이지로 프레임 순서대로 넣는다
+void clockpro_rebuild() {
+    clockpro_reset();
+    FOR_EACH_CANDIDATE_FRAME(i, -1) {
+        clockpro.flags[i] = 0;
+        clockpro.cold_count++;
+        clockpro_insert_head(i);
+    }
+}
+
+
+// --- S3-FIFO / SIEVE ---
+// S3-FIFO: Yang et al. "FIFO queues are all you need for cache eviction" (SOSP 2023)
+// SIEVE:   Zhang et al. "SIEVE is Simpler than LRU" (NSDI 2024)
+// 두 정책 모두 히트 경로는 카운터/비트 쓰기 하나이고, 큐 조작은 미스에서만 일어난다.
+
+void fifoq_reset() {
+    if (fifoq_ghost_index.keys == NULL) {
+        if (u64map_init(&fifoq_ghost_index, (unsigned long long)MAX(buffer_size, 1) * 2) != 0) {
+            fprintf(stderr, "Error: Failed to allocate S3-FIFO ghost index.\n");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        for (unsigned long long i = 0; i < fifoq_ghost_index.capacity; i++) fifoq_ghost_index.keys[i] = INVALID_PAGE;
+        fifoq_ghost_index.count = 0;
+    }
+    for (int q = 0; q < 2; q++) { fifoq.head[q] = fifoq.tail[q] = -1; fifoq.size[q] = 0; }
+    fifoq.sieve_hand = -1;
+    fifoq.ghost_pos = fifoq.ghost_count = 0;
+    tchain_reset(&fifoq_chain);
+}
+
+// 큐 q 의 after 뒤(꼬리 쪽)에 넣는다. after 가 -1 이면 머리에. 테넌트 리스트는 호출자가 맞춘다
+static void fifoq_link_after(int q, int after, int frame_idx) {
+    int next = (after != -1) ? fifoq.next[after] : fifoq.head[q];
+    fifoq.queue[frame_idx] = (unsigned char)q;
+    fifoq.prev[frame_idx] = after;
+    fifoq.next[frame_idx] = next;
+    if (after != -1) fifoq.next[after] = frame_idx; else fifoq.head[q] = frame_idx;
+    if (next != -1) fifoq.prev[next] = frame_idx; else fifoq.tail[q] = frame_idx;
+    fifoq.size[q]++;
+}
+
+static void fifoq_push_head(int q, int frame_idx) {
+    fifoq_link_after(q, -1, frame_idx);
+    tchain_push_head(&fifoq_chain, q, frame_idx);
+}
+
+static void fifoq_unlink(int frame_idx) {
+    int q = fifoq.queue[frame_idx], prev = fifoq.prev[frame_idx], next = fifoq.next[frame_idx];
+    if (fifoq.sieve_hand == frame_idx) fifoq.sieve_hand = prev;
+    if (prev != -1) fifoq.next[prev] = next; else fifoq.head[q] = next;
+    if (next != -1) fifoq.prev[next] = prev; else fifoq.tail[q] = prev;
+    fifoq.size[q]--;
+    tchain_unlink(&fifoq_chain, q, frame_idx);
+}
+
+// 교체가 도는 리스트: t < 0 이면 정책 큐 전체, 아니면 테넌트 t 의 부분 리스트 (--tenants 희생자 테넌트)
+static inline int fifoq_tail(int q, int t) { return (t < 0) ? fifoq.tail[q] : fifoq_chain.tail[q][t]; }
+static inline int fifoq_size(int q, int t) { return (t < 0) ? fifoq.size[q] : fifoq_chain.size[q][t]; }
+static inline int fifoq_prev(int frame_idx, int t) { return (t < 0) ? fifoq.prev[frame_idx] : fifoq_chain.prev[frame_idx]; }
+
+// G 에 page_id 를 넣는다. 링이 가득 차면 가장 오래된 항목을 색인에서 뺀다
+static void s3fifo_ghost_push(unsigned long long page_id) {
+    int capacity = MAX(buffer_size, 1);
+    int slot = fifoq.ghost_pos;
+    if (fifoq.ghost_count == capacity) {
+        unsigned long long old = fifoq.ghost[slot];
+        if (old != INVALID_PAGE) u64map_remove(&fifoq_ghost_index, old);
+    } else {
+        fifoq.ghost_count++;
+    }
+    fifoq.ghost[slot] = page_id;
+    u64map_put(&fifoq_ghost_index, page_id, (unsigned long long)slot);
+    fifoq.ghost_pos = (slot + 1) % capacity;
+}
+
+// G 에 있으면 꺼내고 1, 없으면 0
+static int s3fifo_ghost_take(unsigned long long page_id) {
+    unsigned long long slot = u64map_get(&fifoq_ghost_index, page_id);
+    if (slot == INVALID_PAGE) return 0;
+    u64map_remove(&fifoq_ghost_index, page_id);
+    fifoq.ghost[slot] = INVALID_PAGE;
+    return 1;
+}
+
+// M 꼬리부터: 빈도가 남아 있으면 하나 줄여 머리로 재삽입, 0 이면 교체
+// --zns-cost: first 부터 머리 쪽으로 window 칸 안에서 다음에 교체될 후보를 모아 비용으로 고른다.
+// S3-FIFO 는 빈도가 max_freq 미만인 프레임, SIEVE (max_freq < 0) 는 방문 비트 0 인 프레임이 후보이고 머리에서 꼬리로 돈다
+static int fifoq_cost_pick(int first, int max_freq, int t) {
+    int cand[FLUSH_MAX_CLEAN_WINDOW + 1], n = 0;
+    int q = fifoq.queue[first];
+    cand[n++] = first;
+    int node = first;
+    for (int k = 0; k < zns_cost.window && k + 1 < fifoq_size(q, t); k++) {
+        node = fifoq_prev(node, t);
+        if (node == -1) {
+            if (max_freq >= 0) break;
+            node = fifoq_tail(q, t);
+        }
+        if (max_freq < 0 ? !frame_ref(node) : fifoq.freq[node] < max_freq) cand[n++] = node;
+    }
+    return cand[zns_cost_choose(cand, n)];
+}
+
+static int s3fifo_evict_main(int t) {
+    int node;
+    while ((node = fifoq_tail(FIFOQ_MAIN, t)) != -1) {
+        if (fifoq.freq[node] > 0) {
+            fifoq_unlink(node);
+            fifoq.freq[node]--;
+            fifoq_push_head(FIFOQ_MAIN, node);
+            fifoq.main_reinserts++;
+            continue;
+        }
+        if (zns_cost.window > 0) node = fifoq_cost_pick(node, 1, t);
+        fifoq_unlink(node);
+        return node;
+    }
+    return -1;
+}
+
+// S 가 목표 크기 이상이면 S 꼬리부터: 재참조된 페이지는 M 으로 옮기고, 한 번만 쓰인 페이지는 G 에 남기고 교체.
+// 버퍼 프레임을 두 큐가 나눠 쓰므로 S -> M 이동은 M 을 키울 뿐, 교체는 S 또는 M 에서 정확히 한 프레임.
+// --tenants: 희생자 테넌트의 부분 리스트에서 같은 알고리즘을 돌린다 (S 목표 크기는 그 테넌트 할당량 기준)
+int s3fifo_evict() {
+    int t = (ucp.victim_bits != NULL) ? ucp.victim_tenant : -1;
+    int small_target = MAX(1, ((t < 0) ? buffer_size : ucp.quota[t]) * S3FIFO_SMALL_PCT / 100);
+    if (fifoq_size(FIFOQ_SMALL, t) >= small_target || fifoq_size(FIFOQ_MAIN, t) == 0) {
+        int node;
+        while ((node = fifoq_tail(FIFOQ_SMALL, t)) != -1) {
+            if (fifoq.freq[node] >= S3FIFO_PROMOTE_FREQ) {
+                fifoq_unlink(node);
+                fifoq_push_head(FIFOQ_MAIN, node);
+                fifoq.small_to_main++;
+                continue;
+            }
+            if (zns_cost.window > 0) node = fifoq_cost_pick(node, S3FIFO_PROMOTE_FREQ, t);
+            fifoq_unlink(node);
+            s3fifo_ghost_push(buffer[node].page_id);
+            return node;
+        }
+    }
+    return s3fifo_evict_main(t);
+}
+
+// 바늘 위치(없으면 꼬리)에서 머리 쪽으로 가며 방문 비트를 지우고, 비트가 0 인 첫 프레임을 교체.
+// 살아남은 페이지는 제자리에 남으므로 새 페이지와 오래된 페이지가 섞이지 않는다
+// --tenants: 희생자 테넌트의 부분 리스트를 그 테넌트의 바늘로 돈다
+int sieve_evict() {
+    int t = (ucp.victim_bits != NULL) ? ucp.victim_tenant : -1;
+    int *hand = (t < 0) ? &fifoq.sieve_hand : &fifoq_chain.hand[t];
+    int node = (*hand != -1) ? *hand : fifoq_tail(FIFOQ_SMALL, t);
+    if (node == -1) return -1;
+    while (frame_ref(node)) {
+        set_frame_ref(node, 0);
+        fifoq.sieve_passes++;
+        node = fifoq_prev(node, t);
+        if (node == -1) node = fifoq_tail(FIFOQ_SMALL, t);
+    }
+    *hand = fifoq_prev(node, t);
+    if (zns_cost.window > 0) {
+        int chosen = fifoq_cost_pick(node, -1, t);
+        if (chosen != node) { *hand = node; node = chosen; } // 원래 후보가 다음 차례
+    }
+    fifoq_unlink(node);
+    return node;
+}
+
+// 새로 적재된 프레임을 큐 머리에 넣는다. S3_FIFO 는 G 에 있던 페이지면 M, 아니면 S 로
+void fifoq_admit(ReplacementPolicy policy, int frame_idx, unsigned long long page_id, int is_prefetch) {
+    fifoq.freq[frame_idx] = 0;
+    if (policy == SIEVE) {
+        fifoq_push_head(FIFOQ_SMALL, frame_idx);
+        return;
+    }
+    // 선반입 페이지는 G 항목을 소비하되 참조 전이므로 M 으로 올리지 않는다
+    int in_ghost = s3fifo_ghost_take(page_id);
+    if (in_ghost && !is_prefetch) {
+        fifoq.ghost_hits++;
+        fifoq_push_head(FIFOQ_MAIN, frame_idx);
+    } else {
+        fifoq_push_head(FIFOQ_SMALL, frame_idx);
+    }
+}
+
+// 정책 교체 이외의 이유로 비워지는 프레임 (release_frame)
+void fifoq_drop(int frame_idx) {
+    fifoq_unlink(frame_idx);
+}
+
+// TinyLFU 가 후보를 거절해 s3fifo_evict/sieve_evict 의 희생자를 다시 앉힌다. 빈도/방문 비트는 그대로 두고
+// S3_FIFO 는 원래 큐의 꼬리 (G 에 넣은 항목은 회수), SIEVE 는 바늘 (--tenants 면 그 테넌트의 바늘) 자리로 되돌려 다음 교체에서 다시 먼저 본다
+void fifoq_restore(ReplacementPolicy policy, int frame_idx, unsigned long long page_id) {
+    if (policy == SIEVE) {
+        int *hand = ucp.enabled ? &fifoq_chain.hand[ucp.frame_tenant[frame_idx]] : &fifoq.sieve_hand;
+        fifoq_link_after(FIFOQ_SMALL, *hand, frame_idx);
+        tchain_insert_after(&fifoq_chain, FIFOQ_SMALL, *hand, frame_idx);
+        *hand = frame_idx;
+        return;
+    }
+    int q = fifoq.queue[frame_idx];
+    if (q == FIFOQ_SMALL) s3fifo_ghost_take(page_id);
+    fifoq_link_after(q, fifoq.tail[q], frame_idx);
+    tchain_push_tail(&fifoq_chain, q, frame_idx);
+}
+
+static int fifoq_cmp_load_time(const void *a, const void *b) {
+    const BufferFrame *fa = &buffer[*(const int*)a], *fb = &buffer[*(const int*)b];
+    if (fa->load_time != fb->load_time) return (fa->load_time < fb->load_time) ? -1 : 1;
+    return *(const int*)a - *(const int*)b;
+}
+
+// 다른 정책에서 전환: 상주 페이지를 적재 시각 순서로 M (SIEVE 는 유일한 큐) 에 넣는다
+void fifoq_rebuild(ReplacementPolicy policy) {
+    static int order[MAX_BUFFER_SIZE];
+    fifoq_reset();
+    int q = (policy == SIEVE) ? FIFOQ_SMALL : FIFOQ_MAIN;
+    int count = 0;
+    FOR_EACH_CANDIDATE_FRAME(i, -1) order[count++] = i;
+    qsort(order, count, sizeof(int), fifoq_cmp_load_time);
+    for (int i = 0; i < count; i++) {
+        fifoq.freq[order[i]] = 0;
+        fifoq_push_head(q, order[i]);
+    }
+}
+
+
+// --- LIRS ---
+// Jiang, Zhang. "LIRS: An Efficient Low Inter-reference Recency Set Replacement Policy" (SIGMETRICS 2002)
+// 히트/미스마다 노드를 S 꼭대기로 옮기고, 바닥의 LIR 이 빠지면 바닥에서 HIR 노드를 걷어낸다 (stack pruning).
+// 노드는 S 에 한 번 들어올 때마다 많아야 한 번 걷히므로 pruning 은 접근당 분할 상환 O(1).
+
+void lirs_reset() {
+    if (lirs_nonres.keys == NULL) {
+        if (u64map_init(&lirs_nonres, (unsigned long long)MAX(buffer_size, 1) * (LIRS_NONRES_PCT / 100) * 2) != 0) {
+            fprintf(stderr, "Error: Failed to allocate LIRS index.\n");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        for (unsigned long long i = 0; i < lirs_nonres.capacity; i++) lirs_nonres.keys[i] = INVALID_PAGE;
+        lirs_nonres.count = 0;
+    }
+    lirs.free_count = 0;
+    lirs.nonres_used = 0;
+    lirs.s_top = lirs.s_bottom = lirs.q_head = lirs.q_tail = lirs.n_head = lirs.n_tail = -1;
+    lirs.lir_target = (buffer_size > 1) ? buffer_size - MAX(1, buffer_size * LIRS_HIR_PCT / 100) : 1;
+    lirs.nonres_limit = MAX(1, buffer_size * LIRS_NONRES_PCT / 100);
+    lirs.lir_count = lirs.hir_count = lirs.nonres_count = 0;
+    tchain_reset(&lirs_chain);
+}
+
+#define LIRS_CHAIN_Q   0              // lirs_chain 의 list: 테넌트의 상주 HIR (Q 순서)
+#define LIRS_CHAIN_LIR 1              // 테넌트의 LIR (S 순서, 꼬리가 바닥 쪽)
+
+static void lirs_s_push_top(int node) {
+    if (lirs.flags[node] & LIRS_LIR) tchain_push_head(&lirs_chain, LIRS_CHAIN_LIR, node);
+    lirs.flags[node] |= LIRS_IN_S;
+    lirs.s_prev[node] = -1;
+    lirs.s_next[node] = lirs.s_top;
+    if (lirs.s_top != -1) lirs.s_prev[lirs.s_top] = node; else lirs.s_bottom = node;
+    lirs.s_top = node;
+}
+
+static void lirs_s_unlink(int node) {
+    if (lirs.flags[node] & LIRS_LIR) tchain_unlink(&lirs_chain, LIRS_CHAIN_LIR, node);
+    int prev = lirs.s_prev[node], next = lirs.s_next[node];
+    if (prev != -1) lirs.s_next[prev] = next; else lirs.s_top = next;
+    if (next != -1) lirs.s_prev[next] = prev; else lirs.s_bottom = prev;
+    lirs.flags[node] &= (unsigned char)~LIRS_IN_S;
+}
+
+static void lirs_q_push_tail(int frame_idx) {
+    lirs.q_next[frame_idx] = -1;
+    lirs.q_prev[frame_idx] = lirs.q_tail;
+    if (lirs.q_tail != -1) lirs.q_next[lirs.q_tail] = frame_idx; else lirs.q_head = frame_idx;
+    lirs.q_tail = frame_idx;
+    tchain_push_tail(&lirs_chain, LIRS_CHAIN_Q, frame_idx);
+}
+
+static void lirs_q_unlink(int frame_idx) {
+    int prev = lirs.q_prev[frame_idx], next = lirs.q_next[frame_idx];
+    if (prev != -1) lirs.q_next[prev] = next; else lirs.q_head = next;
+    if (next != -1) lirs.q_prev[next] = prev; else lirs.q_tail = prev;
+    tchain_unlink(&lirs_chain, LIRS_CHAIN_Q, frame_idx);
+}
+
+// 비상주 노드를 S, 생성 순서 리스트, 색인에서 빼고 반환
+static void lirs_free_nonres(int node) {
+    int n = node - MAX_BUFFER_SIZE;
+    if (lirs.flags[node] & LIRS_IN_S) lirs_s_unlink(node);
+    int prev = lirs.n_prev[n], next = lirs.n_next[n];
+    if (prev != -1) lirs.n_next[prev] = next; else lirs.n_head = next;
+    if (next != -1) lirs.n_prev[next] = prev; else lirs.n_tail = prev;
+    u64map_remove(&lirs_nonres, lirs.nonres_page[n]);
+    lirs.free_nonres[lirs.free_count++] = node;
+    lirs.nonres_count--;
+}
+
+// S 바닥에서 LIR 이 나올 때까지 HIR 노드를 걷어낸다. 상주 HIR 은 Q 에 남고, 비상주 노드는 반환
+static void lirs_prune() {
+    while (lirs.s_bottom != -1 && !(lirs.flags[lirs.s_bottom] & LIRS_LIR)) {
+        int node = lirs.s_bottom;
+        lirs.pruned++;
+        if (node >= MAX_BUFFER_SIZE) lirs_free_nonres(node);
+        else lirs_s_unlink(node);
+    }
+}
+
+// S 바닥의 LIR 을 상주 HIR 로 내려 Q 꼬리에 넣는다. 바닥에 HIR/비상주 노드가 있으면 먼저 걷어낸다
+static void lirs_demote_bottom() {
+    lirs_prune();
+    int node = lirs.s_bottom;
+    if (node == -1 || node >= MAX_BUFFER_SIZE || !(lirs.flags[node] & LIRS_LIR)) return;
+    lirs_s_unlink(node);
+    lirs.flags[node] = 0;
+    lirs.lir_count--;
+    lirs.hir_count++;
+    lirs.demotions++;
+    lirs_q_push_tail(node);
+    lirs_prune();
+}
+
+void lirs_hit(int frame_idx) {
+    unsigned char flags = lirs.flags[frame_idx];
+    if (flags & LIRS_LIR) {
+        int was_bottom = (lirs.s_bottom == frame_idx);
+        lirs_s_unlink(frame_idx);
+        lirs_s_push_top(frame_idx);
+        if (was_bottom) lirs_prune();
+    } else if ((flags & LIRS_IN_S) || lirs.lir_count < lirs.lir_target) {
+        // S 안에서 다시 참조된 HIR: 재참조 거리가 S 바닥 LIR 의 recency 보다 짧으므로 LIR 로 올리고 바닥 LIR 을 내린다.
+        // S 밖의 HIR (선반입/재적재) 도 LIR 이 목표보다 적으면 바로 LIR
+        if (flags & LIRS_IN_S) lirs_s_unlink(frame_idx);
+        lirs_q_unlink(frame_idx);
+        lirs.flags[frame_idx] = LIRS_LIR;
+        lirs.hir_count--;
+        lirs.lir_count++;
+        lirs.promotions++;
+        lirs_s_push_top(frame_idx);
+        if (lirs.lir_count > lirs.lir_target) lirs_demote_bottom();
+    } else {
+        lirs_s_push_top(frame_idx);
+        lirs_q_unlink(frame_idx);
+        lirs_q_push_tail(frame_idx);
+    }
+}
+
+// Q 머리의 상주 HIR 을 교체. S 에 있던 페이지는 같은 자리에 비상주 노드를 남긴다
+// --tenants: 희생자 테넌트의 Q 순서에서 첫 상주 HIR. 그 테넌트에 상주 HIR 이 없으면 S 에서 가장 바닥 쪽의
+// 그 테넌트 LIR 을 (비상주 노드 없이) 교체하고, 빈 LIR 자리는 다음 적재가 채운다
+int lirs_evict() {
+    int t = (ucp.victim_bits != NULL) ? ucp.victim_tenant : -1;
+    if (t < 0 && lirs.q_head == -1) lirs_demote_bottom(); // 상주 페이지가 모두 LIR (전환 직후, 작은 버퍼)
+    int frame_idx = (t < 0) ? lirs.q_head : lirs_chain.head[LIRS_CHAIN_Q][t];
+    if (frame_idx == -1 && t >= 0) {
+        frame_idx = lirs_chain.tail[LIRS_CHAIN_LIR][t];
+        if (frame_idx != -1) lirs_drop(frame_idx);
+        return frame_idx;
+    }
+    if (frame_idx == -1) return -1;
+    if (zns_cost.window > 0) {
+        const int *next = (t < 0) ? lirs.q_next : lirs_chain.next;
+        int cand[FLUSH_MAX_CLEAN_WINDOW + 1], n = 0;
+        for (int i = frame_idx; i != -1 && n <= zns_cost.window; i = next[i]) cand[n++] = i;
+        frame_idx = cand[zns_cost_choose(cand, n)];
+    }
+    lirs_q_unlink(frame_idx);
+    lirs.hir_count--;
+    if (lirs.flags[frame_idx] & LIRS_IN_S) {
+        if (lirs.nonres_count >= lirs.nonres_limit) {
+            lirs.nonres_expired++;
+            lirs_free_nonres(MAX_BUFFER_SIZE + lirs.n_head);
+        }
+        int ghost = (lirs.free_count > 0) ? lirs.free_nonres[--lirs.free_count] : MAX_BUFFER_SIZE + lirs.nonres_used++;
+        int n = ghost - MAX_BUFFER_SIZE;
+        int prev = lirs.s_prev[frame_idx], next = lirs.s_next[frame_idx];
+        lirs.s_prev[ghost] = prev; lirs.s_next[ghost] = next;
+        if (prev != -1) lirs.s_next[prev] = ghost; else lirs.s_top = ghost;
+        if (next != -1) lirs.s_prev[next] = ghost; else lirs.s_bottom = ghost;
+        lirs.flags[ghost] = LIRS_IN_S;
+        lirs.nonres_page[n] = buffer[frame_idx].page_id;
+        lirs.n_next[n] = -1;
+        lirs.n_prev[n] = lirs.n_tail;
+        if (lirs.n_tail != -1) lirs.n_next[lirs.n_tail] = n; else lirs.n_head = n;
+        lirs.n_tail = n;
+        u64map_put(&lirs_nonres, buffer[frame_idx].page_id, (unsigned long long)ghost);
+        lirs.nonres_count++;
+        if (lirs.s_bottom == ghost) lirs_prune(); // 바닥은 항상 LIR
+    }
+    lirs.flags[frame_idx] = 0;
+    return frame_idx;
+}
+
+// 새로 적재된 프레임. S 에 비상주 노드가 남은 페이지면 LIR, 예열 중(LIR 이 목표보다 적음)이면 LIR, 아니면 상주 HIR.
+// 선반입/재적재 페이지는 아직 참조되지 않았으므로 예열 중이 아니면 비상주 노드만 지우고 S 밖의 HIR 로 Q 에만 넣는다
+void lirs_admit(int frame_idx, unsigned long long page_id, int is_prefetch) {
+    unsigned long long ghost = u64map_get(&lirs_nonres, page_id);
+    if (ghost != INVALID_PAGE) lirs_free_nonres((int)ghost);
+    lirs.flags[frame_idx] = 0;
+    if ((!is_prefetch && ghost != INVALID_PAGE) || lirs.lir_count < lirs.lir_target) {
+        if (!is_prefetch && ghost != INVALID_PAGE) { lirs.nonres_refaults++; lirs.promotions++; }
+        lirs.flags[frame_idx] = LIRS_LIR;
+        lirs.lir_count++;
+        lirs_s_push_top(frame_idx);
+        if (lirs.lir_count > lirs.lir_target) lirs_demote_bottom();
+    } else {
+        lirs.hir_count++;
+        if (!is_prefetch) lirs_s_push_top(frame_idx);
+        lirs_q_push_tail(frame_idx);
+    }
+}
+
+// 정책 교체 이외의 이유로 비워지는 프레임 (release_frame)
+void lirs_drop(int frame_idx) {
+    if (lirs.flags[frame_idx] & LIRS_LIR) {
+        lirs.lir_count--;
+    } else {
+        lirs.hir_count--;
+        lirs_q_unlink(frame_idx);
+    }
+    if (lirs.flags[frame_idx] & LIRS_IN_S) {
+        int was_bottom = (lirs.s_bottom == frame_idx);
+        lirs_s_unlink(frame_idx);
+        if (was_bottom) lirs_prune();
+    }
+    lirs.flags[frame_idx] = 0;
+}
+
+// TinyLFU 가 후보를 거절해 lirs_evict 의 희생자를 다시 앉힌다: Q 머리로 되돌리고,
+// S 에 남긴 비상주 노드가 아직 있으면 그 자리를 다시 차지한다 (걷혔으면 S 밖의 HIR)
+void lirs_restore(int frame_idx, unsigned long long page_id) {
+    unsigned long long ghost = u64map_get(&lirs_nonres, page_id);
+    lirs.flags[frame_idx] = 0;
+    if (ghost != INVALID_PAGE) {
+        int g = (int)ghost, prev = lirs.s_prev[g], next = lirs.s_next[g];
+        lirs.s_prev[frame_idx] = prev; lirs.s_next[frame_idx] = next;
+        if (prev != -1) lirs.s_next[prev] = frame_idx; else lirs.s_top = frame_idx;
+        if (next != -1) lirs.s_prev[next] = frame_idx; else lirs.s_bottom = frame_idx;
+        lirs.flags[frame_idx] = LIRS_IN_S;
+        lirs.flags[g] &= (unsigned char)~LIRS_IN_S; // S 링크는 위에서 넘겼으므로 lirs_free_nonres 가 다시 풀지 않게
+        lirs_free_nonres(g);
+    }
+    lirs.hir_count++;
+    lirs.q_prev[frame_idx] = -1;
+    lirs.q_next[frame_idx] = lirs.q_head;
+    if (lirs.q_head != -1) lirs.q_prev[lirs.q_head] = frame_idx; else lirs.q_tail = frame_idx;
+    lirs.q_head = frame_idx;
+    tchain_push_head(&lirs_chain, LIRS_CHAIN_Q, frame_idx);
+}
+
+static int lirs_cmp_access_time(const void *a, const void *b) {
+    const BufferFrame *fa = &buffer[*(const int*)a], *fb = &buffer[*(const int*)b];
+    if (fa->last_access_time != fb->last_access_time) return (fa->last_access_time < fb->last_access_time) ? -1 : 1;
+    return *(const int*)a - *(const int*)b;
+}
+
+// 다른 정책에서 전환: 최근 접근한 lir_target 개를 LIR 로 S 에, 나머지는 오래된 것부터 Q 에 넣는다
+void lirs_rebuild() {
+    static int order[MAX_BUFFER_SIZE];
+    lirs_reset();
+    int count = 0;
+    FOR_EACH_CANDIDATE_FRAME(i, -1) order[count++] = i;
+    qsort(order, count, sizeof(int), lirs_cmp_access_time);
+    int hir = MAX(0, count - lirs.lir_target);
+    for (int i = 0; i < count; i++) {
+        lirs.flags[order[i]] = 0;
+        if (i < hir) {
+            lirs.hir_count++;
+            lirs_q_push_tail(order[i]);
+        } else {
+            lirs.flags[order[i]] = LIRS_LIR;
+            lirs.lir_count++;
+            lirs_s_push_top(order[i]);
+        }
+    }
+}
+
+
 int arc_find_victim_lru_arc(unsigned long long page_id_to_load) {
     int victim_idx = -1;
     int evict_target_list = 0;
@@ -501,8 +3259,8 @@ int arc_find_victim_lru_arc(unsigned long long page_id_to_load) {
     } else {
         victim_idx = evict_fifo();
         if (victim_idx != -1) {
-            if (buffer[victim_idx].list_type == 1 && arc_state.t1_size > 0) arc_state.t1_size--;
-            else if (buffer[victim_idx].list_type == 2 && arc_state.t2_size > 0) arc_state.t2_size--;
+            if (frame_list(victim_idx) == 1 && arc_state.t1_size > 0) arc_state.t1_size--;
+            else if (frame_list(victim_idx) == 2 && arc_state.t2_size > 0) arc_state.t2_size--;
         }
     }
     return victim_idx;
@@ -531,347 +3289,3170 @@ int arc_find_victim_lfu_arc(unsigned long long page_id_to_load) {
                  return evict_fifo();
             }
         }
-    } else {
-         return evict_fifo();
+    } else {
+         return evict_fifo();
+    }
+
+    if (evict_target_list_type == 3) {
+        victim_idx = evict_arc_internal_lfu(3);
+    } else {
+        victim_idx = evict_arc_internal_lru(4);
+    }
+
+    if (victim_idx != -1) {
+        unsigned long long evicted_page_id = buffer[victim_idx].page_id;
+        if (evict_target_list_type == 3) {
+            arc_add_to_ghost_mru(evicted_page_id, arc_state.b3, &arc_state.b3_size, buffer_size);
+            if(arc_state.t3_size > 0) arc_state.t3_size--;
+        } else {
+            arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size);
+            if(arc_state.t4_size > 0) arc_state.t4_size--;
+        }
+    } else {
+         victim_idx = evict_fifo();
+         if (victim_idx != -1) {
+            if (frame_list(victim_idx) == 3 && arc_state.t3_size > 0) arc_state.t3_size--;
+            else if (frame_list(victim_idx) == 4 && arc_state.t4_size > 0) arc_state.t4_size--;
+         }
+    }
+    return victim_idx;
+}
+
+// --- 지연 히스토그램 ---
+
+static int hist_index(unsigned long long v) {
+    if (v >= (1ULL << (HIST_MAX_SHIFT + HIST_SUB_BITS))) v = (1ULL << (HIST_MAX_SHIFT + HIST_SUB_BITS)) - 1;
+    if (v < 2 * HIST_HALF) return (int)v;
+    int shift = (63 - __builtin_clzll(v)) - (HIST_SUB_BITS - 1);
+    return shift * HIST_HALF + (int)(v >> shift);
+}
+
+// 구간에 속하는 가장 큰 값 (HDR 의 highest equivalent value)
+static unsigned long long hist_value(int idx) {
+    if (idx < 2 * HIST_HALF) return (unsigned long long)idx;
+    int shift = idx / HIST_HALF - 1;
+    unsigned long long m = (unsigned long long)(idx - shift * HIST_HALF);
+    return ((m + 1) << shift) - 1;
+}
+
+static void hist_record(LatencyHistogram *h, unsigned long long ns) {
+    h->counts[hist_index(ns)]++;
+    h->count++;
+    h->sum_ns += ns;
+    if (ns > h->max_ns) h->max_ns = ns;
+}
+
+static unsigned long long hist_percentile(const LatencyHistogram *h, double pct) {
+    if (h->count == 0) return 0;
+    unsigned long long target = (unsigned long long)(pct / 100.0 * h->count + 0.999999);
+    if (target == 0) target = 1;
+    unsigned long long seen = 0;
+    for (int i = 0; i < HIST_SLOTS; i++) {
+        seen += h->counts[i];
+        if (seen >= target) return MIN(hist_value(i), h->max_ns);
+    }
+    return h->max_ns;
+}
+
+static void hist_print_row(const char *label, const LatencyHistogram *h, unsigned long long elapsed_ns) {
+    double iops = (elapsed_ns == 0) ? 0.0 : (double)h->count * 1e9 / elapsed_ns;
+    printf(" %-24s %10llu %10.1f %9.1f %9.1f %9.1f %10.1f %11.0f\n", label, h->count,
+           (h->count == 0) ? 0.0 : (double)h->sum_ns / h->count / 1000.0,
+           hist_percentile(h, 50.0) / 1000.0, hist_percentile(h, 99.0) / 1000.0,
+           hist_percentile(h, 99.9) / 1000.0, h->max_ns / 1000.0, iops);
+}
+
+// --- 장치 지연/큐잉 모델 ---
+
+int device_init(const DevicePreset *cfg, unsigned long long hit_ns) {
+    device_free();
+    if (cfg->channels <= 0 || cfg->channels > DEV_MAX_CHANNELS || cfg->queue_depth <= 0 || cfg->queue_depth > DEV_MAX_QUEUE_DEPTH) return -1;
+    device.inflight = (unsigned long long*)malloc(cfg->queue_depth * sizeof(unsigned long long));
+    if (device.inflight == NULL) return -1;
+    device.cfg = *cfg;
+    device.hit_ns = hit_ns;
+    device.epoch_index = 1;
+    device.epoch_start_line = 1;
+    device.speed_pct = 100;
+    device.enabled = 1;
+    return 0;
+}
+
+void device_free() {
+    free(device.inflight);
+    memset(&device, 0, sizeof(device));
+}
+
+static void device_heap_push(unsigned long long done_ns) {
+    int i = device.inflight_count++;
+    while (i > 0 && device.inflight[(i - 1) / 2] > done_ns) {
+        device.inflight[i] = device.inflight[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    device.inflight[i] = done_ns;
+}
+
+static unsigned long long device_heap_pop() {
+    unsigned long long top = device.inflight[0];
+    unsigned long long last = device.inflight[--device.inflight_count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= device.inflight_count) break;
+        if (child + 1 < device.inflight_count && device.inflight[child + 1] < device.inflight[child]) child++;
+        if (device.inflight[child] >= last) break;
+        device.inflight[i] = device.inflight[child];
+        i = child;
+    }
+    if (device.inflight_count > 0) device.inflight[i] = last;
+    return top;
+}
+
+// 장치 I/O 하나를 큐에 넣고 완료 시각을 계산. 요청 처리 중의 동기 I/O 면 요청 완료 시각을 늦춘다.
+// 제출 시각은 동기/비동기 모두 장치의 현재 시각 (요청 처리 중이면 요청이 지금까지 진행된 시각, 아니면 호스트 시계)
+void device_submit(int operation_type, unsigned long long length_bytes) {
+    if (!device.enabled) return;
+    int sync = device.in_request && device.async_depth == 0;
+    unsigned long long submit_ns = device.in_request ? device.req_done_ns : device.now_ns;
+
+    unsigned long long page_bytes = (unsigned long long)SECTORS_PER_PAGE * SECTOR_SIZE;
+    unsigned long long pages = (length_bytes + page_bytes - 1) / page_bytes;
+    unsigned long long service_ns;
+    if (operation_type == OP_TRIM) service_ns = device.cfg.reset_ns;
+    else service_ns = ((operation_type == OP_WRITE) ? device.cfg.write_ns : device.cfg.read_ns) + (pages > 1 ? (pages - 1) * device.cfg.xfer_ns : 0);
+
+    // 끝난 I/O 를 큐에서 빼고, 큐가 가득 차 있으면 가장 먼저 끝나는 I/O 를 기다림
+    unsigned long long start_ns = submit_ns;
+    while (device.inflight_count > 0 && device.inflight[0] <= start_ns) device_heap_pop();
+    if (device.inflight_count == device.cfg.queue_depth) start_ns = device_heap_pop();
+
+    int ch = 0;
+    for (int i = 1; i < device.cfg.channels; i++) {
+        if (device.channel_free_ns[i] < device.channel_free_ns[ch]) ch = i;
+    }
+    start_ns = MAX(start_ns, device.channel_free_ns[ch]);
+    unsigned long long done_ns = start_ns + service_ns;
+    device.channel_free_ns[ch] = done_ns;
+    device_heap_push(done_ns);
+
+    device.ios[operation_type]++;
+    device.queue_wait_ns += start_ns - submit_ns;
+    device.busy_ns += service_ns;
+    if (sync) device.req_done_ns = done_ns;
+}
+
+// closed-loop 이면 직전 요청 완료 시각에, open-loop 이면 트레이스 타임스탬프에 요청이 도착.
+// 타임스탬프가 없는 요청이나 시각이 거꾸로 가는 요청은 직전 도착 시각에 도착한 것으로 본다.
+void device_request_begin(unsigned long long num_pages, int has_time, unsigned long long time_ns) {
+    if (!device.enabled) return;
+    if (device.open_loop && has_time) {
+        if (!device.time_origin_set) { device.time_origin_ns = time_ns; device.time_origin_set = 1; }
+        unsigned long long offset_ns = (time_ns > device.time_origin_ns) ? time_ns - device.time_origin_ns : 0;
+        unsigned long long arrival_ns = (unsigned long long)((double)offset_ns * 100.0 / device.speed_pct);
+        if (arrival_ns > device.now_ns) {
+            device.policy_elapsed_ns[current_policy] += arrival_ns - device.now_ns;
+            device.now_ns = arrival_ns;
+        }
+    }
+    device.in_request = 1;
+    device.req_arrival_ns = device.now_ns;
+    device.req_done_ns = device.now_ns + device.hit_ns * num_pages;
+    device.req_hits_start = hits;
+    device.req_misses_start = misses;
+}
+
+void device_request_end() {
+    if (!device.enabled) return;
+    unsigned long long latency_ns = device.req_done_ns - device.req_arrival_ns;
+    hist_record(&device.policy_hist[current_policy], latency_ns);
+    hist_record(&device.epoch_hist, latency_ns);
+    if (!device.open_loop) {
+        device.policy_elapsed_ns[current_policy] += latency_ns;
+        device.now_ns = device.req_done_ns; // closed-loop: 다음 요청은 이 요청이 끝난 뒤 도착
+    }
+    if (device.req_done_ns > device.last_done_ns) device.last_done_ns = device.req_done_ns;
+    device.in_request = 0;
+    if (timeseries.enabled) {
+        timeseries_record(device.req_arrival_ns, device.req_done_ns,
+                          (unsigned long long)(hits - device.req_hits_start), (unsigned long long)(misses - device.req_misses_start));
+    }
+}
+
+// 현재 정책 구간의 지연 분포를 출력하고 새 구간을 시작
+void device_epoch_report(int end_line) {
+    if (!device.enabled) return;
+    const LatencyHistogram *h = &device.epoch_hist;
+    if (h->count > 0) {
+        unsigned long long elapsed_ns = device.now_ns - device.epoch_start_ns;
+        printf("DEV epoch #%d %s (라인 %d-%d): 요청 %llu, 평균 %.1f us, p50 %.1f / p99 %.1f / p99.9 %.1f us, %.0f IOPS\n",
+               device.epoch_index, policy_names[current_policy], device.epoch_start_line, end_line, h->count,
+               (double)h->sum_ns / h->count / 1000.0, hist_percentile(h, 50.0) / 1000.0, hist_percentile(h, 99.0) / 1000.0,
+               hist_percentile(h, 99.9) / 1000.0, (elapsed_ns == 0) ? 0.0 : (double)h->count * 1e9 / elapsed_ns);
+    }
+    memset(&device.epoch_hist, 0, sizeof(device.epoch_hist));
+    device.epoch_index++;
+    device.epoch_start_line = end_line + 1;
+    device.epoch_start_ns = device.now_ns;
+}
+
+// 정책의 리스트 크기 회계에서 프레임을 빼고 빈 슬롯으로 만든다 (고스트 리스트에는 넣지 않음)
+void release_frame(int frame_idx) {
+    int list = (current_policy == LRU || current_policy == LFU) ? buffer[frame_idx].ref_arc_list_type : frame_list(frame_idx);
+    if (list == 1 && arc_state.t1_size > 0) arc_state.t1_size--;
+    else if (list == 2 && arc_state.t2_size > 0) arc_state.t2_size--;
+    else if (list == 3 && arc_state.t3_size > 0) arc_state.t3_size--;
+    else if (list == 4 && arc_state.t4_size > 0) arc_state.t4_size--;
+    if (current_policy == CLOCK_PRO) clockpro_drop(frame_idx);
+    else if (current_policy == S3_FIFO || current_policy == SIEVE) fifoq_drop(frame_idx);
+    else if (current_policy == LIRS) lirs_drop(frame_idx);
+    handle_dirty_eviction(frame_idx);
+    set_frame_page(frame_idx, INVALID_PAGE);
+    buffer[frame_idx].prefetched = 0;
+}
+
+// --- 선반입(readahead) 엔진 ---
+
+int readahead_init(int min_window, int max_window, int num_streams, int region_pages, int max_pct) {
+    readahead_free();
+    if (min_window <= 0 || max_window < min_window || num_streams <= 0 || num_streams > RA_MAX_STREAMS ||
+        region_pages <= 0 || max_pct <= 0 || max_pct > 100) return -1;
+    readahead.list_capacity = MAX_BUFFER_SIZE;
+    readahead.list_frames = (int*)malloc(readahead.list_capacity * sizeof(int));
+    readahead.list_pages = (unsigned long long*)malloc(readahead.list_capacity * sizeof(unsigned long long));
+    if (readahead.list_frames == NULL || readahead.list_pages == NULL) {
+        readahead_free();
+        return -1;
+    }
+    readahead.min_window = min_window;
+    readahead.max_window = max_window;
+    readahead.cur_max_window = min_window;
+    readahead.num_streams = num_streams;
+    readahead.region_pages = region_pages;
+    readahead.max_unused = MAX(1, (int)((long long)buffer_size * max_pct / 100));
+    readahead.enabled = 1;
+    return 0;
+}
+
+void readahead_free() {
+    free(readahead.list_frames);
+    free(readahead.list_pages);
+    memset(&readahead, 0, sizeof(readahead));
+}
+
+static int readahead_list_entry_live(int pos) {
+    int frame_idx = readahead.list_frames[pos];
+    return buffer[frame_idx].prefetched && buffer[frame_idx].page_id == readahead.list_pages[pos];
+}
+
+// 참조되었거나 이미 쫓겨난 항목이 쌓여 큐가 가득 차면 유효 항목만 남긴다
+static void readahead_list_compact() {
+    int kept = 0;
+    for (int i = 0; i < readahead.list_count; i++) {
+        int pos = (readahead.list_head + i) % readahead.list_capacity;
+        if (!readahead_list_entry_live(pos)) continue;
+        readahead.list_frames[kept] = readahead.list_frames[pos];
+        readahead.list_pages[kept] = readahead.list_pages[pos];
+        kept++;
+    }
+    readahead.list_head = 0;
+    readahead.list_count = kept;
+}
+
+static void readahead_list_push(int frame_idx) {
+    if (readahead.list_count == readahead.list_capacity) readahead_list_compact();
+    int pos = (readahead.list_head + readahead.list_count) % readahead.list_capacity;
+    readahead.list_frames[pos] = frame_idx;
+    readahead.list_pages[pos] = buffer[frame_idx].page_id;
+    readahead.list_count++;
+    readahead.unused_count++;
+}
+
+// prefetch list 에서 가장 오래된 미참조 선반입 페이지를 버림
+static void readahead_drop_oldest() {
+    while (readahead.list_count > 0) {
+        int pos = readahead.list_head;
+        readahead.list_head = (readahead.list_head + 1) % readahead.list_capacity;
+        readahead.list_count--;
+        if (!readahead_list_entry_live(pos)) continue;
+        int frame_idx = readahead.list_frames[pos];
+        readahead_note_wasted(frame_idx);
+        release_frame(frame_idx);
+        return;
+    }
+}
+
+void readahead_note_hit(int frame_idx) {
+    buffer[frame_idx].prefetched = 0;
+    readahead.unused_count--;
+    readahead.hits++;
+    if (readahead.cur_max_window < readahead.max_window) readahead.cur_max_window++;
+}
+
+void readahead_note_wasted(int frame_idx) {
+    buffer[frame_idx].prefetched = 0;
+    readahead.unused_count--;
+    readahead.wasted++;
+    readahead.cur_max_window = MAX(readahead.min_window, readahead.cur_max_window / 2);
+}
+
+// 접근 페이지와 stride 가 맞는 스트림을 찾고, 없으면 같은 영역의 스트림에서 stride 를 새로 잡거나 슬롯을 할당
+static ReadaheadStream* readahead_find_stream(unsigned long long page_id) {
+    ReadaheadStream *same_region = NULL, *lru_slot = NULL;
+    unsigned long long region = page_id / readahead.region_pages;
+    for (int i = 0; i < readahead.num_streams; i++) {
+        ReadaheadStream *st = &readahead.streams[i];
+        if (!st->valid) {
+            if (lru_slot == NULL || lru_slot->valid) lru_slot = st;
+            continue;
+        }
+        if (st->stride != 0 && page_id == st->last_page + st->stride) {
+            st->confidence++;
+            return st;
+        }
+        if (same_region == NULL && st->last_page / readahead.region_pages == region) same_region = st;
+        if (lru_slot == NULL || (lru_slot->valid && st->last_use < lru_slot->last_use)) lru_slot = st;
+    }
+    if (same_region != NULL) {
+        if (page_id != same_region->last_page) {
+            same_region->stride = (long long)(page_id - same_region->last_page);
+            same_region->confidence = 0;
+            same_region->window = readahead.min_window;
+            same_region->prefetched_upto = page_id;
+        }
+        return same_region;
+    }
+    lru_slot->valid = 1;
+    lru_slot->stride = 0;
+    lru_slot->confidence = 0;
+    lru_slot->window = readahead.min_window;
+    lru_slot->prefetched_upto = page_id;
+    return lru_slot;
+}
+
+void readahead_on_access(unsigned long long page_id, int operation_type) {
+    if (!readahead.enabled || operation_type != OP_READ) return;
+    ReadaheadStream *st = readahead_find_stream(page_id);
+    st->last_page = page_id;
+    st->last_use = ++readahead.use_clock;
+    if (st->stride == 0 || st->confidence < RA_TRIGGER_CONFIDENCE) return;
+
+    // 윈도우 끝까지 아직 요청하지 않은 페이지만 선반입
+    long long stride = st->stride;
+    long long issued = (long long)(st->prefetched_upto - page_id);
+    long long ahead_from = (issued % stride == 0 && issued / stride > 0) ? issued / stride : 0;
+    if (ahead_from >= st->window) return;
+    readahead.triggers++;
+    device.async_depth++; // 선반입 I/O 는 요청을 기다리게 하지 않음
+
+    unsigned long long run_start = INVALID_PAGE, run_len = 0;
+    for (long long k = ahead_from + 1; k <= st->window; k++) {
+        long long target = (long long)page_id + k * stride;
+        if (target < 0) break;
+        unsigned long long target_page = (unsigned long long)target;
+        st->prefetched_upto = target_page;
+        if (find_in_buffer(target_page) != -1) continue;
+
+        if (readahead.unused_count >= readahead.max_unused) readahead_drop_oldest();
+        int slot = load_page_into_buffer(target_page, OP_READ, 1);
+        if (slot == -1) break;
+        buffer[slot].prefetched = 1;
+        readahead_list_push(slot);
+        readahead.pages++;
+
+        // 연속된 페이지는 하나의 읽기 I/O 로 묶음
+        if (run_len > 0 && target_page == run_start + run_len) {
+            run_len++;
+        } else {
+            if (run_len > 0) { read_pages_from_device(run_start, run_len); readahead.ios++; }
+            run_start = target_page;
+            run_len = 1;
+        }
+    }
+    if (run_len > 0) { read_pages_from_device(run_start, run_len); readahead.ios++; }
+    device.async_depth--;
+    st->window = MIN(readahead.cur_max_window, st->window * 2);
+    if (st->window < readahead.min_window) st->window = readahead.min_window;
+}
+
+// --- TinyLFU 승인 필터 ---
+
+static unsigned long long tinylfu_pow2_at_least(unsigned long long n) {
+    unsigned long long p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// sketch/doorkeeper 를 현재 buffer_size 에 맞춰 (다시) 할당하고 비운다.
+// initialize_buffer 에서 불리므로 샤드 자식은 자기 샤드 크기로 다시 만든다. sample_factor 가 0 이면 비활성
+void tinylfu_reset() {
+    if (tinylfu.sample_factor <= 0) return;
+    int sample_factor = tinylfu.sample_factor;
+    tinylfu_free();
+    tinylfu.sample_factor = sample_factor;
+    tinylfu.sample_size = (unsigned long long)sample_factor * (unsigned long long)MAX(1, buffer_size);
+    unsigned long long width = tinylfu_pow2_at_least(MAX((unsigned long long)TINYLFU_MIN_WIDTH, (unsigned long long)buffer_size));
+    unsigned long long door_bits = tinylfu_pow2_at_least(MAX(4096ULL, tinylfu.sample_size * 4)); // 주기당 고유 페이지 <= sample_size
+    tinylfu.sketch = (unsigned char*)calloc(width * TINYLFU_ROWS, 1);
+    tinylfu.door = (unsigned long long*)calloc(door_bits / 64, sizeof(unsigned long long));
+    if (tinylfu.sketch == NULL || tinylfu.door == NULL) {
+        fprintf(stderr, "Error: Failed to allocate TinyLFU sketch.\n");
+        exit(EXIT_FAILURE);
+    }
+    tinylfu.width_mask = width - 1;
+    tinylfu.door_mask = door_bits - 1;
+    tinylfu.enabled = 1;
+}
+
+void tinylfu_free() {
+    free(tinylfu.sketch);
+    free(tinylfu.door);
+    memset(&tinylfu, 0, sizeof(tinylfu));
+}
+
+static inline unsigned long long tinylfu_hash(unsigned long long page_id) {
+    unsigned long long z = page_id + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 행 r 의 카운터 위치 (이중 해싱)
+static inline unsigned long long tinylfu_slot(unsigned long long h, int r) {
+    return (unsigned long long)r * (tinylfu.width_mask + 1) + ((h + (unsigned long long)r * ((h >> 32) | 1)) & tinylfu.width_mask);
+}
+
+// doorkeeper 비트 두 개 (sketch 행과 다른 해시 비트를 쓴다)
+static inline void tinylfu_door_bits(unsigned long long h, unsigned long long *b1, unsigned long long *b2) {
+    *b1 = ((h * 0x9E3779B97F4A7C15ULL) >> 32) & tinylfu.door_mask;
+    *b2 = (h >> 16) & tinylfu.door_mask;
+}
+
+static inline int tinylfu_door_contains(unsigned long long h) {
+    unsigned long long b1, b2;
+    tinylfu_door_bits(h, &b1, &b2);
+    return (tinylfu.door[b1 >> 6] >> (b1 & 63) & 1) && (tinylfu.door[b2 >> 6] >> (b2 & 63) & 1);
+}
+
+// 노화: 모든 카운터를 절반으로, doorkeeper 는 비움
+static void tinylfu_age() {
+    unsigned long long n = (tinylfu.width_mask + 1) * TINYLFU_ROWS;
+    for (unsigned long long i = 0; i < n; i++) tinylfu.sketch[i] >>= 1;
+    memset(tinylfu.door, 0, (tinylfu.door_mask + 1) / 8);
+    tinylfu.additions /= 2;
+    tinylfu.agings++;
+}
+
+// 접근 한 번 기록. 처음 보는 페이지는 doorkeeper 에만 남기고, 두 번째부터 sketch 의 최솟값 카운터만 올린다 (conservative update)
+static void tinylfu_record(unsigned long long page_id) {
+    unsigned long long h = tinylfu_hash(page_id);
+    if (!tinylfu_door_contains(h)) {
+        unsigned long long b1, b2;
+        tinylfu_door_bits(h, &b1, &b2);
+        tinylfu.door[b1 >> 6] |= 1ULL << (b1 & 63);
+        tinylfu.door[b2 >> 6] |= 1ULL << (b2 & 63);
+    } else {
+        unsigned long long slot[TINYLFU_ROWS];
+        unsigned char min = TINYLFU_MAX_COUNT;
+        for (int r = 0; r < TINYLFU_ROWS; r++) {
+            slot[r] = tinylfu_slot(h, r);
+            if (tinylfu.sketch[slot[r]] < min) min = tinylfu.sketch[slot[r]];
+        }
+        if (min < TINYLFU_MAX_COUNT) {
+            for (int r = 0; r < TINYLFU_ROWS; r++) {
+                if (tinylfu.sketch[slot[r]] == min) tinylfu.sketch[slot[r]]++;
+            }
+        }
+    }
+    if (++tinylfu.additions >= tinylfu.sample_size) tinylfu_age();
+}
+
+static int tinylfu_estimate(unsigned long long page_id) {
+    unsigned long long h = tinylfu_hash(page_id);
+    int min = TINYLFU_MAX_COUNT;
+    for (int r = 0; r < TINYLFU_ROWS; r++) min = MIN(min, (int)tinylfu.sketch[tinylfu_slot(h, r)]);
+    return min + tinylfu_door_contains(h);
+}
+
+// 후보의 추정 빈도가 희생자보다 높을 때만 승인
+static int tinylfu_admit(unsigned long long candidate, unsigned long long victim) {
+    if (tinylfu_estimate(candidate) > tinylfu_estimate(victim)) { tinylfu.admits++; return 1; }
+    tinylfu.rejects++;
+    return 0;
+}
+
+static inline void tinylfu_note_hit(int frame_idx) {
+    tinylfu_record(buffer[frame_idx].page_id);
+    if (tinylfu.kept[frame_idx]) {
+        tinylfu.kept[frame_idx] = 0;
+        tinylfu.saved_reads++;
+    }
+}
+
+// --- 테넌트 분할 (UCP) ---
+
+static int ucp_cmp_range(const void *a, const void *b) {
+    const TenantRange *ra = (const TenantRange*)a, *rb = (const TenantRange*)b;
+    return (ra->first < rb->first) ? -1 : (ra->first > rb->first);
+}
+
+// "<첫 페이지> <끝 페이지> <테넌트>" 줄 (끝 포함, '#' 뒤는 주석). 성공 시 0
+int ucp_load_map(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) { fprintf(stderr, "오류: 테넌트 맵 '%s' 열기 실패: %s\n", path, strerror(errno)); return -1; }
+    char line[256];
+    int capacity = 0, line_num = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line_num++;
+        char *hash = strchr(line, '#');
+        if (hash != NULL) *hash = '\0';
+        unsigned long long first, last;
+        int tenant;
+        char extra;
+        int fields = sscanf(line, "%llu %llu %d %c", &first, &last, &tenant, &extra);
+        if (fields <= 0) continue;
+        if (fields != 3 || first > last || tenant < 0 || tenant >= UCP_MAX_TENANTS) {
+            fprintf(stderr, "오류: 테넌트 맵 %s:%d 형식은 '<첫 페이지> <끝 페이지> <테넌트 0..%d>' 입니다.\n", path, line_num, UCP_MAX_TENANTS - 1);
+            fclose(fp); return -1;
+        }
+        if (ucp.num_ranges == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            TenantRange *grown = (TenantRange*)realloc(ucp.ranges, capacity * sizeof(TenantRange));
+            if (grown == NULL) { fprintf(stderr, "Error: Failed to allocate tenant map.\n"); exit(EXIT_FAILURE); }
+            ucp.ranges = grown;
+        }
+        ucp.ranges[ucp.num_ranges++] = (TenantRange){first, last, tenant};
+        ucp.num_tenants = MAX(ucp.num_tenants, tenant + 1);
+    }
+    fclose(fp);
+    if (ucp.num_ranges == 0) { fprintf(stderr, "오류: 테넌트 맵 '%s' 에 구간이 없습니다.\n", path); return -1; }
+    qsort(ucp.ranges, ucp.num_ranges, sizeof(TenantRange), ucp_cmp_range);
+    for (int i = 1; i < ucp.num_ranges; i++) {
+        if (ucp.ranges[i].first <= ucp.ranges[i - 1].last) {
+            fprintf(stderr, "오류: 테넌트 맵 구간 %llu-%llu 와 %llu-%llu 가 겹칩니다.\n",
+                    ucp.ranges[i - 1].first, ucp.ranges[i - 1].last, ucp.ranges[i].first, ucp.ranges[i].last);
+            return -1;
+        }
+    }
+    if (ucp.interval == 0) ucp.interval = UCP_DEFAULT_INTERVAL;
+    return 0;
+}
+
+int ucp_tenant_of(unsigned long long page_id) {
+    int lo = 0, hi = ucp.num_ranges - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (page_id < ucp.ranges[mid].first) hi = mid - 1;
+        else if (page_id > ucp.ranges[mid].last) lo = mid + 1;
+        else return ucp.ranges[mid].tenant;
+    }
+    return 0;
+}
+
+// 조각 수를 프레임 할당량으로 (누적 경계로 나눠 합이 buffer_size)
+static void ucp_apply_buckets() {
+    int cum = 0;
+    for (int t = 0; t < ucp.num_tenants; t++) {
+        int lo = (int)((long long)cum * buffer_size / ucp.bucket_count);
+        cum += ucp.buckets[t];
+        ucp.quota[t] = (int)((long long)cum * buffer_size / ucp.bucket_count) - lo;
+    }
+}
+
+// UMON 스택과 할당량을 현재 buffer_size 에 맞춰 (다시) 만든다. 맵이 없으면 비활성
+void ucp_reset() {
+    if (ucp.ranges == NULL) return;
+    free(ucp.stacks);
+    TenantRange *ranges = ucp.ranges;
+    int num_ranges = ucp.num_ranges, num_tenants = ucp.num_tenants;
+    unsigned long long interval = ucp.interval;
+    memset(&ucp, 0, sizeof(ucp));
+    ucp.ranges = ranges;
+    ucp.num_ranges = num_ranges;
+    ucp.num_tenants = num_tenants;
+    ucp.interval = interval;
+    ucp.bucket_count = MIN(UCP_BUCKETS, MAX(buffer_size, 1));
+    ucp.stack_cap = MAX(1, buffer_size >> UCP_SAMPLE_SHIFT);
+    ucp.stacks = (unsigned long long*)malloc((size_t)ucp.num_tenants * ucp.stack_cap * sizeof(unsigned long long));
+    if (ucp.stacks == NULL) { fprintf(stderr, "Error: Failed to allocate UMON stacks.\n"); exit(EXIT_FAILURE); }
+    for (int t = 0; t < ucp.num_tenants; t++) {
+        ucp.buckets[t] = ucp.bucket_count / ucp.num_tenants + (t < ucp.bucket_count % ucp.num_tenants);
+    }
+    ucp_apply_buckets();
+    ucp.enabled = 1;
+}
+
+void ucp_free() {
+    free(ucp.stacks);
+    free(ucp.ranges);
+    memset(&ucp, 0, sizeof(ucp));
+}
+
+// 샘플 페이지를 테넌트 스택의 MRU 로. 스택 거리 d 의 히트는 (d + 1) << UCP_SAMPLE_SHIFT 프레임 이상이면 히트
+static void ucp_umon_access(int tenant, unsigned long long page_id) {
+    unsigned long long *stack = ucp.stacks + (size_t)tenant * ucp.stack_cap;
+    int len = ucp.stack_len[tenant], d = 0;
+    while (d < len && stack[d] != page_id) d++;
+    if (d < len) {
+        unsigned long long frames = (unsigned long long)(d + 1) << UCP_SAMPLE_SHIFT;
+        unsigned long long bucket = (frames * ucp.bucket_count - 1) / (unsigned long long)buffer_size;
+        ucp.way_hits[tenant][MIN(bucket, (unsigned long long)ucp.bucket_count - 1)]++;
+    } else {
+        if (len < ucp.stack_cap) ucp.stack_len[tenant] = ++len;
+        d = len - 1; // 가득 찼으면 LRU 항목을 덮어쓴다
+    }
+    memmove(stack + 1, stack, (size_t)d * sizeof(*stack));
+    stack[0] = page_id;
+}
+
+// lookahead: 남은 조각 안에서 "추가 히트 / 조각 수" 가 가장 큰 테넌트에 그만큼 준다 (테넌트마다 최소 한 조각)
+static void ucp_reallocate() {
+    unsigned long long util[UCP_MAX_TENANTS][UCP_BUCKETS + 1];
+    int balance = ucp.bucket_count - ucp.num_tenants;
+    for (int t = 0; t < ucp.num_tenants; t++) {
+        util[t][0] = 0;
+        for (int b = 0; b < ucp.bucket_count; b++) util[t][b + 1] = util[t][b] + ucp.way_hits[t][b];
+        ucp.buckets[t] = 1;
+    }
+    while (balance > 0) {
+        int best_t = -1, best_k = 0;
+        double best_mu = 0.0;
+        for (int t = 0; t < ucp.num_tenants; t++) {
+            int have = ucp.buckets[t];
+            for (int k = 1; k <= balance; k++) {
+                double mu = (double)(util[t][have + k] - util[t][have]) / k;
+                if (mu > best_mu) { best_mu = mu; best_t = t; best_k = k; }
+            }
+        }
+        if (best_t == -1) break; // 남은 조각에 효용이 없음
+        ucp.buckets[best_t] += best_k;
+        balance -= best_k;
+    }
+    for (int t = 0; balance > 0; t = (t + 1) % ucp.num_tenants, balance--) ucp.buckets[t]++;
+    ucp_apply_buckets();
+    for (int t = 0; t < ucp.num_tenants; t++) {
+        for (int b = 0; b < ucp.bucket_count; b++) ucp.way_hits[t][b] >>= 1;
+    }
+    ucp.reallocations++;
+}
+
+static void ucp_note_access(int tenant, unsigned long long page_id, int hit) {
+    if (hit) ucp.hits[tenant]++; else ucp.misses[tenant]++;
+    if ((tinylfu_hash(page_id) >> (64 - UCP_SAMPLE_SHIFT)) == 0) ucp_umon_access(tenant, page_id);
+    if (++ucp.accesses % ucp.interval == 0) ucp_reallocate();
+}
+
+// 가득 찬 버퍼에서 tenant 의 미스: 희생자 후보를 한 테넌트의 프레임으로 제한한다 (선택 후 victim_bits = NULL)
+static void ucp_restrict_victims(int tenant) {
+    int victim = tenant;
+    if (ucp.occupancy[tenant] < ucp.quota[tenant] || ucp.occupancy[tenant] == 0) {
+        int best_over = INT_MIN;
+        for (int t = 0; t < ucp.num_tenants; t++) {
+            int over = ucp.occupancy[t] - ucp.quota[t];
+            if (ucp.occupancy[t] > 0 && over > best_over) { best_over = over; victim = t; }
+        }
+    }
+    ucp.victim_bits = ucp.tenant_bits[victim];
+    ucp.victim_tenant = victim;
+}
+
+// 미스 처리: 정책별 적재 리스트 결정, 희생자 선택 및 처리, 새 페이지 적재. 적재된 슬롯 반환
+// is_prefetch 가 참이면 선반입(readahead)에 의한 적재로, ARC 고스트 적응을 건너뛴다.
+// 정책별 미스 경로 본체. policy 는 컴파일 타임 상수로 넘겨 정책마다 특수화된 함수로 인스턴스화된다 (POLICY_PATH)
+static inline __attribute__((always_inline)) int load_page_impl(const ReplacementPolicy policy, unsigned long long page_id, int operation_type, int is_prefetch) {
+    int target_slot = -1;
+
+    int actual_load_list_type = 0;
+    int ref_load_list_type = 0;
+    BufferFrame kept_victim = {0}; // TinyLFU 가 후보를 거절했을 때 다시 앉히는 희생자의 원래 상태
+    int reseat_victim = 0;
+    int queue_victim = 0; // 큐 기반 정책 (CLOCK_PRO/S3_FIFO/SIEVE/LIRS) 의 evict 가 고른 희생자 (다시 앉힐 때 제자리로)
+    int tenant = ucp.enabled ? ucp_tenant_of(page_id) : 0;
+
+    if (tinylfu.enabled && !is_prefetch) tinylfu_record(page_id);
+    if (ucp.enabled && !is_prefetch) ucp_note_access(tenant, page_id, 0);
+
+    // --- ARC 파라미터 조정 및 로드될 리스트 결정 --- (enum 심볼 사용으로 자동 대응)
+    PROF_BEGIN(PROF_ADAPT);
+    if (is_prefetch) {
+        // 선반입 페이지는 아직 참조되지 않았으므로 고스트 적중으로 보지 않고 정책의 기본 리스트에 적재
+        if (policy == LFU || policy == LFU_ARC) actual_load_list_type = ref_load_list_type = 3;
+        else if (policy == LRU || policy == LRU_ARC) actual_load_list_type = ref_load_list_type = 1;
+        else if (policy == CLOCK_T1 || policy == CLOCK_PRO_T1_B4_LOGS_B2) actual_load_list_type = 1;
+        else if (policy == CLOCK_T3 || policy == CLOCK_PRO_T3_B2_LOGS_B4) actual_load_list_type = 3;
+    } else if (policy == LRU || policy == LRU_ARC) { // LRU는 7, LRU_ARC는 8
+        int is_in_b1 = find_in_arc_ghost(page_id, arc_state.b1, arc_state.b1_size);
+        int is_in_b2 = find_in_arc_ghost(page_id, arc_state.b2, arc_state.b2_size);
+
+        if (is_in_b1) {
+            ghost_hits[1]++;
+            int delta = (arc_state.b1_size > 0 && arc_state.b2_size >= 0) ? MAX(1, arc_state.b2_size / arc_state.b1_size) : 1;
+            delta = MAX(1, delta);
+            arc_state.p = MIN(buffer_size, arc_state.p + delta);
+            arc_remove_from_ghost(page_id, arc_state.b1, &arc_state.b1_size);
+            actual_load_list_type = 2;
+            ref_load_list_type = 2;
+        } else if (is_in_b2) {
+            ghost_hits[2]++;
+            int delta = (arc_state.b2_size > 0 && arc_state.b1_size >= 0) ? MAX(1, arc_state.b1_size / arc_state.b2_size) : 1;
+            delta = MAX(1, delta);
+            arc_state.p = MAX(0, arc_state.p - delta);
+            arc_remove_from_ghost(page_id, arc_state.b2, &arc_state.b2_size);
+            actual_load_list_type = 2;
+            ref_load_list_type = 2;
+        } else {
+            actual_load_list_type = 1;
+            ref_load_list_type = 1;
+        }
+        if (policy == LRU) actual_load_list_type = 1; // LRU 캐시는 list_type 1
+
+    } else if (policy == LFU || policy == LFU_ARC) { // LFU는 5, LFU_ARC는 6
+        int is_in_b3 = find_in_arc_ghost(page_id, arc_state.b3, arc_state.b3_size);
+        int is_in_b4 = find_in_arc_ghost(page_id, arc_state.b4, arc_state.b4_size);
+
+        if (is_in_b3) {
+            ghost_hits[3]++;
+            int delta = (arc_state.b3_size > 0 && arc_state.b4_size >= 0) ? MAX(1, arc_state.b4_size / arc_state.b3_size) : 1;
+            delta = MAX(1, delta);
+            arc_state.q = MIN(buffer_size, arc_state.q + delta);
+            arc_remove_from_ghost(page_id, arc_state.b3, &arc_state.b3_size);
+            actual_load_list_type = 4;
+            ref_load_list_type = 4;
+        } else if (is_in_b4) {
+            ghost_hits[4]++;
+            int delta = (arc_state.b4_size > 0 && arc_state.b3_size >= 0) ? MAX(1, arc_state.b3_size / arc_state.b4_size) : 1;
+            delta = MAX(1, delta);
+            arc_state.q = MAX(0, arc_state.q - delta);
+            arc_remove_from_ghost(page_id, arc_state.b4, &arc_state.b4_size);
+            actual_load_list_type = 4;
+            ref_load_list_type = 4;
+        } else {
+            actual_load_list_type = 3;
+            ref_load_list_type = 3;
+        }
+        if (policy == LFU) actual_load_list_type = 3; // LFU 캐시는 list_type 3
+
+    } else if (policy == CLOCK_T1) { // CLOCK_T1은 2
+        actual_load_list_type = 1;
+    } else if (policy == CLOCK_T3) { // CLOCK_T3은 3
+        actual_load_list_type = 3;
+    } else if (policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_PRO_T1...은 0
+        actual_load_list_type = 1;
+        if (find_in_arc_ghost(page_id, arc_state.b4, arc_state.b4_size)) {
+            ghost_hits[4]++;
+            int delta_val = (arc_state.t1_size > 0 && arc_state.b4_size > 0) ? MAX(1, arc_state.t1_size / arc_state.b4_size) : 1;
+            if (arc_state.t1_size == 0 && arc_state.b4_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.b4_size);
+            delta_val = MAX(1, delta_val);
+            arc_state.p = MIN(buffer_size, arc_state.p + delta_val);
+            arc_remove_from_ghost(page_id, arc_state.b4, &arc_state.b4_size);
+        } else {
+            int delta_val = (arc_state.t1_size > 0 && arc_state.b4_size > 0) ? MAX(1, arc_state.b4_size / arc_state.t1_size) : 1;
+            if (arc_state.b4_size == 0 && arc_state.t1_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.t1_size);
+            delta_val = MAX(1, delta_val);
+            arc_state.p = MAX(0, arc_state.p - delta_val);
+        }
+    } else if (policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_PRO_T3...은 1
+        actual_load_list_type = 3;
+        if (find_in_arc_ghost(page_id, arc_state.b2, arc_state.b2_size)) {
+            ghost_hits[2]++;
+            int delta_val = (arc_state.t3_size > 0 && arc_state.b2_size > 0) ? MAX(1, arc_state.t3_size / arc_state.b2_size) : 1;
+            if (arc_state.t3_size == 0 && arc_state.b2_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.b2_size);
+            delta_val = MAX(1, delta_val);
+            arc_state.q = MIN(buffer_size, arc_state.q + delta_val);
+            arc_remove_from_ghost(page_id, arc_state.b2, &arc_state.b2_size);
+        } else {
+            int delta_val = (arc_state.t3_size > 0 && arc_state.b2_size > 0) ? MAX(1, arc_state.b2_size / arc_state.t3_size) : 1;
+            if (arc_state.b2_size == 0 && arc_state.t3_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.t3_size);
+            delta_val = MAX(1, delta_val);
+            arc_state.q = MAX(0, arc_state.q - delta_val);
+        }
+    }
+    PROF_END();
+    // FIFO (이제 4)는 별도의 actual_load_list_type 설정 로직이 이 블록에 없음.
+    // 아래 새 페이지 로드 시 FIFO의 list_type은 0으로 설정됨.
+
+    // --- 버퍼 공간 확보 (Eviction) --- (enum 심볼 사용으로 자동 대응)
+    target_slot = find_empty_slot();
+    if (target_slot == -1) {
+        int victim_idx = -1;
+        unsigned long long evicted_page_id = INVALID_PAGE;
+
+        // 정책별 희생자 선택
+        PROF_BEGIN(PROF_VICTIM);
+        if (ucp.enabled) ucp_restrict_victims(tenant); // 큐 기반 정책은 희생자 테넌트의 부분 리스트에서 교체
+        if (policy == FIFO) victim_idx = evict_fifo(); // FIFO는 4
+        else if (policy == LRU) victim_idx = evict_arc_internal_lru(1); // LRU는 7
+        else if (policy == LFU) victim_idx = evict_arc_internal_lfu(3); // LFU는 5
+        else if (policy == LRU_ARC) victim_idx = arc_find_victim_lru_arc(page_id); // LRU_ARC는 8
+        else if (policy == LFU_ARC) victim_idx = arc_find_victim_lfu_arc(page_id); // LFU_ARC는 6
+        else if (policy == CLOCK_T1) victim_idx = evict_via_clock_policy(&global_clk_hand, 0, 0, buffer_size, policy_names[policy]); // CLOCK_T1은 2
+        else if (policy == CLOCK_T3) victim_idx = evict_via_clock_policy(&global_clk_hand, 0, 0, buffer_size, policy_names[policy]); // CLOCK_T3은 3
+        else if (policy == CLOCK_PRO) victim_idx = clockpro_evict();
+        else if (policy == S3_FIFO) victim_idx = s3fifo_evict();
+        else if (policy == SIEVE) victim_idx = sieve_evict();
+        else if (policy == LIRS) victim_idx = lirs_evict();
+        else if (policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_PRO_T1...은 0
+             while (arc_state.t1_size >= arc_state.p && arc_state.t1_size > 0) {
+                 victim_idx = evict_via_clock_policy(&arc_state.p_clk_hand, 1, 1, buffer_size, policy_names[policy]);
+                 if (victim_idx != -1) break;
+                 fprintf(stderr, "CLOCK_PRO_T1 Warning: Could not find victim in T1 despite T1 size >= p. Check state.\n");
+                 break;
+             }
+             if (victim_idx == -1) {
+                 victim_idx = evict_via_clock_policy(&arc_state.p_clk_hand, 0, 0, buffer_size, "CLOCK_PRO_T1_Fallback");
+             }
+        } else if (policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_PRO_T3...은 1
+             while (arc_state.t3_size >= arc_state.q && arc_state.t3_size > 0) {
+                 victim_idx = evict_via_clock_policy(&arc_state.q_clk_hand, 1, 3, buffer_size, policy_names[policy]);
+                 if (victim_idx != -1) break;
+                 fprintf(stderr, "CLOCK_PRO_T3 Warning: Could not find victim in T3 despite T3 size >= q. Check state.\n");
+                 break;
+             }
+             if (victim_idx == -1) {
+                 victim_idx = evict_via_clock_policy(&arc_state.q_clk_hand, 0, 0, buffer_size, "CLOCK_PRO_T3_Fallback");
+             }
+        }
+
+        queue_victim = (victim_idx != -1 && (policy == CLOCK_PRO || policy == S3_FIFO || policy == SIEVE || policy == LIRS));
+
+        // 최종 희생자 선택 실패 시 Fallback
+        if (victim_idx == -1 && buffer_size > 0) {
+             victim_idx = evict_fifo();
+             if (victim_idx != -1 && buffer[victim_idx].page_id != INVALID_PAGE) {
+                 int list_of_fifo_victim = frame_list(victim_idx);
+                 if (policy == CLOCK_PRO) clockpro_drop(victim_idx);
+                 else if (policy == S3_FIFO || policy == SIEVE) fifoq_drop(victim_idx);
+                 else if (policy == LIRS) lirs_drop(victim_idx);
+                 if (policy == LRU_ARC || policy == LRU || policy == CLOCK_PRO_T1_B4_LOGS_B2 || policy == CLOCK_T1) {
+                     if (list_of_fifo_victim == 1 && arc_state.t1_size > 0) arc_state.t1_size--;
+                     else if (list_of_fifo_victim == 2 && arc_state.t2_size > 0) arc_state.t2_size--;
+                 }
+                 if (policy == LFU_ARC || policy == LFU || policy == CLOCK_PRO_T3_B2_LOGS_B4 || policy == CLOCK_T3) {
+                     if (list_of_fifo_victim == 3 && arc_state.t3_size > 0) arc_state.t3_size--;
+                     else if (list_of_fifo_victim == 4 && arc_state.t4_size > 0) arc_state.t4_size--;
+                 }
+             }
+        }
+        ucp.victim_bits = NULL;
+
+        PROF_END();
+
+        // TinyLFU 승인: 후보가 희생자보다 자주 쓰이지 않으면 후보를 버리고 희생자를 같은 프레임에 다시 적재한다.
+        // 정책 상태는 교체와 똑같이 갱신한 뒤 (I/O 없이) 적재 경로를 선반입처럼(참조 없이) 다시 태우고,
+        // 접근 시각/횟수/더티 상태는 되돌려 LRU/LFU/FIFO 에서는 순서가 그대로 남는다.
+        // 큐 기반 정책은 새 페이지로 다시 넣지 않고 *_restore 로 희생자를 교체 직전 자리에 되돌린다.
+        if (tinylfu.enabled && !is_prefetch && victim_idx != -1 && buffer[victim_idx].page_id != INVALID_PAGE &&
+            !tinylfu_admit(page_id, buffer[victim_idx].page_id)) {
+            if (operation_type == OP_WRITE) { write_back_page(page_id); tinylfu.write_arounds++; }
+            if (buffer[victim_idx].is_dirty) tinylfu.kept_dirty++;
+            kept_victim = buffer[victim_idx];
+            reseat_victim = 1;
+            page_id = kept_victim.page_id;
+            actual_load_list_type = frame_list(victim_idx);
+            ref_load_list_type = kept_victim.ref_arc_list_type;
+            operation_type = OP_READ;
+            is_prefetch = 1;
+        }
+
+        // 희생자 처리 (다시 앉힐 희생자는 I/O 없이 리스트 회계만)
+        if (victim_idx != -1) {
+            if (!reseat_victim) {
+                if (buffer[victim_idx].page_id != INVALID_PAGE) evictions++;
+                if (ucp.enabled && buffer[victim_idx].page_id != INVALID_PAGE) {
+                    ucp.evicted[ucp.frame_tenant[victim_idx]]++;
+                    if (ucp.frame_tenant[victim_idx] != tenant) ucp.stolen[ucp.frame_tenant[victim_idx]]++;
+                }
+                if (buffer[victim_idx].page_id != INVALID_PAGE && buffer[victim_idx].is_dirty) {
+                    if (is_prefetch) readahead.dirty_evictions++; // 선반입 적재는 요청을 막지 않으므로 stall 로 세지 않음
+                    else dirty_eviction_stalls++;
+                    if (zone_size_pages_global > 0 && !lsl.enabled) {
+                        if (writeback_is_sequential(buffer[victim_idx].page_id)) evict_seq_writebacks++;
+                        else evict_nonseq_writebacks++;
+                    }
+                }
+                if (buffer[victim_idx].prefetched) readahead_note_wasted(victim_idx);
+                handle_dirty_eviction(victim_idx); // ZNS 제약 검사는 handle_dirty_eviction -> write_fio_log 에서 처리
+            }
+            evicted_page_id = buffer[victim_idx].page_id;
+
+            // --- 정책별 고스트 리스트 및 로그/히스토리 업데이트 --- (enum 심볼 사용으로 자동 대응)
+            if (policy == LRU && evicted_page_id != INVALID_PAGE) { // LRU는 7
+                if (buffer[victim_idx].ref_arc_list_type == 1) {
+                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b1, &arc_state.b1_size, buffer_size);
+                    if(arc_state.t1_size > 0) arc_state.t1_size--;
+                } else if (buffer[victim_idx].ref_arc_list_type == 2) {
+                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b2, &arc_state.b2_size, buffer_size);
+                    if(arc_state.t2_size > 0) arc_state.t2_size--;
+                }
+            } else if (policy == LFU && evicted_page_id != INVALID_PAGE) { // LFU는 5
+                 if (buffer[victim_idx].ref_arc_list_type == 3) {
+                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b3, &arc_state.b3_size, buffer_size);
+                    if(arc_state.t3_size > 0) arc_state.t3_size--;
+                } else if (buffer[victim_idx].ref_arc_list_type == 4) {
+                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size);
+                    if(arc_state.t4_size > 0) arc_state.t4_size--;
+                }
+            }
+            else if (policy == CLOCK_PRO_T1_B4_LOGS_B2 && evicted_page_id != INVALID_PAGE) { // CLOCK_PRO_T1...은 0
+                arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size); // B4는 히스토리
+                arc_add_to_ghost_mru(evicted_page_id, arc_state.b2, &arc_state.b2_size, buffer_size); // B2는 로그
+                if(arc_state.t1_size > 0 && frame_list(victim_idx) == 1) arc_state.t1_size--;
+            } else if (policy == CLOCK_PRO_T3_B2_LOGS_B4 && evicted_page_id != INVALID_PAGE) { // CLOCK_PRO_T3...은 1
+                arc_add_to_ghost_mru(evicted_page_id, arc_state.b2, &arc_state.b2_size, buffer_size); // B2는 히스토리
+                arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size); // B4는 로그
+                if(arc_state.t3_size > 0 && frame_list(victim_idx) == 3) arc_state.t3_size--;
+            }
+
+            set_frame_page(victim_idx, INVALID_PAGE);
+            target_slot = victim_idx;
+        }
+    }
+
+    // --- 새 페이지 로드 ---
+    if (target_slot != -1) {
+        set_frame_page(target_slot, page_id);
+        buffer[target_slot].load_time = current_time;
+        buffer[target_slot].last_access_time = current_time;
+        buffer[target_slot].access_count = 1;
+        buffer[target_slot].is_dirty = (operation_type == OP_WRITE); // 쓰기 미스 시 dirty 설정 (Write Allocate)
+        if (operation_type == OP_WRITE) dirty_pages++;
+        set_frame_list(target_slot, actual_load_list_type); // 위에서 결정된 actual_load_list_type 사용
+        set_frame_ref(target_slot, is_prefetch ? 0 : 1); // CLOCK 계열을 위해 기본적으로 1로 설정 (선반입은 참조 전이므로 0)
+        buffer[target_slot].prefetched = 0;
+
+        // 정책별 리스트 크기 및 참조 상태 업데이트 (enum 심볼 사용으로 자동 대응)
+        if (policy == LRU) { // LRU는 7
+            buffer[target_slot].ref_arc_list_type = ref_load_list_type;
+            if (ref_load_list_type == 1) arc_state.t1_size++; else if (ref_load_list_type == 2) arc_state.t2_size++;
+        } else if (policy == LFU) { // LFU는 5
+            buffer[target_slot].ref_arc_list_type = ref_load_list_type;
+            if (ref_load_list_type == 3) arc_state.t3_size++; else if (ref_load_list_type == 4) arc_state.t4_size++;
+        }
+        else if (policy == LRU_ARC) { // LRU_ARC는 8
+            buffer[target_slot].ref_arc_list_type = 0; // ARC 자체이므로 ref_arc_list_type 불필요
+            if (actual_load_list_type == 1) arc_state.t1_size++; else if (actual_load_list_type == 2) arc_state.t2_size++;
+        } else if (policy == LFU_ARC) { // LFU_ARC는 6
+            buffer[target_slot].ref_arc_list_type = 0; // ARC 자체이므로 ref_arc_list_type 불필요
+            if (actual_load_list_type == 3) arc_state.t3_size++; else if (actual_load_list_type == 4) arc_state.t4_size++;
+        } else if (policy == CLOCK_T1) { // CLOCK_T1은 2
+             buffer[target_slot].ref_arc_list_type = 0;
+             set_frame_list(target_slot, 1); // T1 캐시
+             if (arc_state.t1_size < buffer_size) arc_state.t1_size++;
+        } else if (policy == CLOCK_T3) { // CLOCK_T3은 3
+             buffer[target_slot].ref_arc_list_type = 0;
+             set_frame_list(target_slot, 3); // T3 캐시
+             if (arc_state.t3_size < buffer_size) arc_state.t3_size++;
+        } else if (policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_PRO_T1...은 0
+            buffer[target_slot].ref_arc_list_type = 0;
+            set_frame_list(target_slot, 1); // T1 캐시
+            if (arc_state.t1_size < buffer_size) arc_state.t1_size++;
+            arc_add_to_ghost_mru(page_id, arc_state.b2, &arc_state.b2_size, buffer_size); // b2는 로그
+        } else if (policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_PRO_T3...은 1
+            buffer[target_slot].ref_arc_list_type = 0;
+            set_frame_list(target_slot, 3); // T3 캐시
+            if (arc_state.t3_size < buffer_size) arc_state.t3_size++;
+            arc_add_to_ghost_mru(page_id, arc_state.b4, &arc_state.b4_size, buffer_size); // b4는 로그
+        } else if (policy == CLOCK_PRO) {
+            buffer[target_slot].ref_arc_list_type = 0;
+            set_frame_ref(target_slot, 0); // 적재 자체는 참조로 치지 않음 (다음 접근이 재사용 거리를 결정)
+            if (reseat_victim && queue_victim) clockpro_restore(target_slot, page_id);
+            else clockpro_admit(target_slot, page_id, is_prefetch);
+        } else if (policy == S3_FIFO || policy == SIEVE) {
+            buffer[target_slot].ref_arc_list_type = 0;
+            set_frame_ref(target_slot, 0); // SIEVE 방문 비트는 적재 후 첫 히트에서 세움
+            if (reseat_victim && queue_victim) fifoq_restore(policy, target_slot, page_id);
+            else fifoq_admit(policy, target_slot, page_id, is_prefetch);
+        } else if (policy == LIRS) {
+            buffer[target_slot].ref_arc_list_type = 0;
+            set_frame_ref(target_slot, 0);
+            if (reseat_victim && queue_victim) lirs_restore(target_slot, page_id);
+            else lirs_admit(target_slot, page_id, is_prefetch);
+        } else if (policy == FIFO) { // FIFO는 4
+             buffer[target_slot].ref_arc_list_type = 0;
+             set_frame_ref(target_slot, 0); // FIFO는 ref_bit 사용 안 함
+             set_frame_list(target_slot, 0); // FIFO의 경우 list_type을 0으로 설정 (실제 정책과 무관한 기본값)
+                                                 // 또는 FIFO 고유 list_type (예: 4)을 사용하려면 여기서 설정
+        }
+        if (tinylfu.enabled) tinylfu.kept[target_slot] = 0;
+        if (reseat_victim) {
+            buffer[target_slot].load_time = kept_victim.load_time;
+            buffer[target_slot].last_access_time = kept_victim.last_access_time;
+            buffer[target_slot].access_count = kept_victim.access_count;
+            buffer[target_slot].is_dirty = kept_victim.is_dirty; // dirty_pages 는 그대로 (write-back 하지 않았음)
+            buffer[target_slot].prefetched = kept_victim.prefetched;
+            tinylfu.kept[target_slot] = 1;
+            // 희생자 선택/처리에서 넣은 고스트 항목을 지운다 (상주 페이지가 고스트에 남지 않도록)
+            if (policy == LRU || policy == LRU_ARC) {
+                arc_remove_from_ghost(page_id, arc_state.b1, &arc_state.b1_size);
+                arc_remove_from_ghost(page_id, arc_state.b2, &arc_state.b2_size);
+            } else if (policy == LFU || policy == LFU_ARC) {
+                arc_remove_from_ghost(page_id, arc_state.b3, &arc_state.b3_size);
+                arc_remove_from_ghost(page_id, arc_state.b4, &arc_state.b4_size);
+            } else if (policy == CLOCK_PRO_T1_B4_LOGS_B2) {
+                arc_remove_from_ghost(page_id, arc_state.b4, &arc_state.b4_size); // B2 로그에는 상주 페이지도 남음
+            } else if (policy == CLOCK_PRO_T3_B2_LOGS_B4) {
+                arc_remove_from_ghost(page_id, arc_state.b2, &arc_state.b2_size);
+            }
+            return -1;
+        }
+    } else if (buffer_size > 0) {
+        // fprintf(stderr, "CRITICAL Error: Failed to find or create a slot for page %llu. Policy: %s\n", page_id, policy_names[policy]);
+    }
+    return target_slot;
+}
+
+// 캐시 히트 처리: 접근 시간/횟수, 더티 표시, 정책별 승격 (load_page_impl 과 같이 정책마다 특수화)
+static inline __attribute__((always_inline)) void access_hit_impl(const ReplacementPolicy policy, int frame_idx, int operation_type) {
+    hits++;
+    if (tinylfu.enabled) tinylfu_note_hit(frame_idx);
+    if (ucp.enabled) ucp_note_access(ucp.frame_tenant[frame_idx], buffer[frame_idx].page_id, 1);
+    // 선반입된 페이지의 첫 참조는 정책 입장에서 첫 적재와 같으므로 승격하지 않음
+    int first_touch = buffer[frame_idx].prefetched;
+    if (first_touch) readahead_note_hit(frame_idx);
+    buffer[frame_idx].last_access_time = current_time;
+    if (!first_touch && buffer[frame_idx].access_count < UINT_MAX) {
+        buffer[frame_idx].access_count++;
+    }
+    if (operation_type == OP_WRITE && !buffer[frame_idx].is_dirty) {
+        buffer[frame_idx].is_dirty = 1;
+        dirty_pages++;
+    }
+
+    // --- 실제 정책에 따른 히트 처리 --- (enum 심볼 사용으로 자동 대응)
+    if (first_touch) {
+        if (policy != FIFO) set_frame_ref(frame_idx, 1);
+    } else if (policy == LRU_ARC) { // LRU_ARC는 이제 8
+        if (frame_list(frame_idx) == 1) {
+            set_frame_list(frame_idx, 2);
+            if(arc_state.t1_size > 0) arc_state.t1_size--;
+            arc_state.t2_size++;
+        }
+    } else if (policy == LFU_ARC) { // LFU_ARC는 이제 6
+        if (frame_list(frame_idx) == 3) {
+            set_frame_list(frame_idx, 4);
+            if(arc_state.t3_size > 0) arc_state.t3_size--;
+            arc_state.t4_size++;
+        }
+    }
+    // --- 참조용 ARC 상태 업데이트 (LRU/LFU 정책 활성화 시) ---
+    else if (policy == LRU) { // LRU는 이제 7
+        if (buffer[frame_idx].ref_arc_list_type == 1) {
+            buffer[frame_idx].ref_arc_list_type = 2;
+            if (arc_state.t1_size > 0) arc_state.t1_size--;
+            arc_state.t2_size++;
+        }
+    } else if (policy == LFU) { // LFU는 이제 5
+        if (buffer[frame_idx].ref_arc_list_type == 3) {
+            buffer[frame_idx].ref_arc_list_type = 4;
+            if (arc_state.t3_size > 0) arc_state.t3_size--;
+            arc_state.t4_size++;
+        }
+    }
+    // --- CLOCK 계열 정책 히트 처리 ---
+    else if (policy == CLOCK_T1 || policy == CLOCK_T3 ||
+               policy == CLOCK_PRO_T1_B4_LOGS_B2 || policy == CLOCK_PRO_T3_B2_LOGS_B4 || policy == CLOCK_PRO || policy == SIEVE) {
+        set_frame_ref(frame_idx, 1);
+    } else if (policy == S3_FIFO) {
+        if (fifoq.freq[frame_idx] < S3FIFO_MAX_FREQ) fifoq.freq[frame_idx]++;
+    } else if (policy == LIRS) {
+        lirs_hit(frame_idx);
+    }
+}
+
+// 정책마다 load_page_impl/access_hit_impl 을 상수 정책으로 인스턴스화 -> 정책 비교 분기가 컴파일 시 사라진 전용 경로.
+// 정책 전환(switch_policy)이나 상태 초기화/복원 때 select_policy_path() 로 한 번만 고르고, 접근마다 다시 분기하지 않는다
+#define POLICY_PATH(P) \
+    static int load_page_##P(unsigned long long page_id, int operation_type, int is_prefetch) { \
+        return load_page_impl(P, page_id, operation_type, is_prefetch); \
+    } \
+    static void access_hit_##P(int frame_idx, int operation_type) { access_hit_impl(P, frame_idx, operation_type); }
+#define POLICY_PATH_ENTRY(P) [P] = { load_page_##P, access_hit_##P },
+FOR_EACH_POLICY(POLICY_PATH)
+
+static const PolicyPath policy_paths[NUM_POLICIES] = { FOR_EACH_POLICY(POLICY_PATH_ENTRY) };
+
+void select_policy_path() {
+    policy_path = &policy_paths[current_policy];
+}
+
+int load_page_into_buffer(unsigned long long page_id, int operation_type, int is_prefetch) {
+    return policy_path->load(page_id, operation_type, is_prefetch);
+}
+
+// 핵심 페이지 접근 함수 (write_fio_log 호출 시 ZNS 제약 검사 수행됨)
+void access_page(unsigned long long lba_address, unsigned long long page_id, int operation_type) {
+    current_time++;
+    PROF_BEGIN(PROF_INDEX);
+    int found_idx = find_in_buffer(page_id);
+    PROF_END();
+
+    if (page_id == INVALID_PAGE) return;
+
+    if (found_idx != -1) {
+        policy_path->hit(found_idx, operation_type);
+    } else {
+        misses++;
+        // 읽기 미스 시 디스크 읽기 시뮬레이션 (FIO 로그)
+        // 쓰기 미스는 Write Allocate 정책 가정: 먼저 읽고 버퍼에 로드
+        read_page_from_device(page_id);
+        policy_path->load(page_id, operation_type, 0);
+    }
+
+    // 순차/stride 스트림이면 다음 페이지들을 선반입
+    if (readahead.enabled) readahead_on_access(page_id, operation_type);
+
+    // 더티 프레임이 high watermark 에 도달하면 백그라운드 flush
+    if (flusher.enabled) flusher_maybe_run();
+}
+
+// 여러 페이지에 걸친 요청 처리. RANGE_PROBE_BATCH 페이지씩 인덱스를 먼저 한꺼번에 조회하고,
+// 연속된 미스 구간은 한 번의 읽기 I/O 로 묶는다. 페이지마다 히트/미스는 따로 집계된다.
+void access_range(unsigned long long first_page_id, unsigned long long num_pages, int operation_type) {
+    int probes[RANGE_PROBE_BATCH];
+    for (unsigned long long base = 0; base < num_pages; base += RANGE_PROBE_BATCH) {
+        int batch = (int)MIN((unsigned long long)RANGE_PROBE_BATCH, num_pages - base);
+        unsigned long long batch_first = first_page_id + base;
+        PROF_BEGIN(PROF_INDEX);
+        for (int i = 0; i < batch; i++) probes[i] = find_in_buffer(batch_first + i);
+        PROF_END();
+
+        int i = 0;
+        while (i < batch) {
+            unsigned long long page_id = batch_first + i;
+            // 앞선 미스 적재로 축출됐을 수 있으므로 조회 결과를 재확인
+            if (probes[i] != -1 && buffer[probes[i]].page_id == page_id) {
+                current_time++;
+                policy_path->hit(probes[i], operation_type);
+                i++;
+                continue;
+            }
+            int run_len = 1;
+            while (i + run_len < batch &&
+                   (probes[i + run_len] == -1 || buffer[probes[i + run_len]].page_id != page_id + run_len)) run_len++;
+            read_pages_from_device(page_id, run_len);
+            for (int k = 0; k < run_len; k++) {
+                current_time++;
+                misses++;
+                policy_path->load(page_id + k, operation_type, 0);
+            }
+            i += run_len;
+        }
+    }
+
+    if (readahead.enabled) {
+        for (unsigned long long k = 0; k < num_pages; k++) readahead_on_access(first_page_id + k, operation_type);
+    }
+    if (flusher.enabled) flusher_maybe_run();
+}
+
+/* // 버퍼 상태 출력 함수 전체 주석 처리 시작
+void print_buffer_state() {
+    // ... (내용 동일) ...
+}
+*/ // 버퍼 상태 출력 함수 전체 주석 처리 끝
+
+
+// 정책 전환: 이전 정책의 상태 일부를 이어받고 버퍼 프레임의 리스트 구성을 새 정책에 맞게 재설정
+void switch_policy(ReplacementPolicy new_policy, int verbose) {
+    ReplacementPolicy old_policy = current_policy;
+    previous_policy_for_state_carryover = old_policy;
+    current_policy = new_policy; // current_policy 업데이트
+    select_policy_path();
+
+    int reset_arc_completely = 1;
+    // 상태 이전 로직 (enum 심볼 사용으로 자동 대응)
+    if ((old_policy == LRU && new_policy == LRU_ARC) || (old_policy == LRU_ARC && new_policy == LRU)) {
+        reset_arc_completely = 0;
+        if (verbose) printf("INFO: LRU <-> LRU_ARC 전환. p, B1, B2 상태를 이어받습니다.\n");
+    }
+    else if ((old_policy == LFU && new_policy == LFU_ARC) || (old_policy == LFU_ARC && new_policy == LFU)) {
+        reset_arc_completely = 0;
+        if (verbose) printf("INFO: LFU <-> LFU_ARC 전환. q, B3, B4 상태를 이어받습니다.\n");
+    }
+
+    initialize_arc_state(reset_arc_completely); // 변경된 current_policy에 따라 ARC 상태 다시 초기화/조정
+
+    // 버퍼 프레임 상태 재설정 (list_type, ref_arc_list_type, t1/t2/t3/t4_size 조정)
+    // 이 부분은 current_policy (new_policy)를 기준으로 동작하므로 enum 심볼에 의해 자동 대응.
+    // 다만, 각 정책에 할당되는 list_type 값의 의도를 다시 한번 확인하는 것이 좋음.
+    arc_state.t1_size = 0; arc_state.t2_size = 0;
+    arc_state.t3_size = 0; arc_state.t4_size = 0;
+
+    for (int i = 0; i < buffer_size; i++) {
+        if (buffer[i].page_id != INVALID_PAGE) {
+            set_frame_ref(i, 0); // 기본적으로 ref_bit 초기화
+            buffer[i].ref_arc_list_type = 0; // 기본적으로 초기화
+
+            if (new_policy == LRU) { // LRU는 7
+                set_frame_list(i, 1); // LRU의 주 캐시 리스트 타입
+                if (old_policy == LRU_ARC && (frame_list(i) == 1 || frame_list(i) == 2)) { // 이전 list_type을 ref_arc_list_type으로 사용
+                     buffer[i].ref_arc_list_type = frame_list(i); // 이전 list_type 값이 1 또는 2였을 것임.
+                } else {
+                    buffer[i].ref_arc_list_type = 1; // 기본 T1_ref
+                }
+                if(buffer[i].ref_arc_list_type == 1) arc_state.t1_size++; else arc_state.t2_size++;
+            } else if (new_policy == LFU) { // LFU는 5
+                set_frame_list(i, 3); // LFU의 주 캐시 리스트 타입
+                if (old_policy == LFU_ARC && (frame_list(i) == 3 || frame_list(i) == 4)) {
+                     buffer[i].ref_arc_list_type = frame_list(i);
+                } else {
+                    buffer[i].ref_arc_list_type = 3; // 기본 T3_ref
+                }
+                if(buffer[i].ref_arc_list_type == 3) arc_state.t3_size++; else arc_state.t4_size++;
+            } else if (new_policy == LRU_ARC) { // LRU_ARC는 8
+                if (old_policy == LRU && (buffer[i].ref_arc_list_type == 1 || buffer[i].ref_arc_list_type == 2)) {
+                    set_frame_list(i, buffer[i].ref_arc_list_type); // LRU의 ref_arc_list_type을 list_type으로
+                } else {
+                    set_frame_list(i, 1); // 기본 T1
+                }
+                if(frame_list(i) == 1) arc_state.t1_size++; else arc_state.t2_size++;
+            } else if (new_policy == LFU_ARC) { // LFU_ARC는 6
+                 if (old_policy == LFU && (buffer[i].ref_arc_list_type == 3 || buffer[i].ref_arc_list_type == 4)) {
+                    set_frame_list(i, buffer[i].ref_arc_list_type);
+                } else {
+                    set_frame_list(i, 3); // 기본 T3
+                }
+                if(frame_list(i) == 3) arc_state.t3_size++; else arc_state.t4_size++;
+            } else if (new_policy == CLOCK_T1 || new_policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_T1=2, CLOCK_PRO_T1=0
+                set_frame_list(i, 1); // T1 캐시
+                arc_state.t1_size++;
+                set_frame_ref(i, 1); // CLOCK 계열은 ref_bit 1로 시작
+            } else if (new_policy == CLOCK_T3 || new_policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_T3=3, CLOCK_PRO_T3=1
+                set_frame_list(i, 3); // T3 캐시
+                arc_state.t3_size++;
+                set_frame_ref(i, 1); // CLOCK 계열은 ref_bit 1로 시작
+            } else if (new_policy == FIFO) { // FIFO는 4
+                set_frame_list(i, 0); // FIFO는 별도 list_type 구분 없음 (또는 FIFO 고유값 사용)
+                // FIFO는 ref_bit 사용 안하므로 위에서 0으로 초기화된 값 유지.
+            } else if (new_policy == CLOCK_PRO) {
+                set_frame_list(i, 0); // hot/cold 상태는 clockpro_rebuild 가 CLOCK-Pro 노드에 기록
+            } else if (new_policy == S3_FIFO || new_policy == SIEVE) {
+                set_frame_list(i, 0); // 큐 위치는 fifoq_rebuild 가 기록
+            } else if (new_policy == LIRS) {
+                set_frame_list(i, 0); // LIR/HIR 상태는 lirs_rebuild 가 기록
+            }
+        }
+    }
+    if (new_policy == CLOCK_PRO) clockpro_rebuild();
+    else if (new_policy == S3_FIFO || new_policy == SIEVE) fifoq_rebuild(new_policy);
+    else if (new_policy == LIRS) lirs_rebuild();
+    arc_state.p_clk_hand = 0; arc_state.q_clk_hand = 0; global_clk_hand = 0;
+
+    if (verbose) printf("--- 정책 변경 완료: %s ---\n", policy_names[current_policy]);
+    // print_buffer_state();
+}
+
+// 트레이스의 P 레코드 적용 (requests: 지금까지 처리한 요청 수): 잘못된 코드면 경고 후 -1, 정책이 바뀌면 1, 그대로면 0.
+// 샤드 분배기는 현재 정책만 따라가고 (전환은 레코드를 받은 각 샤드가 함), 단일 재생은 epoch 를 마감하고 전환한다.
+int apply_policy_record(int code, int line_num, unsigned long long requests) {
+    if (!policy_code_valid(code)) {
+        fprintf(stderr, "경고: (라인 %d) 잘못된 정책 코드 %d. 유효 범위: %d-%d, %d-%d. 무시.\n", line_num, code,
+                CLOCK_PRO_T1_B4_LOGS_B2, SYNTHETIC - 1, SYNTHETIC + 1, NUM_POLICIES - 1);
+        return -1;
+    }
+    ReplacementPolicy old_policy = current_policy;
+    ReplacementPolicy new_policy = (ReplacementPolicy)code;
+    if (old_policy == new_policy) return 0;
+    if (shard.count > 1) {
+        printf("\nINFO: (라인 %d) 정책 변경 감지: %s ===> %s (샤드 %d개에 전달)\n",
+               line_num, policy_names[old_policy], policy_names[new_policy], shard.count);
+        current_policy = new_policy;
+        return 1;
+    }
+    printf("\nINFO: (라인 %d) 정책 변경 감지: %s ===> %s\n", line_num, policy_names[old_policy], policy_names[new_policy]);
+    device_epoch_report(line_num - 1);
+    metrics_emit_epoch(requests, line_num - 1);
+    switch_policy(new_policy, 1);
+    return 1;
+}
+
+// 트레이스 요청 하나를 시뮬레이션. 접근한 페이지 수를 반환 (길이가 잘못되어 무시한 요청이면 0)
+unsigned long long simulate_request(const TraceRecord *rec, int line_num) {
+    unsigned long long lba_address_val = rec->lba, len_sectors_val = rec->len_sectors;
+    int operation_type_val = rec->operation_type;
+    unsigned long long page_id_val = lba_to_page_id(lba_address_val), num_pages = 1;
+    if (len_sectors_val > 0) {
+        // 선택적 길이 필드 (섹터 단위): 걸쳐 있는 모든 페이지를 한 번에 처리
+        if (!trace_request_length_ok(rec, line_num)) return 0;
+        unsigned long long last_page_val = lba_to_page_id(lba_address_val + len_sectors_val - 1);
+        num_pages = last_page_val - page_id_val + 1;
+        PROF_BEGIN(PROF_OTHER);
+        device_request_begin(num_pages, rec->has_time, rec->time_ns);
+        access_range(page_id_val, num_pages, operation_type_val);
+    } else {
+        PROF_BEGIN(PROF_OTHER);
+        device_request_begin(1, rec->has_time, rec->time_ns);
+        access_page(lba_address_val, page_id_val, operation_type_val); // ZNS 검사는 access_page -> handle_dirty_eviction -> write_fio_log 에서 처리됨
+    }
+    device_request_end();
+    PROF_END();
+    return num_pages;
+}
+
+// 요청의 첫 페이지가 들어 있을 page_index 버킷을 캐시로 당겨옴
+static inline void prefetch_request_slot(const TraceRecord *rec) {
+    unsigned long long pos = u64map_slot(lba_to_page_id(rec->lba), page_index.capacity);
+    __builtin_prefetch(&page_index.keys[pos]);
+    __builtin_prefetch(&page_index.values[pos]);
+}
+
+// 버킷의 첫 슬롯이 그 페이지면 프레임도 당겨옴. 선형 탐사 뒤쪽이나 미스는 건너뜀.
+// 키를 실제로 읽으므로, 버킷이 이미 캐시에 와 있도록 앞선 반복에서 prefetch_request_slot 한 요청에만 부른다
+static inline void prefetch_request_frame(const TraceRecord *rec) {
+    unsigned long long page_id = lba_to_page_id(rec->lba);
+    unsigned long long pos = u64map_slot(page_id, page_index.capacity);
+    if (page_index.keys[pos] == page_id) __builtin_prefetch(&buffer[page_index.values[pos]], 1);
+}
+
+// 파싱된 요청 배열을 순서대로 simulate_request 로 처리 (결과는 요청마다 pages[i]).
+// 처리 순서와 결과는 하나씩 부를 때와 같고, 앞선 요청의 색인 버킷/프레임을 미리 당겨 캐시 미스 지연을 겹친다.
+// 두 단계: 반복 i 에서 요청 i+AHEAD 의 버킷을 prefetch 하고, 그 버킷이 AHEAD/2 반복 전에 요청된 요청 i+AHEAD/2 의 키를 읽어 프레임을 prefetch.
+// 배치 첫머리에서 한꺼번에 버킷을 요청한 요청들은 아직 버킷이 오지 않았을 수 있으므로 프레임 단계를 건너뜀
+void access_batch(const TraceRecord *recs, const int *line_nums, int count, unsigned long long *pages) {
+    for (int i = 0; i < MIN(count, ACCESS_PREFETCH_AHEAD); i++) prefetch_request_slot(&recs[i]);
+    for (int i = 0; i < count; i++) {
+        int frame_ahead = i + ACCESS_PREFETCH_AHEAD / 2;
+        if (i + ACCESS_PREFETCH_AHEAD < count) prefetch_request_slot(&recs[i + ACCESS_PREFETCH_AHEAD]);
+        if (frame_ahead >= ACCESS_PREFETCH_AHEAD && frame_ahead < count) prefetch_request_frame(&recs[frame_ahead]);
+        pages[i] = simulate_request(&recs[i], line_nums[i]);
+    }
+}
+
+// --- 초 단위 시계열 ---
+
+static TimeSeriesBucket* timeseries_bucket(unsigned long long t_ns) {
+    unsigned long long sec = t_ns / 1000000000ULL;
+    if (sec >= timeseries.capacity) {
+        unsigned long long capacity = MAX(64ULL, timeseries.capacity);
+        while (capacity <= sec) capacity *= 2;
+        TimeSeriesBucket *grown = (TimeSeriesBucket*)realloc(timeseries.buckets, capacity * sizeof(TimeSeriesBucket));
+        if (grown == NULL) {
+            fprintf(stderr, "Error: Failed to grow time series to %llu seconds.\n", capacity);
+            exit(EXIT_FAILURE);
+        }
+        memset(grown + timeseries.capacity, 0, (capacity - timeseries.capacity) * sizeof(TimeSeriesBucket));
+        timeseries.buckets = grown;
+        timeseries.capacity = capacity;
+    }
+    if (sec >= timeseries.count) timeseries.count = sec + 1;
+    return &timeseries.buckets[sec];
+}
+
+void timeseries_record(unsigned long long arrival_ns, unsigned long long done_ns, unsigned long long hit_pages, unsigned long long miss_pages) {
+    TimeSeriesBucket *in = timeseries_bucket(arrival_ns);
+    in->arrivals++;
+    in->hits += hit_pages;
+    in->misses += miss_pages;
+    in->dirty_pages = dirty_pages;
+    TimeSeriesBucket *out = timeseries_bucket(done_ns);
+    out->completions++;
+    out->latency_sum_ns += done_ns - arrival_ns;
+}
+
+// CSV: 초, 도착, 완료(=처리량), 히트율, 초 끝의 backlog(도착했지만 끝나지 않은 요청), 평균 지연, 더티 프레임
+int timeseries_write(const char *path) {
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) return -1;
+    fprintf(fp, "second,arrivals,completions,hit_rate,backlog,mean_latency_us,dirty_pages\n");
+    unsigned long long backlog = 0;
+    int last_dirty = 0;
+    for (unsigned long long i = 0; i < timeseries.count; i++) {
+        const TimeSeriesBucket *b = &timeseries.buckets[i];
+        backlog += b->arrivals - b->completions;
+        if (b->arrivals > 0) last_dirty = b->dirty_pages;
+        unsigned long long pages = b->hits + b->misses;
+        fprintf(fp, "%llu,%llu,%llu,%.4f,%llu,%.1f,%d\n", i, b->arrivals, b->completions,
+                (pages == 0) ? 0.0 : (double)b->hits / pages, backlog,
+                (b->completions == 0) ? 0.0 : (double)b->latency_sum_ns / b->completions / 1000.0, last_dirty);
+    }
+    fclose(fp);
+    return 0;
+}
+
+void timeseries_free() {
+    free(timeseries.buckets);
+    memset(&timeseries, 0, sizeof(timeseries));
+}
+
+// --- 구간별 지표 출력 ---
+// interval 행은 every 요청마다, epoch 행은 P 로 정책이 바뀔 때와 종료 시 기록된다.
+// 카운터는 행이 다루는 구간의 증분이고, p/q 와 T1..T4 크기는 기록 시점의 값이다.
+
+static void metrics_snapshot(MetricsCounters *c) {
+    c->hits = hits;
+    c->misses = misses;
+    c->evictions = evictions;
+    c->dirty_evictions = dirty_eviction_stalls;
+    memcpy(c->ghost_hits, ghost_hits, sizeof(ghost_hits));
+    c->zns_violations = zone_table.violations;
+}
+
+int metrics_open(const char *path, int json, unsigned long long every) {
+    metrics.fp = fopen(path, "w");
+    if (metrics.fp == NULL) return -1;
+    metrics.json = json;
+    metrics.every = every;
+    metrics.interval_start_line = 1;
+    metrics.epoch_index = 1;
+    metrics.epoch_start_line = 1;
+    metrics_snapshot(&metrics.interval_base);
+    metrics.epoch_base = metrics.interval_base;
+    if (!json) {
+        fprintf(metrics.fp, "kind,epoch,policy,first_line,last_line,requests,total_requests,hits,misses,hit_rate,"
+                            "evictions,dirty_evictions,ghost_b1,ghost_b2,ghost_b3,ghost_b4,zns_violations,p,q,t1,t2,t3,t4\n");
+    }
+    metrics.enabled = 1;
+    return 0;
+}
+
+static void metrics_write_row(const char *kind, const MetricsCounters *base, unsigned long long start_req,
+                              unsigned long long requests, int first_line, int last_line) {
+    MetricsCounters now;
+    metrics_snapshot(&now);
+    long long d_hits = now.hits - base->hits, d_misses = now.misses - base->misses;
+    double rate = (d_hits + d_misses == 0) ? 0.0 : (double)d_hits / (d_hits + d_misses);
+    unsigned long long g[5];
+    for (int i = 1; i <= 4; i++) g[i] = now.ghost_hits[i] - base->ghost_hits[i];
+    if (metrics.json) {
+        fprintf(metrics.fp, "{\"kind\":\"%s\",\"epoch\":%d,\"policy\":\"%s\",\"first_line\":%d,\"last_line\":%d,"
+                            "\"requests\":%llu,\"total_requests\":%llu,\"hits\":%lld,\"misses\":%lld,\"hit_rate\":%.6f,"
+                            "\"evictions\":%llu,\"dirty_evictions\":%llu,\"ghost_hits\":[%llu,%llu,%llu,%llu],\"zns_violations\":%llu,"
+                            "\"p\":%d,\"q\":%d,\"t\":[%d,%d,%d,%d]}\n",
+                kind, metrics.epoch_index, policy_names[current_policy], first_line, last_line,
+                requests - start_req, requests, d_hits, d_misses, rate,
+                now.evictions - base->evictions, now.dirty_evictions - base->dirty_evictions, g[1], g[2], g[3], g[4],
+                now.zns_violations - base->zns_violations,
+                arc_state.p, arc_state.q, arc_state.t1_size, arc_state.t2_size, arc_state.t3_size, arc_state.t4_size);
+    } else {
+        fprintf(metrics.fp, "%s,%d,%s,%d,%d,%llu,%llu,%lld,%lld,%.6f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%d,%d,%d,%d,%d,%d\n",
+                kind, metrics.epoch_index, policy_names[current_policy], first_line, last_line,
+                requests - start_req, requests, d_hits, d_misses, rate,
+                now.evictions - base->evictions, now.dirty_evictions - base->dirty_evictions, g[1], g[2], g[3], g[4],
+                now.zns_violations - base->zns_violations,
+                arc_state.p, arc_state.q, arc_state.t1_size, arc_state.t2_size, arc_state.t3_size, arc_state.t4_size);
+    }
+    metrics.rows++;
+}
+
+void metrics_emit_interval(unsigned long long requests, int line_num) {
+    if (!metrics.enabled || metrics.every == 0 || requests - metrics.interval_start_req < metrics.every) return;
+    metrics_write_row("interval", &metrics.interval_base, metrics.interval_start_req, requests, metrics.interval_start_line, line_num);
+    metrics_snapshot(&metrics.interval_base);
+    metrics.interval_start_req = requests;
+    metrics.interval_start_line = line_num + 1;
+}
+
+// 현재 정책 구간의 집계를 기록하고 새 구간을 시작
+void metrics_emit_epoch(unsigned long long requests, int end_line) {
+    if (!metrics.enabled) return;
+    if (requests > metrics.epoch_start_req) {
+        metrics_write_row("epoch", &metrics.epoch_base, metrics.epoch_start_req, requests, metrics.epoch_start_line, end_line);
+    }
+    metrics_snapshot(&metrics.epoch_base);
+    metrics.epoch_start_req = requests;
+    metrics.epoch_start_line = end_line + 1;
+    metrics.epoch_index++;
+}
+
+void metrics_close() {
+    if (metrics.fp != NULL) fclose(metrics.fp);
+    memset(&metrics, 0, sizeof(metrics));
+}
+
+// --- 트레이스 읽기/쓰기 ---
+
+// 바이너리 헤더가 있으면 바이너리 모드, 없으면 처음으로 되돌려 텍스트 모드
+int trace_open(TraceReader *reader, FILE *fp) {
+    char magic[8];
+    unsigned int header[2];
+    reader->fp = fp;
+    reader->binary = 0;
+    reader->line_num = 0;
+    if (fread(magic, 1, sizeof(magic), fp) == sizeof(magic) && memcmp(magic, TRACE_BINARY_MAGIC, sizeof(magic)) == 0) {
+        if (fread(header, sizeof(unsigned int), 2, fp) != 2 || header[0] != TRACE_BINARY_VERSION || header[1] != sizeof(BinaryTraceRecord)) {
+            fprintf(stderr, "오류: 지원하지 않는 바이너리 트레이스 헤더입니다.\n");
+            return -1;
+        }
+        reader->binary = 1;
+        return 0;
+    }
+    rewind(fp);
+    return 0;
+}
+
+void write_binary_trace_header(FILE *fp) {
+    unsigned int header[2] = { TRACE_BINARY_VERSION, (unsigned int)sizeof(BinaryTraceRecord) };
+    fwrite(TRACE_BINARY_MAGIC, 1, 8, fp);
+    fwrite(header, sizeof(unsigned int), 2, fp);
+}
+
+// 레코드 하나를 바이너리 형식으로. 길이가 32비트 len_sectors 필드를 넘으면 -1 (잘라서 쓰지 않는다)
+int encode_binary_trace_record(BinaryTraceRecord *out, const TraceRecord *rec) {
+    if (rec->kind != TRACE_POLICY && rec->len_sectors > UINT_MAX) return -1;
+    memset(out, 0, sizeof(*out));
+    out->time_ns = rec->has_time ? rec->time_ns : 0;
+    out->flags = rec->has_time ? TRACE_FLAG_HAS_TIME : 0;
+    if (rec->kind == TRACE_POLICY) {
+        out->op = 'P';
+        out->lba = (unsigned long long)rec->policy_code;
+    } else {
+        out->op = (rec->operation_type == OP_WRITE) ? 'W' : 'R';
+        out->lba = rec->lba;
+        out->len_sectors = (unsigned int)rec->len_sectors;
+    }
+    return 0;
+}
+
+static int trace_next_binary(TraceReader *reader, TraceRecord *rec) {
+    BinaryTraceRecord in;
+    while (fread(&in, sizeof(in), 1, reader->fp) == 1) {
+        reader->line_num++;
+        memset(rec, 0, sizeof(*rec));
+        rec->has_time = (in.flags & TRACE_FLAG_HAS_TIME) != 0;
+        rec->time_ns = in.time_ns;
+        char op = (char)toupper(in.op);
+        if (op == 'P') {
+            rec->kind = TRACE_POLICY;
+            rec->policy_code = (in.lba > INT_MAX) ? -1 : (int)in.lba;
+            return 1;
+        }
+        if (op != 'R' && op != 'W') {
+            fprintf(stderr, "경고: (레코드 %d) 잘못된 작업 유형 '%c'. 건너뜁니다.\n", reader->line_num, in.op);
+            continue;
+        }
+        rec->kind = TRACE_REQUEST;
+        rec->operation_type = (op == 'W') ? OP_WRITE : OP_READ;
+        rec->lba = in.lba;
+        rec->len_sectors = in.len_sectors;
+        if (!trace_request_length_ok(rec, reader->line_num)) continue;
+        return 1;
+    }
+    return 0;
+}
+
+// 길이 필드가 LBA 범위를 넘거나 MAX_REQUEST_PAGES 보다 많은 페이지에 걸치면 0 (line_num >= 0 이면 경고 출력).
+// trace_next 가 걸러내지만 재생/분배 경로도 레코드를 받을 때 다시 확인한다
+int trace_request_length_ok(const TraceRecord *rec, int line_num) {
+    unsigned long long lba = rec->lba, len = rec->len_sectors;
+    if (len == 0) return 1;
+    if (len > ULLONG_MAX - lba) {
+        if (line_num >= 0) fprintf(stderr, "경고: (라인 %d) 요청 길이 %llu 가 LBA 범위를 넘습니다. 무시.\n", line_num, len);
+        return 0;
+    }
+    if (lba_to_page_id(lba + len - 1) - lba_to_page_id(lba) >= MAX_REQUEST_PAGES) {
+        if (line_num >= 0) fprintf(stderr, "경고: (라인 %d) 요청 길이 %llu 섹터가 최대 %llu 페이지를 넘습니다. 무시.\n", line_num, len, MAX_REQUEST_PAGES);
+        return 0;
+    }
+    return 1;
+}
+
+// 다음 레코드를 읽어 1, 끝이면 0. 형식이 잘못된 줄은 경고 후 건너뜀
+int trace_next(TraceReader *reader, TraceRecord *rec) {
+    if (reader->binary) return trace_next_binary(reader, rec);
+    char line_buffer[256];
+    while (fgets(line_buffer, sizeof(line_buffer), reader->fp) != NULL) {
+        reader->line_num++;
+        int line_num = reader->line_num;
+        char *trimmed_line = line_buffer;
+        while (isspace((unsigned char)*trimmed_line)) trimmed_line++;
+        char *end_of_line = trimmed_line + strlen(trimmed_line) - 1;
+        while (end_of_line > trimmed_line && isspace((unsigned char)*end_of_line)) end_of_line--;
+        *(end_of_line + 1) = '\0';
+
+        if (trimmed_line[0] == '\0' || trimmed_line[0] == '#') continue;
+        memset(rec, 0, sizeof(*rec));
+
+        // 선택적 타임스탬프 (마이크로초, 소수 허용)
+        if (trimmed_line[0] == '@') {
+            char *ts_end;
+            errno = 0;
+            double ts_us = strtod(trimmed_line + 1, &ts_end);
+            if (ts_end == trimmed_line + 1 || errno != 0 || ts_us < 0 || !isspace((unsigned char)*ts_end)) {
+                fprintf(stderr, "경고: (라인 %d) 잘못된 타임스탬프. 무시. 내용: [%s]\n", line_num, trimmed_line);
+                continue;
+            }
+            rec->has_time = 1;
+            rec->time_ns = (unsigned long long)(ts_us * 1000.0 + 0.5);
+            trimmed_line = ts_end;
+            while (isspace((unsigned char)*trimmed_line)) trimmed_line++;
+        }
+
+        // 정책 변경 명령어
+        if (toupper(trimmed_line[0]) == 'P' && (trimmed_line[1] == ' ' || trimmed_line[1] == '\t')) {
+            int new_policy_code; char cmd_char;
+            if (sscanf(trimmed_line, "%c %d", &cmd_char, &new_policy_code) == 2 && toupper(cmd_char) == 'P') {
+                rec->kind = TRACE_POLICY;
+                rec->policy_code = new_policy_code;
+                return 1;
+            }
+            fprintf(stderr, "경고: (라인 %d) 잘못된 정책 변경 명령어 형식. 무시. 내용: [%s]\n", line_num, trimmed_line);
+            continue;
+        }
+
+        // LBA 접근 요청
+        unsigned long long lba_address_val, len_sectors_val = 0; char op_char_val_arr[3];
+        int fields = sscanf(trimmed_line, "%llu %2s %llu", &lba_address_val, op_char_val_arr, &len_sectors_val);
+        if (fields < 2) { fprintf(stderr, "경고: (라인 %d) 잘못된 LBA 접근 요청 형식. 무시. 내용: [%s]\n", line_num, trimmed_line); continue; }
+        char op_char_val = tolower(op_char_val_arr[0]);
+        if (op_char_val == 'r') rec->operation_type = OP_READ;
+        else if (op_char_val == 'w') rec->operation_type = OP_WRITE;
+        else { fprintf(stderr, "경고: (라인 %d) 잘못된 작업 유형 '%c'. 건너<0xEB><0x9C><0x84>니다.\n", line_num, op_char_val_arr[0]); continue; }
+        rec->kind = TRACE_REQUEST;
+        rec->lba = lba_address_val;
+        rec->len_sectors = (fields == 3) ? len_sectors_val : 0;
+        if (!trace_request_length_ok(rec, line_num)) continue;
+        return 1;
+    }
+    return 0;
+}
+
+// "--이름=값" 형식의 선택 옵션 파싱. 이름이 일치하면 1, 아니면 0 (값 오류 시 종료)
+static int parse_ull_option(const char *arg, const char *name, unsigned long long *out) {
+    size_t name_len = strlen(name);
+    if (strncmp(arg, name, name_len) != 0 || arg[name_len] != '=') return 0;
+    const char *value = arg + name_len + 1;
+    char *end;
+    errno = 0;
+    unsigned long long parsed = strtoull(value, &end, 10);
+    if (end == value || *end != '\0' || errno != 0 || *value == '-') {
+        fprintf(stderr, "오류: 옵션 '%s'의 값이 잘못되었습니다.\n", arg);
+        exit(EXIT_FAILURE);
+    }
+    *out = parsed;
+    return 1;
+}
+
+static int parse_str_option(const char *arg, const char *name, const char **out) {
+    size_t name_len = strlen(name);
+    if (strncmp(arg, name, name_len) != 0 || arg[name_len] != '=' || arg[name_len + 1] == '\0') return 0;
+    *out = arg + name_len + 1;
+    return 1;
+}
+
+// --- 합성 트레이스 생성기 ---
+
+// splitmix64: 시드가 같으면 플랫폼과 무관하게 같은 시퀀스
+static unsigned long long gen_next(TraceGenerator *gen) {
+    unsigned long long z = (gen->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// [0, 1) 균등 난수
+static double gen_uniform(TraceGenerator *gen) {
+    return (double)(gen_next(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// [0, n) 균등 정수
+static unsigned long long gen_below(TraceGenerator *gen, unsigned long long n) {
+    unsigned long long v = (unsigned long long)(gen_uniform(gen) * (double)n);
+    return (v < n) ? v : n - 1;
+}
+
+// libm 없이 쓰는 자연로그/지수 (zipf 가중치, 지수 분포 도착 간격용). x > 0
+static double gen_log(double x) {
+    int k = 0;
+    while (x >= 2.0) { x *= 0.5; k++; }
+    while (x < 1.0) { x *= 2.0; k--; }
+    double y = (x - 1.0) / (x + 1.0), y2 = y * y, term = y, sum = 0.0; // ln x = 2 atanh(y), |y| <= 1/3
+    for (int i = 1; i < 40; i += 2) { sum += term / i; term *= y2; }
+    return 2.0 * sum + k * 0.69314718055994530942;
+}
+
+static double gen_exp(double x) {
+    long k = (long)(x / 0.69314718055994530942 + ((x < 0) ? -0.5 : 0.5));
+    double r = x - k * 0.69314718055994530942, term = 1.0, sum = 1.0; // |r| <= ln2/2
+    for (int i = 1; i < 20; i++) { term *= r / i; sum += term; }
+    for (; k > 0; k--) sum *= 2.0;
+    for (; k < 0; k++) sum *= 0.5;
+    return sum;
+}
+
+// 순위 i (0부터) 의 가중치가 1/(i+1)^theta 인 alias 테이블 (Vose). 같은 크기/theta 면 재사용
+static int gen_build_zipf(TraceGenerator *gen, unsigned long long n, double theta) {
+    if (gen->alias_size == n && gen->alias_theta == theta) return 0;
+    free(gen->alias);
+    gen->alias = (GenAliasEntry*)malloc(n * sizeof(GenAliasEntry));
+    double *weight = (double*)malloc(n * sizeof(double));
+    unsigned int *small = (unsigned int*)malloc(n * sizeof(unsigned int));
+    unsigned int *large = (unsigned int*)malloc(n * sizeof(unsigned int));
+    gen->alias_size = 0;
+    if (gen->alias == NULL || weight == NULL || small == NULL || large == NULL) {
+        free(weight); free(small); free(large);
+        return -1;
+    }
+    double total = 0.0;
+    for (unsigned long long i = 0; i < n; i++) {
+        weight[i] = gen_exp(-theta * gen_log((double)(i + 1)));
+        total += weight[i];
+    }
+    unsigned long long num_small = 0, num_large = 0;
+    for (unsigned long long i = 0; i < n; i++) {
+        weight[i] = weight[i] * (double)n / total;
+        if (weight[i] < 1.0) small[num_small++] = (unsigned int)i;
+        else large[num_large++] = (unsigned int)i;
+    }
+    while (num_small > 0 && num_large > 0) {
+        unsigned int s = small[--num_small], l = large[num_large - 1];
+        gen->alias[s].prob = (float)weight[s];
+        gen->alias[s].alias = l;
+        weight[l] = (weight[l] + weight[s]) - 1.0;
+        if (weight[l] < 1.0) { num_large--; small[num_small++] = l; }
+    }
+    while (num_large > 0) { unsigned int l = large[--num_large]; gen->alias[l].prob = 1.0f; gen->alias[l].alias = l; }
+    while (num_small > 0) { unsigned int s = small[--num_small]; gen->alias[s].prob = 1.0f; gen->alias[s].alias = s; } // 반올림 잔여
+    free(weight); free(small); free(large);
+    gen->alias_size = n;
+    gen->alias_theta = theta;
+    for (int i = 0; i < GEN_ZIPF_AHEAD; i++) gen->zipf_ahead[i] = (unsigned int)gen_below(gen, n);
+    gen->zipf_ahead_pos = 0;
+    return 0;
+}
+
+// zipf 순위 하나. 테이블이 캐시보다 크면 칸 조회가 매번 미스이므로 GEN_ZIPF_AHEAD 개 앞서 뽑아 prefetch
+static unsigned long long gen_zipf_rank(TraceGenerator *gen) {
+    unsigned int i = gen->zipf_ahead[gen->zipf_ahead_pos];
+    unsigned int next = (unsigned int)gen_below(gen, gen->alias_size);
+    gen->zipf_ahead[gen->zipf_ahead_pos] = next;
+    gen->zipf_ahead_pos = (gen->zipf_ahead_pos + 1) % GEN_ZIPF_AHEAD;
+#if defined(__GNUC__)
+    __builtin_prefetch(&gen->alias[next]);
+#endif
+    return (gen_uniform(gen) < gen->alias[i].prob) ? i : gen->alias[i].alias;
+}
+
+// [0, n) 의 전단사 섞기: 2의 거듭제곱 범위의 완전 주기 LCG 를 n 안에 들어올 때까지 반복 (평균 2회 미만)
+static unsigned long long gen_scramble(unsigned long long x, unsigned long long n) {
+    unsigned long long mask = 1;
+    while (mask < n) mask <<= 1;
+    mask--;
+    do { x = (x * 0x5851F42D4C957F2DULL + 0x14057B7EF767814FULL) & mask; } while (x >= n);
+    return x;
+}
+
+// 10진 출력 (두 자리씩 변환, fprintf 보다 수 배 빠름)
+static char *gen_put_ull(char *p, unsigned long long v) {
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char digits[20], *d = digits + sizeof(digits);
+    while (v >= 100) { unsigned int r = (unsigned int)(v % 100); v /= 100; d -= 2; d[0] = pairs[r * 2]; d[1] = pairs[r * 2 + 1]; }
+    if (v >= 10) { d -= 2; d[0] = pairs[v * 2]; d[1] = pairs[v * 2 + 1]; }
+    else *--d = (char)('0' + v);
+    size_t n = (size_t)(digits + sizeof(digits) - d);
+    memcpy(p, d, n);
+    return p + n;
+}
+
+static void gen_flush(TraceGenerator *gen, FILE *fp) {
+    if (gen->out_len > 0) fwrite(gen->out, 1, gen->out_len, fp);
+    gen->bytes += gen->out_len;
+    gen->out_len = 0;
+}
+
+// 레코드 하나를 trace_next 가 읽는 텍스트 한 줄로 (줄바꿈 제외, 최대 TRACE_TEXT_MAX 바이트). 끝 위치를 반환
+static char *trace_format_text(char *p, const TraceRecord *rec) {
+    if (rec->has_time) {
+        *p++ = '@';
+        p = gen_put_ull(p, rec->time_ns / 1000);
+        unsigned long long frac = rec->time_ns % 1000;
+        p[0] = '.'; p[1] = (char)('0' + frac / 100); p[2] = (char)('0' + frac / 10 % 10); p[3] = (char)('0' + frac % 10); p[4] = ' ';
+        p += 5;
+    }
+    if (rec->kind == TRACE_POLICY) {
+        *p++ = 'P'; *p++ = ' ';
+        p = gen_put_ull(p, (unsigned long long)rec->policy_code);
+    } else {
+        p = gen_put_ull(p, rec->lba);
+        *p++ = ' ';
+        *p++ = (rec->operation_type == OP_WRITE) ? 'W' : 'R';
+        if (rec->len_sectors > 0) { *p++ = ' '; p = gen_put_ull(p, rec->len_sectors); }
+    }
+    return p;
+}
+
+// 레코드 하나를 출력 버퍼에 직렬화 (텍스트는 trace_next 가 읽는 형식 그대로). 바이너리에 담을 수 없는 길이면 -1
+static int gen_emit(TraceGenerator *gen, FILE *fp, int binary, const TraceRecord *rec) {
+    if (gen->out_len > GEN_OUT_BUFFER - 128) gen_flush(gen, fp);
+    char *start = gen->out + gen->out_len, *p = start;
+    if (binary) {
+        BinaryTraceRecord out;
+        if (encode_binary_trace_record(&out, rec) != 0) {
+            fprintf(stderr, "오류: 요청 길이 %llu 섹터는 바이너리 트레이스 레코드에 담을 수 없습니다 (최대 %u).\n", rec->len_sectors, UINT_MAX);
+            return -1;
+        }
+        memcpy(p, &out, sizeof(out));
+        p += sizeof(out);
+    } else {
+        p = trace_format_text(p, rec);
+        *p++ = '\n';
+    }
+    gen->out_len += (size_t)(p - start);
+    gen->records++;
+    return 0;
+}
+
+// "<패턴>[,키=값...]" 구간 정의 파싱
+static int gen_parse_phase(const char *spec, GenPhase *phase) {
+    char buf[512];
+    if (strlen(spec) >= sizeof(buf)) { fprintf(stderr, "오류: 구간 정의가 너무 깁니다: %s\n", spec); return -1; }
+    strcpy(buf, spec);
+    char *save = NULL, *tok = strtok_r(buf, ",", &save);
+    memset(phase, 0, sizeof(*phase));
+    if (tok == NULL) tok = "";
+    if (strcasecmp(tok, "zipf") == 0) phase->pattern = GEN_ZIPF;
+    else if (strcasecmp(tok, "uniform") == 0) phase->pattern = GEN_UNIFORM;
+    else if (strcasecmp(tok, "scan") == 0) phase->pattern = GEN_SCAN;
+    else if (strcasecmp(tok, "loop") == 0) phase->pattern = GEN_LOOP;
+    else if (strcasecmp(tok, "zone") == 0) phase->pattern = GEN_ZONE;
+    else { fprintf(stderr, "오류: 알 수 없는 패턴 '%s' (zipf, uniform, scan, loop, zone).\n", tok); return -1; }
+    phase->requests = 1000000;
+    phase->pages = 1ULL << 20;
+    phase->theta = 0.99;
+    phase->run_pages = 4096;
+    phase->write_pct = (phase->pattern == GEN_ZONE) ? 100 : 0;
+    phase->len_pages = 1;
+    phase->streams = 4;
+    phase->policy_code = -1;
+    while ((tok = strtok_r(NULL, ",", &save)) != NULL) {
+        char *eq = strchr(tok, '=');
+        if (eq == NULL || eq[1] == '\0') { fprintf(stderr, "오류: 구간 키 '%s' 에 값이 없습니다.\n", tok); return -1; }
+        *eq = '\0';
+        const char *key = tok, *value = eq + 1;
+        char *end;
+        errno = 0;
+        if (strcmp(key, "theta") == 0 || strcmp(key, "iat") == 0) {
+            double v = strtod(value, &end);
+            if (end == value || *end != '\0' || errno != 0 || v < 0) { fprintf(stderr, "오류: 구간 키 '%s' 의 값이 잘못되었습니다.\n", key); return -1; }
+            if (key[0] == 't') phase->theta = v; else phase->iat_us = v;
+            continue;
+        }
+        if (strcmp(key, "policy") == 0) {
+            phase->policy_code = policy_code_from_name(value);
+            if (phase->policy_code < 0) {
+                long code = strtol(value, &end, 10);
+                if (end != value && *end == '\0' && policy_code_valid(code)) phase->policy_code = (int)code;
+            }
+            if (phase->policy_code < 0) { fprintf(stderr, "오류: 알 수 없는 정책 '%s'.\n", value); return -1; }
+            continue;
+        }
+        unsigned long long v = strtoull(value, &end, 10);
+        if (end == value || *end != '\0' || errno != 0 || *value == '-') { fprintf(stderr, "오류: 구간 키 '%s' 의 값이 잘못되었습니다.\n", key); return -1; }
+        if (strcmp(key, "n") == 0) phase->requests = v;
+        else if (strcmp(key, "base") == 0) phase->base_page = v;
+        else if (strcmp(key, "pages") == 0) phase->pages = v;
+        else if (strcmp(key, "run") == 0) phase->run_pages = v;
+        else if (strcmp(key, "write") == 0 && v <= 100) phase->write_pct = (int)v;
+        else if (strcmp(key, "len") == 0 && v >= 1 && v <= MAX_REQUEST_PAGES) phase->len_pages = (unsigned int)v;
+        else if (strcmp(key, "streams") == 0 && v >= 1 && v <= GEN_MAX_STREAMS) phase->streams = (int)v;
+        else if (strcmp(key, "scramble") == 0) phase->scramble = (v != 0);
+        else { fprintf(stderr, "오류: 알 수 없거나 범위를 벗어난 구간 키 '%s=%s'.\n", key, value); return -1; }
+    }
+    if (phase->pages == 0 || phase->len_pages > phase->pages || phase->run_pages == 0 ||
+        phase->base_page + phase->pages > ULLONG_MAX / SECTORS_PER_PAGE) {
+        fprintf(stderr, "오류: 구간 '%s' 의 영역 설정이 잘못되었습니다 (pages > 0, len <= pages, run > 0).\n", spec);
+        return -1;
+    }
+    if (phase->pattern == GEN_ZIPF && phase->theta > 0 && phase->pages > GEN_MAX_ZIPF_PAGES) {
+        fprintf(stderr, "오류: zipf 영역은 %llu 페이지 이하여야 합니다.\n", GEN_MAX_ZIPF_PAGES);
+        return -1;
+    }
+    return 0;
+}
+
+// 구간 하나의 요청 생성
+static int gen_run_phase(TraceGenerator *gen, FILE *fp, int binary, const GenPhase *phase, unsigned long long zone_pages) {
+    TraceRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    int zipf = (phase->pattern == GEN_ZIPF && phase->theta > 0);
+    if (zipf && gen_build_zipf(gen, phase->pages, phase->theta) != 0) {
+        fprintf(stderr, "오류: zipf 테이블 할당 실패\n");
+        return -1;
+    }
+    unsigned long long num_zones = 0;
+    if (phase->pattern == GEN_ZONE) {
+        if (phase->pages % zone_pages != 0) {
+            fprintf(stderr, "오류: zone 구간의 영역(%llu 페이지)이 Zone 크기(--gen-zone=%llu 페이지)의 배수가 아닙니다.\n",
+                    phase->pages, zone_pages);
+            return -1;
+        }
+        num_zones = phase->pages / zone_pages;
+        if (num_zones < (unsigned long long)phase->streams) {
+            fprintf(stderr, "오류: zone 구간의 영역(%llu 페이지)이 스트림 %d개의 Zone(%llu 페이지)을 담지 못합니다.\n",
+                    phase->pages, phase->streams, zone_pages);
+            return -1;
+        }
+        for (int s = 0; s < phase->streams; s++) gen->stream_pos[s] = (unsigned long long)s * zone_pages;
+        gen->zone_next = (unsigned long long)phase->streams;
+    }
+    gen->cursor = 0;
+    gen->run_left = 0;
+    rec.has_time = (phase->iat_us > 0);
+    rec.time_ns = gen->time_ns;
+    if (phase->policy_code >= 0) {
+        rec.kind = TRACE_POLICY;
+        rec.policy_code = phase->policy_code;
+        if (gen_emit(gen, fp, binary, &rec) != 0) return -1;
+    }
+    rec.kind = TRACE_REQUEST;
+    for (unsigned long long r = 0; r < phase->requests; r++) {
+        unsigned long long offset = 0, len = phase->len_pages;
+        int is_write = (phase->write_pct > 0 && gen_below(gen, 100) < (unsigned long long)phase->write_pct);
+        switch (phase->pattern) {
+            case GEN_ZIPF:
+                if (zipf) {
+                    offset = gen_zipf_rank(gen);
+                    if (phase->scramble) offset = gen_scramble(offset, phase->pages);
+                } else {
+                    offset = gen_below(gen, phase->pages);
+                }
+                break;
+            case GEN_UNIFORM:
+                offset = gen_below(gen, phase->pages);
+                break;
+            case GEN_SCAN:
+                if (gen->run_left == 0) { gen->cursor = gen_below(gen, phase->pages); gen->run_left = phase->run_pages; }
+                offset = gen->cursor % phase->pages;
+                gen->cursor += len;
+                gen->run_left -= MIN(len, gen->run_left);
+                break;
+            case GEN_LOOP:
+                offset = gen->cursor;
+                gen->cursor = (gen->cursor + len) % phase->pages;
+                break;
+            case GEN_ZONE:
+                if (!is_write) { offset = gen_below(gen, phase->pages); break; }
+                {
+                    // 스트림마다 자기 Zone 을 처음부터 순차로 채우고, 다 차면 아직 쓰지 않은 다음 Zone 으로.
+                    // 트레이스에는 zone reset 이 없으므로 이미 쓴 Zone 으로 돌아가지 않는다 (영역을 다 쓰면 오류)
+                    int s = (int)gen_below(gen, (unsigned long long)phase->streams);
+                    unsigned long long pos = gen->stream_pos[s];
+                    if (pos == ULLONG_MAX) {
+                        fprintf(stderr, "오류: zone 구간이 영역의 Zone %llu개를 모두 썼습니다 (%llu번째 요청). pages 를 늘리거나 n 을 줄이세요.\n",
+                                num_zones, r + 1);
+                        return -1;
+                    }
+                    unsigned long long left = zone_pages - pos % zone_pages;
+                    offset = pos;
+                    len = MIN(len, left);
+                    if (len == left) {
+                        gen->stream_pos[s] = (gen->zone_next < num_zones) ? gen->zone_next++ * zone_pages : ULLONG_MAX;
+                    } else {
+                        gen->stream_pos[s] = pos + len;
+                    }
+                }
+                break;
+        }
+        if (offset + len > phase->pages) len = phase->pages - offset;
+        if (rec.has_time) {
+            gen->time_ns += (unsigned long long)(-gen_log(1.0 - gen_uniform(gen)) * phase->iat_us * 1000.0 + 0.5);
+            rec.time_ns = gen->time_ns;
+        }
+        rec.lba = (phase->base_page + offset) * SECTORS_PER_PAGE;
+        rec.operation_type = is_write ? OP_WRITE : OP_READ;
+        rec.len_sectors = (len > 1) ? len * SECTORS_PER_PAGE : 0;
+        if (gen_emit(gen, fp, binary, &rec) != 0) return -1;
+    }
+    return 0;
+}
+
+// test30 --generate <출력파일|-> --phase=... [--gen-seed=N] [--gen-format=text|binary] [--gen-zone=N]
+int generate_trace_main(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "사용법: %s --generate <출력_파일|-> --phase=<패턴>[,키=값...] [--phase=...] [선택 옵션]\n", argv[0]);
+        fprintf(stderr, "패턴: zipf, uniform, scan, loop, zone (구간은 지정한 순서대로 이어서 생성)\n");
+        fprintf(stderr, "구간 키:\n");
+        fprintf(stderr, "  n=<N>          요청 수 (기본: 1000000)\n");
+        fprintf(stderr, "  base=<페이지>  영역 시작 페이지 (기본: 0), pages=<N> 영역 크기 (기본: 1048576)\n");
+        fprintf(stderr, "  theta=<실수>   zipf 편중도 (기본: 0.99, 0 이면 균등), scramble=1 hot 페이지를 영역 전체에 흩뿌림\n");
+        fprintf(stderr, "  run=<N>        scan 한 번의 길이 (기본: 4096 페이지, 끝나면 임의 위치에서 새 scan)\n");
+        fprintf(stderr, "  write=<%%>      쓰기 비율 (기본: zone 100, 나머지 0)\n");
+        fprintf(stderr, "  len=<N>        요청당 페이지 수 (기본: 1, 최대: %llu)\n", MAX_REQUEST_PAGES);
+        fprintf(stderr, "  streams=<N>    zone: Zone 정렬 순차 쓰기 스트림 수 (기본: 4, 최대: %d)\n", GEN_MAX_STREAMS);
+        fprintf(stderr, "  policy=<이름|코드> 구간 시작에 P 라인 기록\n");
+        fprintf(stderr, "  iat=<us>       평균 도착 간격 (지수 분포), 지정하면 @<us> 타임스탬프 기록\n");
+        fprintf(stderr, "선택 옵션:\n");
+        fprintf(stderr, "  --gen-seed=<N>        난수 시드 (기본: 1, 같은 시드/구간이면 같은 트레이스)\n");
+        fprintf(stderr, "  --gen-format=<text|binary> 출력 형식 (기본: text)\n");
+        fprintf(stderr, "  --gen-zone=<N>        zone 패턴의 Zone 크기 (페이지, 기본: 4096, zone 구간의 pages 는 이 값의 배수)\n");
+        return 1;
+    }
+    static GenPhase phases[GEN_MAX_PHASES];
+    int num_phases = 0;
+    unsigned long long seed = 1, zone_pages = 4096;
+    const char *format = "text";
+    for (int arg_i = 3; arg_i < argc; arg_i++) {
+        const char *opt = argv[arg_i], *phase_spec = NULL;
+        if (parse_str_option(opt, "--phase", &phase_spec)) {
+            if (num_phases >= GEN_MAX_PHASES) { fprintf(stderr, "오류: 구간은 최대 %d개입니다.\n", GEN_MAX_PHASES); return 1; }
+            if (gen_parse_phase(phase_spec, &phases[num_phases]) != 0) return 1;
+            num_phases++;
+            continue;
+        }
+        int matched = parse_ull_option(opt, "--gen-seed", &seed)
+                   || parse_str_option(opt, "--gen-format", &format)
+                   || parse_ull_option(opt, "--gen-zone", &zone_pages);
+        if (!matched) {
+            fprintf(stderr, "오류: 알 수 없는 옵션 '%s'.\n", opt);
+            return 1;
+        }
+    }
+    int binary;
+    if (strcasecmp(format, "binary") == 0) binary = 1;
+    else if (strcasecmp(format, "text") == 0) binary = 0;
+    else { fprintf(stderr, "오류: 잘못된 출력 형식 '%s' (text 또는 binary).\n", format); return 1; }
+    if (num_phases == 0 || zone_pages == 0) { fprintf(stderr, "오류: --phase 가 하나 이상 필요하고 --gen-zone 은 0보다 커야 합니다.\n"); return 1; }
+
+    const char *out_path = argv[2];
+    FILE *fp = (strcmp(out_path, "-") == 0) ? stdout : fopen(out_path, "wb");
+    if (fp == NULL) { fprintf(stderr, "오류: 출력 파일 '%s' 열기 실패: %s\n", out_path, strerror(errno)); return 1; }
+    TraceGenerator gen;
+    memset(&gen, 0, sizeof(gen));
+    gen.rng = seed;
+    gen.out = (char*)malloc(GEN_OUT_BUFFER);
+    gen.stream_pos = (unsigned long long*)malloc(GEN_MAX_STREAMS * sizeof(unsigned long long));
+    if (gen.out == NULL || gen.stream_pos == NULL) { fprintf(stderr, "오류: 생성기 버퍼 할당 실패\n"); return 1; }
+    if (binary) {
+        write_binary_trace_header(fp);
+        gen.bytes = 16;
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    int rc = 0;
+    for (int i = 0; i < num_phases && rc == 0; i++) rc = gen_run_phase(&gen, fp, binary, &phases[i], zone_pages);
+    gen_flush(&gen, fp);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    if (ferror(fp)) { fprintf(stderr, "오류: 출력 파일 쓰기 실패\n"); rc = -1; }
+    if (fp != stdout) fclose(fp); else fflush(fp);
+
+    double seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+    fprintf(stderr, "생성 완료: %llu 레코드 (구간 %d개, %s), %llu 바이트, %.3f 초, %.2f GB/s\n",
+            gen.records, num_phases, binary ? "binary" : "text", gen.bytes, seconds,
+            (seconds > 0) ? gen.bytes / seconds / 1e9 : 0.0);
+    free(gen.out); free(gen.stream_pos); free(gen.alias);
+    return (rc == 0) ? 0 : 1;
+}
+
+// --- 오라클 라벨 생성 ---
+
+static void label_write_header() {
+    fprintf(label.out, "window,first_line,last_line,requests,read_ratio,avg_reuse_distance,max_reuse_distance,access_locality,"
+                       "unique_address_ratio,entropy,rw_switch_rate,seq_access_ratio,start_policy");
+    for (int p = 0; p < NUM_LABEL_POLICIES; p++) fprintf(label.out, ",hits_%s", policy_names[p]);
+    fprintf(label.out, ",label,label_code\n");
+}
+
+// 최고 히트 정책. 동점이면 창 시작 정책(전환 불필요), 그다음 낮은 정책 코드
+// (시작 정책이 라벨 클래스 밖의 정책이면 코드 0 부터 비교)
+static int label_best_policy(const LabelWindow *w) {
+    int best = (w->start_policy < NUM_LABEL_POLICIES) ? w->start_policy : 0;
+    for (int p = 0; p < NUM_LABEL_POLICIES; p++) {
+        if (w->hits[p] > w->hits[best]) best = p;
+    }
+    return best;
+}
+
+// 모든 정책 결과가 도착한 창을 순서대로 기록
+static void label_flush_rows() {
+    while (label.next_row < label.num_windows && label.windows[label.next_row].results == NUM_LABEL_POLICIES) {
+        const LabelWindow *w = &label.windows[label.next_row];
+        const TraceFeatures *f = &w->features;
+        int best = label_best_policy(w);
+        fprintf(label.out, "%d,%d,%d,%llu,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%s",
+                label.next_row + 1, w->first_line, w->last_line, w->requests,
+                f->read_ratio, f->avg_reuse_distance, f->max_reuse_distance, f->access_locality,
+                f->unique_address_ratio, f->entropy, f->rw_switch_rate, f->seq_access_ratio, policy_names[w->start_policy]);
+        for (int p = 0; p < NUM_LABEL_POLICIES; p++) fprintf(label.out, ",%lld", w->hits[p]);
+        fprintf(label.out, ",%s,%d\n", policy_names[best], best);
+        label.label_counts[best]++;
+        label.next_row++;
+    }
+}
+
+// 종료된 자식 하나를 거두고 그 결과를 반영 (자식은 종료 전에 결과를 파이프에 씀)
+static void label_reap_one() {
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "오류: 라벨 생성 자식 프로세스가 비정상 종료했습니다.\n");
+        exit(EXIT_FAILURE);
+    }
+    label.running--;
+    LabelResult r;
+    if (read(label.pipe_rd, &r, sizeof(r)) != (ssize_t)sizeof(r) || r.window < 0 || r.window >= label.num_windows) {
+        fprintf(stderr, "오류: 라벨 생성 결과를 읽지 못했습니다.\n");
+        exit(EXIT_FAILURE);
+    }
+    label.windows[r.window].hits[r.policy] = r.hits;
+    label.windows[r.window].results++;
+    label_flush_rows();
+}
+
+// 창 하나를 ACCESS_BATCH 개씩 access_batch 로 재생
+static void label_replay(const TraceRecord *recs, const int *line_nums, unsigned long long count) {
+    unsigned long long pages[ACCESS_BATCH];
+    for (unsigned long long i = 0; i < count; i += ACCESS_BATCH) {
+        access_batch(&recs[i], &line_nums[i], (int)MIN((unsigned long long)ACCESS_BATCH, count - i), pages);
+    }
+}
+
+// 현재(부모) 상태를 스냅샷으로 policy 정책의 창 재생을 자식 프로세스에서 시작 (fork 의 copy-on-write 가 스냅샷)
+static void label_spawn(int window, int policy, const TraceRecord *recs, const int *line_nums, unsigned long long count) {
+    while (label.running >= label.jobs) label_reap_one();
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) { fprintf(stderr, "오류: fork 실패: %s\n", strerror(errno)); exit(EXIT_FAILURE); }
+    if (pid == 0) {
+        if ((int)current_policy != policy) switch_policy((ReplacementPolicy)policy, 0);
+        LabelResult r = { window, policy, hits, misses };
+        label_replay(recs, line_nums, count);
+        r.hits = hits - r.hits;
+        r.misses = misses - r.misses;
+        _exit(write(label.pipe_wr, &r, sizeof(r)) == (ssize_t)sizeof(r) ? 0 : 1);
+    }
+    label.running++;
+}
+
+// 트레이스를 window_requests 요청씩 나눠 창마다 특징과 정책별 히트 수를 기록
+// 부모는 궤적(--label-follow)대로 창을 재생해 다음 창의 예열 상태를 만듦
+int label_run(TraceReader *trace, const char *out_path, unsigned long long window_requests, int jobs, int follow,
+              unsigned long long warmup_requests) {
+    memset(&label, 0, sizeof(label));
+    label.window_requests = window_requests;
+    label.jobs = jobs;
+    label.follow = follow;
+    int fds[2];
+    TraceRecord *recs = (TraceRecord*)malloc(window_requests * sizeof(TraceRecord));
+    int *line_nums = (int*)malloc(window_requests * sizeof(int));
+    char *text = (char*)malloc(window_requests * (TRACE_TEXT_MAX + 1)); // 특징 추출용 트레이스 텍스트 줄 (xg.c 가 원본 파일에서 읽는 것과 같은 형식)
+    char **lines = (char**)malloc(window_requests * sizeof(char*));
+    if (recs == NULL || line_nums == NULL || text == NULL || lines == NULL || pipe(fds) != 0) {
+        fprintf(stderr, "오류: 라벨 생성기 초기화 실패\n");
+        return 1;
+    }
+    label.pipe_rd = fds[0];
+    label.pipe_wr = fds[1];
+    label.out = fopen(out_path, "w");
+    if (label.out == NULL) { fprintf(stderr, "오류: 라벨 파일 '%s' 열기 실패: %s\n", out_path, strerror(errno)); return 1; }
+    label_write_header();
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    TraceRecord rec;
+    unsigned long long warmed = 0, ignored_policy_lines = 0, total_requests = 0;
+    int eof = 0;
+    while (!eof) {
+        unsigned long long count = 0;
+        while (count < window_requests) {
+            if (!trace_next(trace, &rec)) { eof = 1; break; }
+            if (rec.kind == TRACE_POLICY) { ignored_policy_lines++; continue; }
+            if (warmed < warmup_requests) { simulate_request(&rec, trace->line_num); warmed++; continue; }
+            recs[count] = rec;
+            line_nums[count] = trace->line_num;
+            count++;
+        }
+        if (count == 0) break;
+        total_requests += count;
+
+        if (label.num_windows == label.capacity) {
+            int new_capacity = (label.capacity == 0) ? 256 : label.capacity * 2;
+            LabelWindow *grown = (LabelWindow*)realloc(label.windows, new_capacity * sizeof(LabelWindow));
+            if (grown == NULL) { fprintf(stderr, "오류: 라벨 창 배열 할당 실패\n"); return 1; }
+            label.windows = grown;
+            label.capacity = new_capacity;
+        }
+        int w_idx = label.num_windows++;
+        LabelWindow *w = &label.windows[w_idx];
+        memset(w, 0, sizeof(*w));
+        w->first_line = line_nums[0];
+        w->last_line = line_nums[count - 1];
+        w->requests = count;
+        w->start_policy = (int)current_policy;
+        for (int p = 0; p < NUM_LABEL_POLICIES; p++) label_spawn(w_idx, p, recs, line_nums, count);
+
+        // 자식들이 재생하는 동안 부모는 특징 추출
+        char *t = text;
+        for (unsigned long long i = 0; i < count; i++) {
+            lines[i] = t;
+            t = trace_format_text(t, &recs[i]);
+            *t++ = '\0';
+        }
+        label.windows[w_idx].features = tf_extract_features_incremental(lines, 0, (int)count);
+
+        // 궤적 정책으로 이 창을 재생해 다음 창의 스냅샷을 만듦 (best 는 이 창의 결과를 기다림)
+        int next_policy = follow;
+        if (follow < 0) {
+            while (label.windows[w_idx].results < NUM_LABEL_POLICIES) label_reap_one();
+            next_policy = label_best_policy(&label.windows[w_idx]);
+        }
+        if ((int)current_policy != next_policy) switch_policy((ReplacementPolicy)next_policy, 0);
+        label_replay(recs, line_nums, count);
+        if (label.num_windows % 100 == 0) {
+            printf("  라벨 창 %d개 처리 (%llu 요청, 현재 궤적 정책: %s)...\n", label.num_windows, total_requests, policy_names[current_policy]);
+        }
+    }
+    while (label.running > 0) label_reap_one();
+    label_flush_rows();
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+    printf("라벨 생성 완료: 창 %d개 (창당 %llu 요청, 예열 %llu 요청), %s\n", label.num_windows, window_requests, warmed, out_path);
+    printf("  병렬 작업 %d개, %.3f 초, 정책별 재생 처리량 %.0f 요청/초\n", jobs, seconds,
+           (seconds > 0) ? (double)total_requests * NUM_LABEL_POLICIES / seconds : 0.0);
+    printf("  라벨 분포:");
+    for (int p = 0; p < NUM_POLICIES; p++) {
+        if (label.label_counts[p] > 0) printf(" %s=%llu", policy_names[p], label.label_counts[p]);
+    }
+    printf("\n");
+    if (ignored_policy_lines > 0) printf("  트레이스의 P 라인 %llu개는 라벨 생성에서 무시했습니다.\n", ignored_policy_lines);
+
+    fclose(label.out);
+    close(label.pipe_rd); close(label.pipe_wr);
+    free(label.windows); free(recs); free(line_nums); free(text); free(lines);
+    return 0;
+}
+
+
+// --- 체크포인트 / what-if ---
+
+static void ckpt_put(FILE *fp, int id, const void *data, unsigned long long size) {
+    static const char pad[8] = {0};
+    unsigned int head[2] = { (unsigned int)id, 0 };
+    fwrite(head, sizeof(head), 1, fp);
+    fwrite(&size, sizeof(size), 1, fp);
+    if (size > 0) fwrite(data, 1, size, fp);
+    fwrite(pad, 1, (8 - size % 8) % 8, fp);
+}
+
+// 시뮬레이터 전체 상태(프레임, ARC/CLOCK 상태, 고스트 리스트, Zone/LSL/flusher/선반입/장치 모델, 카운터)와
+// 트레이스 위치를 기록. page_index 는 프레임에서 다시 만들 수 있으므로 기록하지 않음
+int checkpoint_save(const char *path, const TraceReader *trace, unsigned long long requests, unsigned long long range_pages) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) { fprintf(stderr, "오류: 체크포인트 파일 '%s' 열기 실패: %s\n", path, strerror(errno)); return -1; }
+    CheckpointCore core;
+    memset(&core, 0, sizeof(core));
+    core.buffer_size = buffer_size;
+    core.current_policy = (int)current_policy;
+    core.previous_policy = (int)previous_policy_for_state_carryover;
+    core.global_clk_hand = global_clk_hand;
+    core.dirty_pages = dirty_pages;
+    core.trace_binary = trace->binary;
+    core.trace_line_num = trace->line_num;
+    core.zones_enabled = (zone_size_pages_global > 0);
+    core.lsl_enabled = lsl.enabled;
+    core.flusher_enabled = flusher.enabled;
+    core.readahead_enabled = readahead.enabled;
+    core.device_enabled = device.enabled;
+    core.tinylfu_enabled = tinylfu.enabled;
+    core.ucp_enabled = ucp.enabled;
+    core.zone_size_pages = zone_size_pages_global;
+    core.current_time = current_time;
+    core.hits = hits;
+    core.misses = misses;
+    core.dirty_eviction_stalls = dirty_eviction_stalls;
+    core.clean_victim_picks = clean_victim_picks;
+    core.zns_cost_picks = zns_cost.picks;
+    core.zns_cost_picked_clean = zns_cost.picked_clean;
+    core.zns_cost_picked_seq = zns_cost.picked_seq;
+    core.evict_seq_writebacks = evict_seq_writebacks;
+    core.evict_nonseq_writebacks = evict_nonseq_writebacks;
+    core.evictions = evictions;
+    memcpy(core.ghost_hits, ghost_hits, sizeof(core.ghost_hits));
+    long offset = ftell(trace->fp);
+    struct stat st;
+    core.trace_offset = (offset < 0) ? 0 : (unsigned long long)offset;
+    core.trace_size = (fstat(fileno(trace->fp), &st) == 0) ? (unsigned long long)st.st_size : 0;
+    core.requests = requests;
+    core.range_pages = range_pages;
+    CheckpointArc arc = { arc_state.p, arc_state.t1_size, arc_state.t2_size, arc_state.b1_size, arc_state.b2_size,
+                          arc_state.q, arc_state.t3_size, arc_state.t4_size, arc_state.b3_size, arc_state.b4_size,
+                          arc_state.p_clk_hand, arc_state.q_clk_hand };
+
+    unsigned int header[2] = { CKPT_VERSION, CKPT_SECTIONS - 1 };
+    fwrite(CKPT_MAGIC, 1, 8, fp);
+    fwrite(header, sizeof(header), 1, fp);
+    ckpt_put(fp, CKPT_CORE, &core, sizeof(core));
+    ckpt_put(fp, CKPT_FRAMES, buffer, (unsigned long long)buffer_size * sizeof(BufferFrame));
+    ckpt_put(fp, CKPT_FRAME_HOT, &frame_hot, sizeof(frame_hot));
+    ckpt_put(fp, CKPT_ARC, &arc, sizeof(arc));
+    ckpt_put(fp, CKPT_GHOST_B1, arc_state.b1, (unsigned long long)arc_state.b1_size * sizeof(unsigned long long));
+    ckpt_put(fp, CKPT_GHOST_B2, arc_state.b2, (unsigned long long)arc_state.b2_size * sizeof(unsigned long long));
+    ckpt_put(fp, CKPT_GHOST_B3, arc_state.b3, (unsigned long long)arc_state.b3_size * sizeof(unsigned long long));
+    ckpt_put(fp, CKPT_GHOST_B4, arc_state.b4, (unsigned long long)arc_state.b4_size * sizeof(unsigned long long));
+    if (core.zones_enabled) {
+        ckpt_put(fp, CKPT_ZONES, &zone_table, sizeof(zone_table));
+        ckpt_put(fp, CKPT_ZONE_SLOTS, zone_table.slots, zone_table.capacity * sizeof(ZoneEntry));
+        ckpt_put(fp, CKPT_ZONE_OPEN, zone_table.open_zone_ids, (unsigned long long)zone_table.open_capacity * sizeof(unsigned long long));
+        ckpt_put(fp, CKPT_ZONE_ACTIVE, zone_table.active_zone_ids, (unsigned long long)zone_table.active_capacity * sizeof(unsigned long long));
+    }
+    if (flusher.enabled) ckpt_put(fp, CKPT_FLUSHER, &flusher, sizeof(flusher));
+    if (readahead.enabled) {
+        ckpt_put(fp, CKPT_READAHEAD, &readahead, sizeof(readahead));
+        ckpt_put(fp, CKPT_RA_FRAMES, readahead.list_frames, (unsigned long long)readahead.list_capacity * sizeof(int));
+        ckpt_put(fp, CKPT_RA_PAGES, readahead.list_pages, (unsigned long long)readahead.list_capacity * sizeof(unsigned long long));
+    }
+    if (lsl.enabled) {
+        ckpt_put(fp, CKPT_LSL, &lsl, sizeof(lsl));
+        ckpt_put(fp, CKPT_LSL_L2P_KEYS, lsl.lba_to_phys.keys, lsl.lba_to_phys.capacity * sizeof(unsigned long long));
+        ckpt_put(fp, CKPT_LSL_L2P_VALUES, lsl.lba_to_phys.values, lsl.lba_to_phys.capacity * sizeof(unsigned long long));
+        ckpt_put(fp, CKPT_LSL_P2L_KEYS, lsl.phys_to_lba.keys, lsl.phys_to_lba.capacity * sizeof(unsigned long long));
+        ckpt_put(fp, CKPT_LSL_P2L_VALUES, lsl.phys_to_lba.values, lsl.phys_to_lba.capacity * sizeof(unsigned long long));
+        ckpt_put(fp, CKPT_LSL_VALID, lsl.valid_pages, lsl.total_zones * sizeof(unsigned int));
+        ckpt_put(fp, CKPT_LSL_HOME, lsl.home_intact, lsl.total_zones);
+        ckpt_put(fp, CKPT_LSL_FREE, lsl.free_zones, lsl.total_zones * sizeof(unsigned long long));
+        ckpt_put(fp, CKPT_LSL_GC_HEAP, lsl.gc_heap, lsl.total_zones * sizeof(unsigned long long));
+        ckpt_put(fp, CKPT_LSL_GC_POS, lsl.gc_pos, lsl.total_zones * sizeof(unsigned long long));
+    }
+    if (device.enabled) {
+        ckpt_put(fp, CKPT_DEVICE, &device, sizeof(device));
+        ckpt_put(fp, CKPT_DEV_INFLIGHT, device.inflight, (unsigned long long)device.cfg.queue_depth * sizeof(unsigned long long));
+    }
+    if (current_policy == CLOCK_PRO) ckpt_put(fp, CKPT_CLOCKPRO, &clockpro, sizeof(clockpro));
+    if (current_policy == S3_FIFO || current_policy == SIEVE) ckpt_put(fp, CKPT_FIFOQ, &fifoq, sizeof(fifoq));
+    if (current_policy == LIRS) ckpt_put(fp, CKPT_LIRS, &lirs, sizeof(lirs));
+    if (tinylfu.enabled) {
+        ckpt_put(fp, CKPT_TINYLFU, &tinylfu, sizeof(tinylfu));
+        ckpt_put(fp, CKPT_TLFU_SKETCH, tinylfu.sketch, (tinylfu.width_mask + 1) * TINYLFU_ROWS);
+        ckpt_put(fp, CKPT_TLFU_DOOR, tinylfu.door, (tinylfu.door_mask + 1) / 8);
+    }
+    if (ucp.enabled) {
+        ckpt_put(fp, CKPT_UCP, &ucp, sizeof(ucp));
+        ckpt_put(fp, CKPT_UCP_STACKS, ucp.stacks, (unsigned long long)ucp.num_tenants * ucp.stack_cap * sizeof(unsigned long long));
+        if (current_policy == S3_FIFO || current_policy == SIEVE) ckpt_put(fp, CKPT_UCP_CHAIN, &fifoq_chain, sizeof(fifoq_chain));
+        if (current_policy == LIRS) ckpt_put(fp, CKPT_UCP_CHAIN, &lirs_chain, sizeof(lirs_chain));
+    }
+    int failed = ferror(fp);
+    if (fclose(fp) != 0 || failed) { fprintf(stderr, "오류: 체크포인트 파일 '%s' 쓰기 실패\n", path); return -1; }
+    return 0;
+}
+
+// 섹션 내용. 없거나 크기가 expect 와 다르면 NULL (expect == ULLONG_MAX 면 크기 검사 생략)
+static const void *ckpt_get(const CheckpointFile *ck, int id, unsigned long long expect) {
+    if (ck->data[id] == NULL || (expect != ULLONG_MAX && ck->size[id] != expect)) return NULL;
+    return ck->data[id];
+}
+
+// 섹션을 기존 메모리로 복사 (크기 불일치 시 종료)
+static void ckpt_copy(const CheckpointFile *ck, int id, void *dst, unsigned long long size) {
+    const void *src = ckpt_get(ck, id, size);
+    if (src == NULL) {
+        fprintf(stderr, "오류: 체크포인트 섹션 %d 이 없거나 크기가 맞지 않습니다.\n", id);
+        exit(EXIT_FAILURE);
+    }
+    if (size > 0) memcpy(dst, src, size);
+}
+
+// 섹션을 새 힙 메모리로 복사 (크기 불일치나 할당 실패 시 종료)
+static void *ckpt_dup(const CheckpointFile *ck, int id, unsigned long long size) {
+    void *dst = malloc(size > 0 ? size : 1);
+    if (dst == NULL) { fprintf(stderr, "오류: 체크포인트 복원 메모리 할당 실패\n"); exit(EXIT_FAILURE); }
+    ckpt_copy(ck, id, dst, size);
+    return dst;
+}
+
+static int ckpt_open(CheckpointFile *ck, const char *path) {
+    memset(ck, 0, sizeof(*ck));
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "오류: 체크포인트 파일 '%s' 열기 실패: %s\n", path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    ck->map_len = (size_t)st.st_size;
+    ck->map = (ck->map_len > 0) ? mmap(NULL, ck->map_len, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (ck->map == MAP_FAILED) { fprintf(stderr, "오류: 체크포인트 파일 '%s' mmap 실패\n", path); ck->map = NULL; return -1; }
+    const unsigned char *base = (const unsigned char*)ck->map;
+    unsigned int header[2];
+    if (ck->map_len < 16 || memcmp(base, CKPT_MAGIC, 8) != 0) { fprintf(stderr, "오류: '%s' 는 체크포인트 파일이 아닙니다.\n", path); return -1; }
+    memcpy(header, base + 8, sizeof(header));
+    if (header[0] != CKPT_VERSION) { fprintf(stderr, "오류: 지원하지 않는 체크포인트 버전 %u\n", header[0]); return -1; }
+    size_t pos = 16;
+    while (pos + 16 <= ck->map_len) {
+        unsigned int head[2];
+        unsigned long long size;
+        memcpy(head, base + pos, sizeof(head));
+        memcpy(&size, base + pos + 8, sizeof(size));
+        pos += 16;
+        if (size > ck->map_len - pos || head[0] == 0 || head[0] >= CKPT_SECTIONS) { fprintf(stderr, "오류: 손상된 체크포인트 파일입니다.\n"); return -1; }
+        ck->data[head[0]] = base + pos;
+        ck->size[head[0]] = size;
+        pos += (size_t)(size + (8 - size % 8) % 8);
+    }
+    return 0;
+}
+
+static void ckpt_close(CheckpointFile *ck) {
+    if (ck->map != NULL) munmap(ck->map, ck->map_len);
+    memset(ck, 0, sizeof(*ck));
+}
+
+static void ckpt_restore_ghost(const CheckpointFile *ck, int id, unsigned long long *list, int size) {
+    ckpt_copy(ck, id, list, (unsigned long long)size * sizeof(unsigned long long));
+    for (int i = size; i < MAX_BUFFER_SIZE; i++) list[i] = INVALID_PAGE;
+}
+
+// checkpoint_save 로 기록한 상태를 복원하고 트레이스를 저장 위치로 옮김.
+// 버퍼/Zone 크기와 활성화된 계층(ZNS, LSL, flusher, 선반입, 장치 모델)이 현재 실행과 같아야 함
+int checkpoint_restore(const char *path, TraceReader *trace, unsigned long long *requests, unsigned long long *range_pages) {
+    CheckpointFile ck;
+    if (ckpt_open(&ck, path) != 0) { ckpt_close(&ck); return -1; }
+    const CheckpointCore *core = (const CheckpointCore*)ckpt_get(&ck, CKPT_CORE, sizeof(CheckpointCore));
+    const CheckpointArc *arc = (const CheckpointArc*)ckpt_get(&ck, CKPT_ARC, sizeof(CheckpointArc));
+    if (core == NULL || arc == NULL || ckpt_get(&ck, CKPT_FRAMES, (unsigned long long)core->buffer_size * sizeof(BufferFrame)) == NULL) {
+        fprintf(stderr, "오류: 체크포인트가 다른 빌드에서 만들어졌거나 손상되었습니다.\n");
+        ckpt_close(&ck); return -1;
+    }
+    if (core->buffer_size != buffer_size || core->zone_size_pages != zone_size_pages_global || core->trace_binary != trace->binary ||
+        core->lsl_enabled != lsl.enabled || core->flusher_enabled != flusher.enabled ||
+        core->readahead_enabled != readahead.enabled || core->device_enabled != device.enabled || core->tinylfu_enabled != tinylfu.enabled ||
+        core->ucp_enabled != ucp.enabled) {
+        fprintf(stderr, "오류: 체크포인트 설정(버퍼 %d, 존 %llu, LSL %d, flusher %d, 선반입 %d, 장치 모델 %d, TinyLFU %d, 테넌트 분할 %d)이 현재 실행과 다릅니다.\n",
+                core->buffer_size, core->zone_size_pages, core->lsl_enabled, core->flusher_enabled, core->readahead_enabled, core->device_enabled,
+                core->tinylfu_enabled, core->ucp_enabled);
+        ckpt_close(&ck); return -1;
+    }
+    struct stat st;
+    if (fstat(fileno(trace->fp), &st) == 0 && (unsigned long long)st.st_size != core->trace_size) {
+        fprintf(stderr, "경고: 트레이스 파일 크기(%llu)가 체크포인트 저장 시(%llu)와 다릅니다.\n", (unsigned long long)st.st_size, core->trace_size);
+    }
+    if (fseek(trace->fp, (long)core->trace_offset, SEEK_SET) != 0) {
+        fprintf(stderr, "오류: 트레이스 위치 %llu 로 이동 실패\n", core->trace_offset);
+        ckpt_close(&ck); return -1;
+    }
+    trace->line_num = core->trace_line_num;
+
+    ckpt_copy(&ck, CKPT_FRAMES, buffer, (unsigned long long)buffer_size * sizeof(BufferFrame));
+    ckpt_copy(&ck, CKPT_FRAME_HOT, &frame_hot, sizeof(frame_hot));
+    for (unsigned long long i = 0; i < page_index.capacity; i++) page_index.keys[i] = INVALID_PAGE;
+    page_index.count = 0;
+    for (int i = 0; i < buffer_size; i++) {
+        if (buffer[i].page_id != INVALID_PAGE) u64map_put(&page_index, buffer[i].page_id, (unsigned long long)i);
+    }
+    current_policy = (ReplacementPolicy)core->current_policy;
+    select_policy_path();
+    previous_policy_for_state_carryover = (ReplacementPolicy)core->previous_policy;
+    global_clk_hand = core->global_clk_hand;
+    dirty_pages = core->dirty_pages;
+    current_time = core->current_time;
+    hits = core->hits;
+    misses = core->misses;
+    dirty_eviction_stalls = core->dirty_eviction_stalls;
+    clean_victim_picks = core->clean_victim_picks;
+    zns_cost.picks = core->zns_cost_picks;
+    zns_cost.picked_clean = core->zns_cost_picked_clean;
+    zns_cost.picked_seq = core->zns_cost_picked_seq;
+    evict_seq_writebacks = core->evict_seq_writebacks;
+    evict_nonseq_writebacks = core->evict_nonseq_writebacks;
+    evictions = core->evictions;
+    memcpy(ghost_hits, core->ghost_hits, sizeof(ghost_hits));
+    *requests = core->requests;
+    *range_pages = core->range_pages;
+
+    arc_state.p = arc->p; arc_state.t1_size = arc->t1_size; arc_state.t2_size = arc->t2_size;
+    arc_state.q = arc->q; arc_state.t3_size = arc->t3_size; arc_state.t4_size = arc->t4_size;
+    arc_state.b1_size = arc->b1_size; arc_state.b2_size = arc->b2_size;
+    arc_state.b3_size = arc->b3_size; arc_state.b4_size = arc->b4_size;
+    arc_state.p_clk_hand = arc->p_clk_hand; arc_state.q_clk_hand = arc->q_clk_hand;
+    ckpt_restore_ghost(&ck, CKPT_GHOST_B1, arc_state.b1, arc->b1_size);
+    ckpt_restore_ghost(&ck, CKPT_GHOST_B2, arc_state.b2, arc->b2_size);
+    ckpt_restore_ghost(&ck, CKPT_GHOST_B3, arc_state.b3, arc->b3_size);
+    ckpt_restore_ghost(&ck, CKPT_GHOST_B4, arc_state.b4, arc->b4_size);
+
+    // 포인터 멤버는 섹션에서 새로 할당해 채우고, 열린 파일 핸들/이름 문자열은 현재 실행의 것을 유지
+    if (core->zones_enabled) {
+        FILE *event_file = zone_table.event_file;
+        zns_free();
+        ckpt_copy(&ck, CKPT_ZONES, &zone_table, sizeof(zone_table));
+        zone_table.slots = (ZoneEntry*)ckpt_dup(&ck, CKPT_ZONE_SLOTS, zone_table.capacity * sizeof(ZoneEntry));
+        zone_table.open_zone_ids = (unsigned long long*)ckpt_dup(&ck, CKPT_ZONE_OPEN, (unsigned long long)zone_table.open_capacity * sizeof(unsigned long long));
+        zone_table.active_zone_ids = (unsigned long long*)ckpt_dup(&ck, CKPT_ZONE_ACTIVE, (unsigned long long)zone_table.active_capacity * sizeof(unsigned long long));
+        zone_table.event_file = event_file;
+    }
+    if (flusher.enabled) {
+        int *scratch = flusher.scratch;
+        ckpt_copy(&ck, CKPT_FLUSHER, &flusher, sizeof(flusher));
+        flusher.scratch = scratch;
+    }
+    if (readahead.enabled) {
+        readahead_free();
+        ckpt_copy(&ck, CKPT_READAHEAD, &readahead, sizeof(readahead));
+        readahead.list_frames = (int*)ckpt_dup(&ck, CKPT_RA_FRAMES, (unsigned long long)readahead.list_capacity * sizeof(int));
+        readahead.list_pages = (unsigned long long*)ckpt_dup(&ck, CKPT_RA_PAGES, (unsigned long long)readahead.list_capacity * sizeof(unsigned long long));
+    }
+    if (lsl.enabled) {
+        lsl_free();
+        ckpt_copy(&ck, CKPT_LSL, &lsl, sizeof(lsl));
+        lsl.lba_to_phys.keys = (unsigned long long*)ckpt_dup(&ck, CKPT_LSL_L2P_KEYS, lsl.lba_to_phys.capacity * sizeof(unsigned long long));
+        lsl.lba_to_phys.values = (unsigned long long*)ckpt_dup(&ck, CKPT_LSL_L2P_VALUES, lsl.lba_to_phys.capacity * sizeof(unsigned long long));
+        lsl.phys_to_lba.keys = (unsigned long long*)ckpt_dup(&ck, CKPT_LSL_P2L_KEYS, lsl.phys_to_lba.capacity * sizeof(unsigned long long));
+        lsl.phys_to_lba.values = (unsigned long long*)ckpt_dup(&ck, CKPT_LSL_P2L_VALUES, lsl.phys_to_lba.capacity * sizeof(unsigned long long));
+        lsl.valid_pages = (unsigned int*)ckpt_dup(&ck, CKPT_LSL_VALID, lsl.total_zones * sizeof(unsigned int));
+        lsl.home_intact = (unsigned char*)ckpt_dup(&ck, CKPT_LSL_HOME, lsl.total_zones);
+        lsl.free_zones = (unsigned long long*)ckpt_dup(&ck, CKPT_LSL_FREE, lsl.total_zones * sizeof(unsigned long long));
+        lsl.gc_heap = (unsigned long long*)ckpt_dup(&ck, CKPT_LSL_GC_HEAP, lsl.total_zones * sizeof(unsigned long long));
+        lsl.gc_pos = (unsigned long long*)ckpt_dup(&ck, CKPT_LSL_GC_POS, lsl.total_zones * sizeof(unsigned long long));
+    }
+    if (device.enabled) {
+        const char *name = device.cfg.name;
+        device_free();
+        ckpt_copy(&ck, CKPT_DEVICE, &device, sizeof(device));
+        device.inflight = (unsigned long long*)ckpt_dup(&ck, CKPT_DEV_INFLIGHT, (unsigned long long)device.cfg.queue_depth * sizeof(unsigned long long));
+        device.cfg.name = name;
+    }
+    if (current_policy == CLOCK_PRO) {
+        // 비상주 노드 색인은 리스트를 한 바퀴 돌며 다시 만든다
+        ckpt_copy(&ck, CKPT_CLOCKPRO, &clockpro, sizeof(clockpro));
+        for (unsigned long long i = 0; i < clockpro_nonres.capacity; i++) clockpro_nonres.keys[i] = INVALID_PAGE;
+        clockpro_nonres.count = 0;
+        int node = clockpro.hand_hot;
+        for (int i = 0; node != -1 && (i == 0 || node != clockpro.hand_hot); i++, node = clockpro.next[node]) {
+            if (node >= MAX_BUFFER_SIZE) u64map_put(&clockpro_nonres, clockpro.nonres_page[node], (unsigned long long)node);
+        }
+    }
+    if (current_policy == S3_FIFO || current_policy == SIEVE) {
+        // G 색인은 링을 오래된 항목부터 훑어 다시 만든다 (재적재된 항목은 INVALID_PAGE)
+        ckpt_copy(&ck, CKPT_FIFOQ, &fifoq, sizeof(fifoq));
+        for (unsigned long long i = 0; i < fifoq_ghost_index.capacity; i++) fifoq_ghost_index.keys[i] = INVALID_PAGE;
+        fifoq_ghost_index.count = 0;
+        int capacity = MAX(buffer_size, 1);
+        for (int i = 0; i < fifoq.ghost_count; i++) {
+            int slot = (fifoq.ghost_pos - fifoq.ghost_count + i + capacity) % capacity;
+            if (fifoq.ghost[slot] != INVALID_PAGE) u64map_put(&fifoq_ghost_index, fifoq.ghost[slot], (unsigned long long)slot);
+        }
+    }
+    if (current_policy == LIRS) {
+        // 비상주 노드 색인은 생성 순서 리스트에서 다시 만든다
+        ckpt_copy(&ck, CKPT_LIRS, &lirs, sizeof(lirs));
+        for (unsigned long long i = 0; i < lirs_nonres.capacity; i++) lirs_nonres.keys[i] = INVALID_PAGE;
+        lirs_nonres.count = 0;
+        for (int n = lirs.n_head; n != -1; n = lirs.n_next[n]) {
+            u64map_put(&lirs_nonres, lirs.nonres_page[n], (unsigned long long)(MAX_BUFFER_SIZE + n));
+        }
+    }
+    if (tinylfu.enabled) {
+        tinylfu_free();
+        ckpt_copy(&ck, CKPT_TINYLFU, &tinylfu, sizeof(tinylfu));
+        tinylfu.sketch = (unsigned char*)ckpt_dup(&ck, CKPT_TLFU_SKETCH, (tinylfu.width_mask + 1) * TINYLFU_ROWS);
+        tinylfu.door = (unsigned long long*)ckpt_dup(&ck, CKPT_TLFU_DOOR, (tinylfu.door_mask + 1) / 8);
+    }
+    if (ucp.enabled) {
+        // 테넌트 맵은 현재 실행의 --tenants 를 그대로 쓴다 (같은 맵이어야 테넌트 번호가 맞음)
+        TenantRange *ranges = ucp.ranges;
+        int num_ranges = ucp.num_ranges;
+        free(ucp.stacks);
+        ckpt_copy(&ck, CKPT_UCP, &ucp, sizeof(ucp));
+        ucp.ranges = ranges;
+        ucp.num_ranges = num_ranges;
+        ucp.victim_bits = NULL;
+        ucp.stacks = (unsigned long long*)ckpt_dup(&ck, CKPT_UCP_STACKS, (unsigned long long)ucp.num_tenants * ucp.stack_cap * sizeof(unsigned long long));
+        if (current_policy == S3_FIFO || current_policy == SIEVE) ckpt_copy(&ck, CKPT_UCP_CHAIN, &fifoq_chain, sizeof(fifoq_chain));
+        if (current_policy == LIRS) ckpt_copy(&ck, CKPT_UCP_CHAIN, &lirs_chain, sizeof(lirs_chain));
+    }
+    ckpt_close(&ck);
+    return 0;
+}
+
+// 분기한 자식의 시작 시점 카운터 (결과는 분기 이후 증분으로 보고)
+static WhatIfResult whatif_base;
+static int whatif_pipe_wr = -1;
+
+// 현재 상태에서 정책마다 자식 프로세스를 만들어 나머지 트레이스를 이어서 재생 (fork 의 copy-on-write 가 공유 예열 상태).
+// 자식은 맡은 정책으로 전환하고 stdout/stderr/FIO 로그를 /dev/null 로 돌린 뒤 그 정책 코드를 반환. 부모는 모든 자식을 기다려 결과를 출력하고 -1
+// 파일 오프셋은 fork 후에도 공유되므로 자식은 트레이스를 새로 열어 같은 위치부터 읽음
+int whatif_fork(TraceReader *trace, const char *trace_path, const int *policies, int count, unsigned long long requests) {
+    int fds[2];
+    int line_num = trace->line_num;
+    long offset = ftell(trace->fp);
+    if (offset < 0 || pipe(fds) != 0) { fprintf(stderr, "오류: what-if 분기 준비 실패\n"); exit(EXIT_FAILURE); }
+    fflush(stdout);
+    if (log_file != NULL) fflush(log_file);
+    for (int i = 0; i < count; i++) {
+        pid_t pid = fork();
+        if (pid < 0) { fprintf(stderr, "오류: fork 실패: %s\n", strerror(errno)); exit(EXIT_FAILURE); }
+        if (pid == 0) {
+            close(fds[0]);
+            whatif_pipe_wr = fds[1];
+            if (freopen("/dev/null", "w", stdout) == NULL || freopen("/dev/null", "w", stderr) == NULL) _exit(1);
+            FILE *fp = fopen(trace_path, "rb");
+            if (fp == NULL || fseek(fp, offset, SEEK_SET) != 0) _exit(1);
+            trace->fp = fp;
+            if (log_file != NULL) { // 부모의 FIO 로그는 건드리지 않고, ZNS/장치 모델 계산은 평소 경로 그대로
+                log_file = fopen("/dev/null", "w");
+                if (log_file == NULL) _exit(1);
+                fio_log.fp = log_file;
+                fio_log.len = 0;
+            }
+            if ((int)current_policy != policies[i]) switch_policy((ReplacementPolicy)policies[i], 0);
+            memset(&whatif_base, 0, sizeof(whatif_base));
+            whatif_base.policy = policies[i];
+            whatif_base.requests = requests;
+            whatif_base.hits = hits;
+            whatif_base.misses = misses;
+            whatif_base.evictions = evictions;
+            whatif_base.dirty_evictions = dirty_eviction_stalls;
+            whatif_base.zns_violations = zone_table.violations;
+            return policies[i];
+        }
+    }
+    close(fds[1]);
+    WhatIfResult results[NUM_POLICIES];
+    int received = 0;
+    for (int i = 0; i < count; i++) {
+        int status;
+        if (waitpid(-1, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "오류: what-if 자식 프로세스가 비정상 종료했습니다.\n");
+            continue;
+        }
+        if (read(fds[0], &results[received], sizeof(WhatIfResult)) == (ssize_t)sizeof(WhatIfResult)) received++;
     }
+    close(fds[0]);
+    printf("\n--- what-if 분기 결과 (라인 %d 이후, 분기 전 요청 %llu개, 히트 %lld / 미스 %lld) ---\n", line_num, requests, hits, misses);
+    printf(" %-24s %12s %12s %12s %8s %11s %10s %10s %9s\n", "정책", "요청", "히트", "미스", "히트율", "전체 히트율", "교체", "더티 교체", "ZNS 위반");
+    for (int i = 0; i < count; i++) {
+        for (int r = 0; r < received; r++) {
+            const WhatIfResult *w = &results[r];
+            if (w->policy != policies[i]) continue;
+            long long acc = w->hits + w->misses, total = w->total_hits + w->total_misses;
+            printf(" %-24s %12llu %12lld %12lld %7.2f%% %10.2f%% %10llu %10llu %9llu\n", policy_names[w->policy], w->requests,
+                   w->hits, w->misses, acc ? 100.0 * w->hits / acc : 0.0, total ? 100.0 * w->total_hits / total : 0.0,
+                   w->evictions, w->dirty_evictions, w->zns_violations);
+        }
+    }
+    return -1;
+}
 
-    if (evict_target_list_type == 3) {
-        victim_idx = evict_arc_internal_lfu(3);
-    } else {
-        victim_idx = evict_arc_internal_lru(4);
+// what-if 자식: 분기 이후 결과를 부모에게 보내고 종료
+void whatif_child_finish(unsigned long long requests) {
+    WhatIfResult r = whatif_base;
+    r.requests = requests - whatif_base.requests;
+    r.hits = hits - whatif_base.hits;
+    r.misses = misses - whatif_base.misses;
+    r.total_hits = hits;
+    r.total_misses = misses;
+    r.evictions = evictions - whatif_base.evictions;
+    r.dirty_evictions = dirty_eviction_stalls - whatif_base.dirty_evictions;
+    r.zns_violations = zone_table.violations - whatif_base.zns_violations;
+    _exit(write(whatif_pipe_wr, &r, sizeof(r)) == (ssize_t)sizeof(r) ? 0 : 1);
+}
+
+// --- 해시 샤드 시뮬레이션 ---
+// 페이지를 청크 단위 해시로 K개 샤드에 나누고, 샤드마다 buffer_size/K 프레임의 독립 캐시를 자식 프로세스로 돌린다.
+// 부모는 트레이스를 파싱해 샤드별 파이프(SPSC 큐)로 보내고, 끝나면 통계를 합치고 FIO 로그를 레코드 순번으로 병합한다.
+
+static int shard_of_page(unsigned long long page_id) {
+    return (int)(((page_id / shard.chunk_pages) * 0x9E3779B97F4A7C15ULL >> 32) % (unsigned long long)shard.count);
+}
+
+// 샤드 자식: 큐가 닫힐 때까지 재생하고 종료 시 더티 페이지를 플러시한 뒤 결과를 보내고 종료
+static void shard_child(int k, FILE *in, int result_fd, const char *log_path) {
+    int full_size = buffer_size;
+    buffer_size = full_size / shard.count + (k < full_size % shard.count);
+    initialize_buffer();
+    initialize_arc_state(1);
+    previous_policy_for_state_carryover = current_policy;
+    if (flusher.enabled) { // 같은 비율을 유지하도록 샤드 크기로 다시 계산
+        flusher.high_mark = MAX(1, (int)((long long)flusher.high_mark * buffer_size / full_size));
+        flusher.low_mark = (int)((long long)flusher.low_mark * buffer_size / full_size);
+    }
+    FILE *marks = NULL;
+    if (log_file != NULL) {
+        char path[MAX_FILENAME_LEN + 32];
+        snprintf(path, sizeof(path), "%s.shard%d", log_path, k);
+        log_file = fopen(path, "w");
+        snprintf(path, sizeof(path), "%s.shard%d.idx", log_path, k);
+        marks = fopen(path, "wb");
+        if (log_file == NULL || marks == NULL) _exit(1);
+        fio_log.fp = log_file;
+        fio_log.len = 0;
+        fio_log.ios_submitted = fio_log.ios_written = 0;
     }
 
-    if (victim_idx != -1) {
-        unsigned long long evicted_page_id = buffer[victim_idx].page_id;
-        if (evict_target_list_type == 3) {
-            arc_add_to_ghost_mru(evicted_page_id, arc_state.b3, &arc_state.b3_size, buffer_size);
-            if(arc_state.t3_size > 0) arc_state.t3_size--;
+    ShardResult r;
+    memset(&r, 0, sizeof(r));
+    r.shard = k;
+    r.frames = buffer_size;
+    ShardMessage msg;
+    unsigned long long marked = 0;
+    while (fread(&msg, sizeof(msg), 1, in) == 1) {
+        if (msg.rec.kind == TRACE_POLICY) {
+            if ((int)current_policy != msg.rec.policy_code) switch_policy((ReplacementPolicy)msg.rec.policy_code, 0);
         } else {
-            arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size);
-            if(arc_state.t4_size > 0) arc_state.t4_size--;
+            unsigned long long pages = simulate_request(&msg.rec, msg.line_num);
+            if (pages > 0) { r.requests++; r.pages += pages; }
+        }
+        if (fio_log.ios_written != marked && marks != NULL) {
+            ShardLogMark m = { msg.seq, fio_log.ios_written - marked };
+            fwrite(&m, sizeof(m), 1, marks);
+            marked = fio_log.ios_written;
         }
-    } else {
-         victim_idx = evict_fifo();
-         if (victim_idx != -1) {
-            if (buffer[victim_idx].list_type == 3 && arc_state.t3_size > 0) arc_state.t3_size--;
-            else if (buffer[victim_idx].list_type == 4 && arc_state.t4_size > 0) arc_state.t4_size--;
-         }
     }
-    return victim_idx;
+    for (int i = 0; i < buffer_size; ++i) {
+        if (buffer[i].page_id != INVALID_PAGE && buffer[i].is_dirty) { handle_dirty_eviction(i); r.dirty_flushed++; }
+    }
+    if (log_file != NULL) {
+        fio_log_barrier();
+        ShardLogMark m = { ULLONG_MAX, fio_log.ios_written - marked }; // 종료 플러시분은 모든 레코드 뒤
+        if (m.lines > 0) fwrite(&m, sizeof(m), 1, marks);
+        r.ios_submitted = fio_log.ios_submitted;
+        r.ios_written = fio_log.ios_written;
+        fio_log_close();
+        if (fclose(log_file) != 0 || fclose(marks) != 0) _exit(1);
+    }
+    r.hits = hits;
+    r.misses = misses;
+    r.evictions = evictions;
+    r.dirty_eviction_stalls = dirty_eviction_stalls;
+    r.clean_victim_picks = clean_victim_picks;
+    r.zns_cost_picks = zns_cost.picks;
+    r.zns_cost_picked_clean = zns_cost.picked_clean;
+    r.zns_cost_picked_seq = zns_cost.picked_seq;
+    r.evict_seq_writebacks = evict_seq_writebacks;
+    r.evict_nonseq_writebacks = evict_nonseq_writebacks;
+    memcpy(r.ghost_hits, ghost_hits, sizeof(r.ghost_hits));
+    r.zone_used = zone_table.used;
+    r.zone_violations = zone_table.violations;
+    r.zone_implicit_opens = zone_table.implicit_opens;
+    r.zone_explicit_opens = zone_table.explicit_opens;
+    r.zone_implicit_closes = zone_table.implicit_closes;
+    r.zone_explicit_closes = zone_table.explicit_closes;
+    r.zone_finishes = zone_table.finishes;
+    r.zone_resets = zone_table.resets;
+    r.zone_peak_open = zone_table.peak_open;
+    r.zone_peak_active = zone_table.peak_active;
+    r.flusher_runs = flusher.runs;
+    r.tlfu_admits = tinylfu.admits;
+    r.tlfu_rejects = tinylfu.rejects;
+    r.tlfu_agings = tinylfu.agings;
+    r.tlfu_saved_reads = tinylfu.saved_reads;
+    r.tlfu_kept_dirty = tinylfu.kept_dirty;
+    r.tlfu_write_arounds = tinylfu.write_arounds;
+    r.flusher_batches = flusher.batches;
+    r.flusher_pages = flusher.pages;
+    _exit(write(result_fd, &r, sizeof(r)) == (ssize_t)sizeof(r) ? 0 : 1);
 }
 
-// 핵심 페이지 접근 함수 (write_fio_log 호출 시 ZNS 제약 검사 수행됨)
-void access_page(unsigned long long lba_address, unsigned long long page_id, int operation_type) {
-    current_time++;
-    int found_idx = find_in_buffer(page_id);
-    int target_slot = -1;
-
-    if (page_id == INVALID_PAGE) return;
-
-    // ========================
-    //      Cache Hit
-    // ========================
-    if (found_idx != -1) {
-        hits++;
-        buffer[found_idx].last_access_time = current_time;
-        if (buffer[found_idx].access_count < UINT_MAX) {
-            buffer[found_idx].access_count++;
+// 샤드 FIO 로그를 색인의 (레코드 순번, 샤드 번호) 순서로 log_file 에 이어 붙이고 임시 파일 삭제.
+// 같은 입력이면 프로세스 스케줄링과 관계없이 같은 로그가 나온다
+static int shard_merge_logs(const char *log_path) {
+    FILE *logs[SHARD_MAX], *marks[SHARD_MAX];
+    ShardLogMark next[SHARD_MAX];
+    char path[MAX_FILENAME_LEN + 32], line[FIO_LOG_LINE_MAX + 2];
+    int rc = 0;
+    for (int k = 0; k < shard.count; k++) {
+        snprintf(path, sizeof(path), "%s.shard%d", log_path, k);
+        logs[k] = fopen(path, "r");
+        snprintf(path, sizeof(path), "%s.shard%d.idx", log_path, k);
+        marks[k] = fopen(path, "rb");
+        if (logs[k] == NULL || marks[k] == NULL) { rc = -1; next[k].seq = ULLONG_MAX; next[k].lines = 0; continue; }
+        if (fread(&next[k], sizeof(ShardLogMark), 1, marks[k]) != 1) next[k].lines = 0;
+    }
+    while (rc == 0) {
+        int best = -1;
+        for (int k = 0; k < shard.count; k++) {
+            if (next[k].lines > 0 && (best < 0 || next[k].seq < next[best].seq)) best = k;
         }
-        if (operation_type == OP_WRITE) {
-            buffer[found_idx].is_dirty = 1;
+        if (best < 0) break;
+        for (unsigned long long i = 0; i < next[best].lines; i++) {
+            if (fgets(line, sizeof(line), logs[best]) == NULL) { rc = -1; break; }
+            fputs(line, log_file);
         }
+        if (fread(&next[best], sizeof(ShardLogMark), 1, marks[best]) != 1) next[best].lines = 0;
+    }
+    for (int k = 0; k < shard.count; k++) {
+        if (logs[k] != NULL) fclose(logs[k]);
+        if (marks[k] != NULL) fclose(marks[k]);
+        snprintf(path, sizeof(path), "%s.shard%d", log_path, k);
+        remove(path);
+        snprintf(path, sizeof(path), "%s.shard%d.idx", log_path, k);
+        remove(path);
+    }
+    return rc;
+}
 
-        // --- 실제 정책에 따른 히트 처리 --- (enum 심볼 사용으로 자동 대응)
-        if (current_policy == LRU_ARC) { // LRU_ARC는 이제 8
-            if (buffer[found_idx].list_type == 1) {
-                buffer[found_idx].list_type = 2;
-                if(arc_state.t1_size > 0) arc_state.t1_size--;
-                arc_state.t2_size++;
-            }
-        } else if (current_policy == LFU_ARC) { // LFU_ARC는 이제 6
-            if (buffer[found_idx].list_type == 3) {
-                buffer[found_idx].list_type = 4;
-                if(arc_state.t3_size > 0) arc_state.t3_size--;
-                arc_state.t4_size++;
+// 트레이스 전체를 샤드로 재생하고 결과를 전역 카운터(hits, misses, Zone/flusher 통계 등)에 합친다.
+// 정책 변경(P)은 모든 샤드에 같은 위치로 전달
+int shard_run(TraceReader *trace, const char *log_path, unsigned long long *requests, unsigned long long *range_pages) {
+    int queue_fds[SHARD_MAX][2], result_fds[2];
+    FILE *queues[SHARD_MAX];
+    if (pipe(result_fds) != 0) { fprintf(stderr, "오류: 샤드 파이프 생성 실패\n"); return -1; }
+    for (int k = 0; k < shard.count; k++) {
+        if (pipe(queue_fds[k]) != 0) { fprintf(stderr, "오류: 샤드 파이프 생성 실패\n"); return -1; }
+    }
+    fflush(stdout);
+    if (log_file != NULL) fflush(log_file);
+    struct timespec start_time, replay_end_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    for (int k = 0; k < shard.count; k++) {
+        pid_t pid = fork();
+        if (pid < 0) { fprintf(stderr, "오류: fork 실패: %s\n", strerror(errno)); exit(EXIT_FAILURE); }
+        if (pid == 0) {
+            close(result_fds[0]);
+            for (int j = 0; j < shard.count; j++) { // 다른 큐의 끝을 닫아야 EOF 가 전달됨
+                close(queue_fds[j][1]);
+                if (j != k) close(queue_fds[j][0]);
             }
+            if (freopen("/dev/null", "w", stdout) == NULL) _exit(1);
+            FILE *in = fdopen(queue_fds[k][0], "rb");
+            if (in == NULL) _exit(1);
+            setvbuf(in, NULL, _IOFBF, SHARD_PIPE_BUFFER);
+            shard_child(k, in, result_fds[1], log_path);
         }
-        // --- 참조용 ARC 상태 업데이트 (LRU/LFU 정책 활성화 시) ---
-        else if (current_policy == LRU) { // LRU는 이제 7
-            if (buffer[found_idx].ref_arc_list_type == 1) {
-                buffer[found_idx].ref_arc_list_type = 2;
-                if (arc_state.t1_size > 0) arc_state.t1_size--;
-                arc_state.t2_size++;
-            }
-        } else if (current_policy == LFU) { // LFU는 이제 5
-            if (buffer[found_idx].ref_arc_list_type == 3) {
-                buffer[found_idx].ref_arc_list_type = 4;
-                if (arc_state.t3_size > 0) arc_state.t3_size--;
-                arc_state.t4_size++;
+    }
+    close(result_fds[1]);
+    for (int k = 0; k < shard.count; k++) {
+        close(queue_fds[k][0]);
+        queues[k] = fdopen(queue_fds[k][1], "wb");
+        if (queues[k] == NULL) { fprintf(stderr, "오류: 샤드 큐 열기 실패\n"); exit(EXIT_FAILURE); }
+        setvbuf(queues[k], NULL, _IOFBF, SHARD_PIPE_BUFFER);
+    }
+
+    ShardMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    unsigned long long seq = 0;
+    while (trace_next(trace, &msg.rec)) {
+        msg.seq = seq++;
+        msg.line_num = trace->line_num;
+        const TraceRecord *rec = &msg.rec;
+        if (rec->kind == TRACE_POLICY) {
+            if (apply_policy_record(rec->policy_code, msg.line_num, seq) < 0) continue;
+            for (int k = 0; k < shard.count; k++) fwrite(&msg, sizeof(msg), 1, queues[k]);
+            continue;
+        }
+        unsigned long long lba = rec->lba, len = rec->len_sectors;
+        if (!trace_request_length_ok(rec, msg.line_num)) continue;
+        unsigned long long first_page = lba_to_page_id(lba);
+        unsigned long long last_page = (len > 0) ? lba_to_page_id(lba + len - 1) : first_page;
+        if (first_page / shard.chunk_pages == last_page / shard.chunk_pages) {
+            fwrite(&msg, sizeof(msg), 1, queues[shard_of_page(first_page)]);
+        } else {
+            ShardMessage part = msg;
+            for (unsigned long long page = first_page; page <= last_page; ) {
+                unsigned long long part_last = MIN(last_page, (page / shard.chunk_pages + 1) * shard.chunk_pages - 1);
+                part.rec.lba = (page == first_page) ? lba : page * SECTORS_PER_PAGE;
+                part.rec.len_sectors = (part_last + 1) * SECTORS_PER_PAGE - part.rec.lba;
+                fwrite(&part, sizeof(part), 1, queues[shard_of_page(page)]);
+                page = part_last + 1;
             }
         }
-        // --- CLOCK 계열 정책 히트 처리 ---
-        else if (current_policy == CLOCK_T1 || current_policy == CLOCK_T3 ||
-                   current_policy == CLOCK_PRO_T1_B4_LOGS_B2 || current_policy == CLOCK_PRO_T3_B2_LOGS_B4) {
-            buffer[found_idx].ref_bit = 1;
+        (*requests)++;
+        *range_pages += last_page - first_page + 1;
+        if (*requests % 1000000 == 0) {
+            printf("  %llu개 LBA 요청 분배 완료 (현재 정책: %s)...\n", *requests, policy_names[current_policy]);
         }
+    }
+    for (int k = 0; k < shard.count; k++) fclose(queues[k]);
 
-    // ========================
-    //      Cache Miss
-    // ========================
-    } else {
-        misses++;
-        // 읽기 미스 시 디스크 읽기 시뮬레이션 (FIO 로그)
-        // 쓰기 미스는 Write Allocate 정책 가정: 먼저 읽고 버퍼에 로드
-        write_fio_log(page_id * SECTORS_PER_PAGE, SECTORS_PER_PAGE, OP_READ);
-
-        // --- 미스 발생 시 정책별 처리 ---
-        int actual_load_list_type = 0;
-        int ref_load_list_type = 0;
+    int received = 0, failed = 0;
+    ShardResult r;
+    while (received < shard.count && read(result_fds[0], &r, sizeof(r)) == (ssize_t)sizeof(r)) {
+        if (r.shard >= 0 && r.shard < shard.count) shard.results[r.shard] = r;
+        received++;
+    }
+    close(result_fds[0]);
+    for (int k = 0; k < shard.count; k++) {
+        int status;
+        if (wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = 1;
+    }
+    if (failed || received != shard.count) { fprintf(stderr, "오류: 샤드 프로세스가 비정상 종료했습니다.\n"); return -1; }
+    clock_gettime(CLOCK_MONOTONIC, &replay_end_time);
+    if (log_file != NULL && shard_merge_logs(log_path) != 0) { fprintf(stderr, "오류: 샤드 FIO 로그 병합 실패\n"); return -1; }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
 
-        // --- ARC 파라미터 조정 및 로드될 리스트 결정 --- (enum 심볼 사용으로 자동 대응)
-        if (current_policy == LRU || current_policy == LRU_ARC) { // LRU는 7, LRU_ARC는 8
-            int is_in_b1 = find_in_arc_ghost(page_id, arc_state.b1, arc_state.b1_size);
-            int is_in_b2 = find_in_arc_ghost(page_id, arc_state.b2, arc_state.b2_size);
+    hits = misses = 0;
+    printf("해시 샤드 시뮬레이션 결과 (청크 %llu 페이지):\n", shard.chunk_pages);
+    printf(" %6s %8s %12s %12s %12s %8s %12s\n", "샤드", "프레임", "요청 조각", "히트", "미스", "히트율", "교체");
+    for (int k = 0; k < shard.count; k++) {
+        const ShardResult *s = &shard.results[k];
+        long long acc = s->hits + s->misses;
+        printf(" %6d %8d %12llu %12lld %12lld %7.2f%% %12llu\n", k, s->frames, s->requests, s->hits, s->misses,
+               acc ? 100.0 * s->hits / acc : 0.0, s->evictions);
+        hits += s->hits;
+        misses += s->misses;
+        evictions += s->evictions;
+        dirty_eviction_stalls += s->dirty_eviction_stalls;
+        clean_victim_picks += s->clean_victim_picks;
+        zns_cost.picks += s->zns_cost_picks;
+        zns_cost.picked_clean += s->zns_cost_picked_clean;
+        zns_cost.picked_seq += s->zns_cost_picked_seq;
+        evict_seq_writebacks += s->evict_seq_writebacks;
+        evict_nonseq_writebacks += s->evict_nonseq_writebacks;
+        for (int i = 0; i < 5; i++) ghost_hits[i] += s->ghost_hits[i];
+        fio_log.ios_submitted += s->ios_submitted;
+        fio_log.ios_written += s->ios_written;
+        shard.dirty_flushed += (int)s->dirty_flushed;
+        // Zone 은 한 샤드에만 속하므로 카운터는 합이 전체 값, 최대 open/active 는 샤드별 최대의 합(상한)
+        zone_table.used += s->zone_used;
+        zone_table.violations += s->zone_violations;
+        zone_table.implicit_opens += s->zone_implicit_opens;
+        zone_table.explicit_opens += s->zone_explicit_opens;
+        zone_table.implicit_closes += s->zone_implicit_closes;
+        zone_table.explicit_closes += s->zone_explicit_closes;
+        zone_table.finishes += s->zone_finishes;
+        zone_table.resets += s->zone_resets;
+        zone_table.peak_open += s->zone_peak_open;
+        zone_table.peak_active += s->zone_peak_active;
+        flusher.runs += s->flusher_runs;
+        flusher.batches += s->flusher_batches;
+        flusher.pages += s->flusher_pages;
+        tinylfu.admits += s->tlfu_admits;
+        tinylfu.rejects += s->tlfu_rejects;
+        tinylfu.agings += s->tlfu_agings;
+        tinylfu.saved_reads += s->tlfu_saved_reads;
+        tinylfu.kept_dirty += s->tlfu_kept_dirty;
+        tinylfu.write_arounds += s->tlfu_write_arounds;
+    }
+    double replay_seconds = (replay_end_time.tv_sec - start_time.tv_sec) + (replay_end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+    double merge_seconds = (end_time.tv_sec - replay_end_time.tv_sec) + (end_time.tv_nsec - replay_end_time.tv_nsec) / 1e9;
+    printf("샤드 %d개 재생 %.3f 초 (%.0f 요청/초), FIO 로그 병합 %.3f 초\n", shard.count, replay_seconds,
+           (replay_seconds > 0) ? (double)*requests / replay_seconds : 0.0, merge_seconds);
+    return 0;
+}
 
-            if (is_in_b1) {
-                int delta = (arc_state.b1_size > 0 && arc_state.b2_size >= 0) ? MAX(1, arc_state.b2_size / arc_state.b1_size) : 1;
-                delta = MAX(1, delta);
-                arc_state.p = MIN(buffer_size, arc_state.p + delta);
-                arc_remove_from_ghost(page_id, arc_state.b1, &arc_state.b1_size);
-                actual_load_list_type = 2;
-                ref_load_list_type = 2;
-            } else if (is_in_b2) {
-                int delta = (arc_state.b2_size > 0 && arc_state.b1_size >= 0) ? MAX(1, arc_state.b1_size / arc_state.b2_size) : 1;
-                delta = MAX(1, delta);
-                arc_state.p = MAX(0, arc_state.p - delta);
-                arc_remove_from_ghost(page_id, arc_state.b2, &arc_state.b2_size);
-                actual_load_list_type = 2;
-                ref_load_list_type = 2;
-            } else {
-                actual_load_list_type = 1;
-                ref_load_list_type = 1;
-            }
-            if (current_policy == LRU) actual_load_list_type = 1; // LRU 캐시는 list_type 1
+// --- 동시 접근 버퍼 풀 ---
+// 트레이스 요청을 메모리에 올린 뒤 N개 스레드가 CONC_CHUNK 개씩 가져가 하나의 공유 버퍼 풀에 접근한다.
+// 기존 9개 정책은 전역 mutex 하나로 보호한 잠금 기반 변형(기존 access 경로 그대로)으로,
+// CLOCK 은 stripe 잠금 페이지 색인 + atomic ref_bit/hand 의 lock-free 교체로 돌려 히트율과 처리량을 비교한다.
 
-        } else if (current_policy == LFU || current_policy == LFU_ARC) { // LFU는 5, LFU_ARC는 6
-            int is_in_b3 = find_in_arc_ghost(page_id, arc_state.b3, arc_state.b3_size);
-            int is_in_b4 = find_in_arc_ghost(page_id, arc_state.b4, arc_state.b4_size);
+static ConcStripe* conc_stripe(unsigned long long page_id) {
+    return &conc.stripes[(page_id * 0x9E3779B97F4A7C15ULL) >> 54 & (CONC_STRIPES - 1)];
+}
 
-            if (is_in_b3) {
-                int delta = (arc_state.b3_size > 0 && arc_state.b4_size >= 0) ? MAX(1, arc_state.b4_size / arc_state.b3_size) : 1;
-                delta = MAX(1, delta);
-                arc_state.q = MIN(buffer_size, arc_state.q + delta);
-                arc_remove_from_ghost(page_id, arc_state.b3, &arc_state.b3_size);
-                actual_load_list_type = 4;
-                ref_load_list_type = 4;
-            } else if (is_in_b4) {
-                int delta = (arc_state.b4_size > 0 && arc_state.b3_size >= 0) ? MAX(1, arc_state.b3_size / arc_state.b4_size) : 1;
-                delta = MAX(1, delta);
-                arc_state.q = MAX(0, arc_state.q - delta);
-                arc_remove_from_ghost(page_id, arc_state.b4, &arc_state.b4_size);
-                actual_load_list_type = 4;
-                ref_load_list_type = 4;
-            } else {
-                actual_load_list_type = 3;
-                ref_load_list_type = 3;
-            }
-            if (current_policy == LFU) actual_load_list_type = 3; // LFU 캐시는 list_type 3
+static void conc_clock_access(unsigned long long page_id, ConcWorker *w) {
+    ConcStripe *s = conc_stripe(page_id);
+    pthread_mutex_lock(&s->lock);
+    unsigned long long idx = u64map_get(&s->map, page_id);
+    if (idx != INVALID_PAGE) {
+        atomic_store_explicit(&conc.frames[idx].ref_bit, 1, memory_order_relaxed);
+        pthread_mutex_unlock(&s->lock);
+        w->hits++;
+        return;
+    }
+    // 미스: 자기 페이지의 stripe 를 쥔 채 hand 를 돌려 희생자를 찾음. 희생자 stripe 는 trylock 만 하므로 교착 없음
+    for (;;) {
+        unsigned long long h = atomic_fetch_add_explicit(&conc.hand, 1, memory_order_relaxed) % (unsigned long long)conc.frame_count;
+        ConcFrame *f = &conc.frames[h];
+        if (atomic_exchange_explicit(&f->ref_bit, 0, memory_order_relaxed)) continue; // second chance
+        unsigned char expected = 0;
+        if (!atomic_compare_exchange_strong(&f->busy, &expected, 1)) continue;
+        unsigned long long old = atomic_load(&f->page_id);
+        if (old != INVALID_PAGE) {
+            ConcStripe *vs = conc_stripe(old);
+            if (vs != s && pthread_mutex_trylock(&vs->lock) != 0) { atomic_store(&f->busy, 0); w->retries++; continue; }
+            u64map_remove(&vs->map, old);
+            if (vs != s) pthread_mutex_unlock(&vs->lock);
+            w->evictions++;
+        }
+        atomic_store(&f->page_id, page_id);
+        u64map_put(&s->map, page_id, h);
+        atomic_store(&f->busy, 0);
+        break;
+    }
+    pthread_mutex_unlock(&s->lock);
+    w->misses++;
+}
 
-        } else if (current_policy == CLOCK_T1) { // CLOCK_T1은 2
-            actual_load_list_type = 1;
-        } else if (current_policy == CLOCK_T3) { // CLOCK_T3은 3
-            actual_load_list_type = 3;
-        } else if (current_policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_PRO_T1...은 0
-            actual_load_list_type = 1;
-            if (find_in_arc_ghost(page_id, arc_state.b4, arc_state.b4_size)) {
-                int delta_val = (arc_state.t1_size > 0 && arc_state.b4_size > 0) ? MAX(1, arc_state.t1_size / arc_state.b4_size) : 1;
-                if (arc_state.t1_size == 0 && arc_state.b4_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.b4_size);
-                delta_val = MAX(1, delta_val);
-                arc_state.p = MIN(buffer_size, arc_state.p + delta_val);
-                arc_remove_from_ghost(page_id, arc_state.b4, &arc_state.b4_size);
-            } else {
-                int delta_val = (arc_state.t1_size > 0 && arc_state.b4_size > 0) ? MAX(1, arc_state.b4_size / arc_state.t1_size) : 1;
-                if (arc_state.b4_size == 0 && arc_state.t1_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.t1_size);
-                delta_val = MAX(1, delta_val);
-                arc_state.p = MAX(0, arc_state.p - delta_val);
-            }
-        } else if (current_policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_PRO_T3...은 1
-            actual_load_list_type = 3;
-            if (find_in_arc_ghost(page_id, arc_state.b2, arc_state.b2_size)) {
-                int delta_val = (arc_state.t3_size > 0 && arc_state.b2_size > 0) ? MAX(1, arc_state.t3_size / arc_state.b2_size) : 1;
-                if (arc_state.t3_size == 0 && arc_state.b2_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.b2_size);
-                delta_val = MAX(1, delta_val);
-                arc_state.q = MIN(buffer_size, arc_state.q + delta_val);
-                arc_remove_from_ghost(page_id, arc_state.b2, &arc_state.b2_size);
+static void *conc_worker(void *arg) {
+    ConcWorker *w = (ConcWorker*)arg;
+    for (;;) {
+        unsigned long long start = atomic_fetch_add(&conc.next, CONC_CHUNK);
+        if (start >= conc.count) break;
+        unsigned long long end = MIN(start + CONC_CHUNK, conc.count);
+        for (unsigned long long i = start; i < end; i++) {
+            const TraceRecord *rec = &conc.recs[i];
+            if (conc.lock_free) {
+                unsigned long long first = lba_to_page_id(rec->lba);
+                unsigned long long last = (rec->len_sectors > 0) ? lba_to_page_id(rec->lba + rec->len_sectors - 1) : first;
+                for (unsigned long long p = first; p <= last; p++) conc_clock_access(p, w);
             } else {
-                int delta_val = (arc_state.t3_size > 0 && arc_state.b2_size > 0) ? MAX(1, arc_state.b2_size / arc_state.t3_size) : 1;
-                if (arc_state.b2_size == 0 && arc_state.t3_size > 0 && buffer_size > 0) delta_val = MAX(1, buffer_size / arc_state.t3_size);
-                delta_val = MAX(1, delta_val);
-                arc_state.q = MAX(0, arc_state.q - delta_val);
+                pthread_mutex_lock(&conc.big_lock);
+                simulate_request(rec, 0);
+                pthread_mutex_unlock(&conc.big_lock);
             }
         }
-        // FIFO (이제 4)는 별도의 actual_load_list_type 설정 로직이 이 블록에 없음.
-        // 아래 새 페이지 로드 시 FIFO의 list_type은 0으로 설정됨.
-
-        // --- 버퍼 공간 확보 (Eviction) --- (enum 심볼 사용으로 자동 대응)
-        target_slot = find_empty_slot();
-        if (target_slot == -1) {
-            int victim_idx = -1;
-            unsigned long long evicted_page_id = INVALID_PAGE;
-
-            // 정책별 희생자 선택
-            if (current_policy == FIFO) victim_idx = evict_fifo(); // FIFO는 4
-            else if (current_policy == LRU) victim_idx = evict_arc_internal_lru(1); // LRU는 7
-            else if (current_policy == LFU) victim_idx = evict_arc_internal_lfu(3); // LFU는 5
-            else if (current_policy == LRU_ARC) victim_idx = arc_find_victim_lru_arc(page_id); // LRU_ARC는 8
-            else if (current_policy == LFU_ARC) victim_idx = arc_find_victim_lfu_arc(page_id); // LFU_ARC는 6
-            else if (current_policy == CLOCK_T1) victim_idx = evict_via_clock_policy(&global_clk_hand, 0, 0, buffer, buffer_size, policy_names[current_policy]); // CLOCK_T1은 2
-            else if (current_policy == CLOCK_T3) victim_idx = evict_via_clock_policy(&global_clk_hand, 0, 0, buffer, buffer_size, policy_names[current_policy]); // CLOCK_T3은 3
-            else if (current_policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_PRO_T1...은 0
-                 while (arc_state.t1_size >= arc_state.p && arc_state.t1_size > 0) {
-                     victim_idx = evict_via_clock_policy(&arc_state.p_clk_hand, 1, 1, buffer, buffer_size, policy_names[current_policy]);
-                     if (victim_idx != -1) break;
-                     fprintf(stderr, "CLOCK_PRO_T1 Warning: Could not find victim in T1 despite T1 size >= p. Check state.\n");
-                     break;
-                 }
-                 if (victim_idx == -1) {
-                     victim_idx = evict_via_clock_policy(&arc_state.p_clk_hand, 0, 0, buffer, buffer_size, "CLOCK_PRO_T1_Fallback");
-                 }
-            } else if (current_policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_PRO_T3...은 1
-                 while (arc_state.t3_size >= arc_state.q && arc_state.t3_size > 0) {
-                     victim_idx = evict_via_clock_policy(&arc_state.q_clk_hand, 1, 3, buffer, buffer_size, policy_names[current_policy]);
-                     if (victim_idx != -1) break;
-                     fprintf(stderr, "CLOCK_PRO_T3 Warning: Could not find victim in T3 despite T3 size >= q. Check state.\n");
-                     break;
-                 }
-                 if (victim_idx == -1) {
-                     victim_idx = evict_via_clock_policy(&arc_state.q_clk_hand, 0, 0, buffer, buffer_size, "CLOCK_PRO_T3_Fallback");
-                 }
-            }
-
-            // 최종 희생자 선택 실패 시 Fallback
-            if (victim_idx == -1 && buffer_size > 0) {
-                 victim_idx = evict_fifo();
-                 if (victim_idx != -1 && buffer[victim_idx].page_id != INVALID_PAGE) {
-                     int list_of_fifo_victim = buffer[victim_idx].list_type;
-                     if (current_policy == LRU_ARC || current_policy == LRU || current_policy == CLOCK_PRO_T1_B4_LOGS_B2 || current_policy == CLOCK_T1) {
-                         if (list_of_fifo_victim == 1 && arc_state.t1_size > 0) arc_state.t1_size--;
-                         else if (list_of_fifo_victim == 2 && arc_state.t2_size > 0) arc_state.t2_size--;
-                     }
-                     if (current_policy == LFU_ARC || current_policy == LFU || current_policy == CLOCK_PRO_T3_B2_LOGS_B4 || current_policy == CLOCK_T3) {
-                         if (list_of_fifo_victim == 3 && arc_state.t3_size > 0) arc_state.t3_size--;
-                         else if (list_of_fifo_victim == 4 && arc_state.t4_size > 0) arc_state.t4_size--;
-                     }
-                 }
-            }
+    }
+    return NULL;
+}
 
-            // 희생자 처리
-            if (victim_idx != -1) {
-                handle_dirty_eviction(victim_idx); // ZNS 제약 검사는 handle_dirty_eviction -> write_fio_log 에서 처리
-                evicted_page_id = buffer[victim_idx].page_id;
-
-                // --- 정책별 고스트 리스트 및 로그/히스토리 업데이트 --- (enum 심볼 사용으로 자동 대응)
-                if (current_policy == LRU && evicted_page_id != INVALID_PAGE) { // LRU는 7
-                    if (buffer[victim_idx].ref_arc_list_type == 1) {
-                        arc_add_to_ghost_mru(evicted_page_id, arc_state.b1, &arc_state.b1_size, buffer_size);
-                        if(arc_state.t1_size > 0) arc_state.t1_size--;
-                    } else if (buffer[victim_idx].ref_arc_list_type == 2) {
-                        arc_add_to_ghost_mru(evicted_page_id, arc_state.b2, &arc_state.b2_size, buffer_size);
-                        if(arc_state.t2_size > 0) arc_state.t2_size--;
-                    }
-                } else if (current_policy == LFU && evicted_page_id != INVALID_PAGE) { // LFU는 5
-                     if (buffer[victim_idx].ref_arc_list_type == 3) {
-                        arc_add_to_ghost_mru(evicted_page_id, arc_state.b3, &arc_state.b3_size, buffer_size);
-                        if(arc_state.t3_size > 0) arc_state.t3_size--;
-                    } else if (buffer[victim_idx].ref_arc_list_type == 4) {
-                        arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size);
-                        if(arc_state.t4_size > 0) arc_state.t4_size--;
-                    }
-                }
-                else if (current_policy == CLOCK_PRO_T1_B4_LOGS_B2 && evicted_page_id != INVALID_PAGE) { // CLOCK_PRO_T1...은 0
-                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size); // B4는 히스토리
-                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b2, &arc_state.b2_size, buffer_size); // B2는 로그
-                    if(arc_state.t1_size > 0 && buffer[victim_idx].list_type == 1) arc_state.t1_size--;
-                } else if (current_policy == CLOCK_PRO_T3_B2_LOGS_B4 && evicted_page_id != INVALID_PAGE) { // CLOCK_PRO_T3...은 1
-                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b2, &arc_state.b2_size, buffer_size); // B2는 히스토리
-                    arc_add_to_ghost_mru(evicted_page_id, arc_state.b4, &arc_state.b4_size, buffer_size); // B4는 로그
-                    if(arc_state.t3_size > 0 && buffer[victim_idx].list_type == 3) arc_state.t3_size--;
-                }
+// 정책 하나를 threads 개 스레드로 재생. policy < 0 이면 lock-free CLOCK
+static void conc_run_one(int policy, int threads, unsigned long long total_pages) {
+    ConcWorker workers[CONC_MAX_THREADS];
+    memset(workers, 0, sizeof(workers));
+    atomic_store(&conc.next, 0);
+    conc.lock_free = (policy < 0);
+    if (conc.lock_free) {
+        for (int i = 0; i < conc.frame_count; i++) {
+            atomic_store(&conc.frames[i].page_id, INVALID_PAGE);
+            atomic_store(&conc.frames[i].ref_bit, 0);
+            atomic_store(&conc.frames[i].busy, 0);
+        }
+        for (int i = 0; i < CONC_STRIPES; i++) {
+            for (unsigned long long j = 0; j < conc.stripes[i].map.capacity; j++) conc.stripes[i].map.keys[j] = INVALID_PAGE;
+            conc.stripes[i].map.count = 0;
+        }
+        atomic_store(&conc.hand, 0);
+    } else {
+        current_policy = (ReplacementPolicy)policy;
+        previous_policy_for_state_carryover = current_policy;
+        initialize_buffer();
+        initialize_arc_state(1);
+        evictions = 0;
+    }
 
-                buffer[victim_idx].page_id = INVALID_PAGE;
-                target_slot = victim_idx;
-            }
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&workers[t].tid, NULL, conc_worker, &workers[t]) != 0) {
+            fprintf(stderr, "오류: 스레드 생성 실패\n"); exit(EXIT_FAILURE);
         }
+    }
+    for (int t = 0; t < threads; t++) pthread_join(workers[t].tid, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
 
-        // --- 새 페이지 로드 ---
-        if (target_slot != -1) {
-            buffer[target_slot].page_id = page_id;
-            buffer[target_slot].load_time = current_time;
-            buffer[target_slot].last_access_time = current_time;
-            buffer[target_slot].access_count = 1;
-            buffer[target_slot].is_dirty = (operation_type == OP_WRITE); // 쓰기 미스 시 dirty 설정 (Write Allocate)
-            buffer[target_slot].list_type = actual_load_list_type; // 위에서 결정된 actual_load_list_type 사용
-            buffer[target_slot].ref_bit = 1; // CLOCK 계열을 위해 기본적으로 1로 설정
-
-            // 정책별 리스트 크기 및 참조 상태 업데이트 (enum 심볼 사용으로 자동 대응)
-            if (current_policy == LRU) { // LRU는 7
-                buffer[target_slot].ref_arc_list_type = ref_load_list_type;
-                if (ref_load_list_type == 1) arc_state.t1_size++; else if (ref_load_list_type == 2) arc_state.t2_size++;
-            } else if (current_policy == LFU) { // LFU는 5
-                buffer[target_slot].ref_arc_list_type = ref_load_list_type;
-                if (ref_load_list_type == 3) arc_state.t3_size++; else if (ref_load_list_type == 4) arc_state.t4_size++;
-            }
-            else if (current_policy == LRU_ARC) { // LRU_ARC는 8
-                buffer[target_slot].ref_arc_list_type = 0; // ARC 자체이므로 ref_arc_list_type 불필요
-                if (actual_load_list_type == 1) arc_state.t1_size++; else if (actual_load_list_type == 2) arc_state.t2_size++;
-            } else if (current_policy == LFU_ARC) { // LFU_ARC는 6
-                buffer[target_slot].ref_arc_list_type = 0; // ARC 자체이므로 ref_arc_list_type 불필요
-                if (actual_load_list_type == 3) arc_state.t3_size++; else if (actual_load_list_type == 4) arc_state.t4_size++;
-            } else if (current_policy == CLOCK_T1) { // CLOCK_T1은 2
-                 buffer[target_slot].ref_arc_list_type = 0;
-                 buffer[target_slot].list_type = 1; // T1 캐시
-                 if (arc_state.t1_size < buffer_size) arc_state.t1_size++;
-            } else if (current_policy == CLOCK_T3) { // CLOCK_T3은 3
-                 buffer[target_slot].ref_arc_list_type = 0;
-                 buffer[target_slot].list_type = 3; // T3 캐시
-                 if (arc_state.t3_size < buffer_size) arc_state.t3_size++;
-            } else if (current_policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_PRO_T1...은 0
-                buffer[target_slot].ref_arc_list_type = 0;
-                buffer[target_slot].list_type = 1; // T1 캐시
-                if (arc_state.t1_size < buffer_size) arc_state.t1_size++;
-                arc_add_to_ghost_mru(page_id, arc_state.b2, &arc_state.b2_size, buffer_size); // b2는 로그
-            } else if (current_policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_PRO_T3...은 1
-                buffer[target_slot].ref_arc_list_type = 0;
-                buffer[target_slot].list_type = 3; // T3 캐시
-                if (arc_state.t3_size < buffer_size) arc_state.t3_size++;
-                arc_add_to_ghost_mru(page_id, arc_state.b4, &arc_state.b4_size, buffer_size); // b4는 로그
-            } else if (current_policy == FIFO) { // FIFO는 4
-                 buffer[target_slot].ref_arc_list_type = 0;
-                 buffer[target_slot].ref_bit = 0; // FIFO는 ref_bit 사용 안 함
-                 buffer[target_slot].list_type = 0; // FIFO의 경우 list_type을 0으로 설정 (실제 정책과 무관한 기본값)
-                                                     // 또는 FIFO 고유 list_type (예: 4)을 사용하려면 여기서 설정
-            }
-        } else if (buffer_size > 0) {
-            // fprintf(stderr, "CRITICAL Error: Failed to find or create a slot for page %llu. Policy: %s\n", page_id, policy_names[current_policy]);
+    long long run_hits = 0, run_misses = 0;
+    unsigned long long run_evictions = 0, retries = 0;
+    if (conc.lock_free) {
+        for (int t = 0; t < threads; t++) {
+            run_hits += workers[t].hits;
+            run_misses += workers[t].misses;
+            run_evictions += workers[t].evictions;
+            retries += workers[t].retries;
         }
-    } // End Cache Miss
+    } else {
+        run_hits = hits;
+        run_misses = misses;
+        run_evictions = evictions;
+    }
+    long long acc = run_hits + run_misses;
+    printf(" %-24s %-14s %7d %12lld %12lld %7.2f%% %12llu %12.0f %12.0f",
+           conc.lock_free ? "CLOCK (lock-free)" : policy_names[policy], conc.lock_free ? "atomic+stripe" : "전역 mutex",
+           threads, run_hits, run_misses, acc ? 100.0 * run_hits / acc : 0.0, run_evictions,
+           (seconds > 0) ? conc.count / seconds : 0.0, (seconds > 0) ? total_pages / seconds : 0.0);
+    if (conc.lock_free) printf("  (희생자 잠금 재시도 %llu)", retries);
+    printf("\n");
 }
 
-/* // 버퍼 상태 출력 함수 전체 주석 처리 시작
-void print_buffer_state() {
-    // ... (내용 동일) ...
-}
-*/ // 버퍼 상태 출력 함수 전체 주석 처리 끝
+// 트레이스의 접근 요청을 모두 읽어 스레드 수 x 정책 조합마다 재생하고 히트율과 처리량(요청/초)을 출력.
+// 트레이스의 P 명령은 무시 (행마다 정책 고정)
+int concurrent_run(TraceReader *trace, const int *thread_counts, int num_thread_counts, const int *policies, int num_policies) {
+    unsigned long long capacity = 1 << 16, total_pages = 0, ignored_policy_lines = 0;
+    TraceRecord *recs = (TraceRecord*)malloc(capacity * sizeof(TraceRecord));
+    if (recs == NULL) { fprintf(stderr, "오류: 요청 배열 할당 실패\n"); return 1; }
+    conc.count = 0;
+    TraceRecord rec;
+    while (trace_next(trace, &rec)) {
+        if (rec.kind == TRACE_POLICY) { ignored_policy_lines++; continue; }
+        if (!trace_request_length_ok(&rec, -1)) continue;
+        if (conc.count == capacity) {
+            TraceRecord *grown = (TraceRecord*)realloc(recs, capacity * 2 * sizeof(TraceRecord));
+            if (grown == NULL) { fprintf(stderr, "오류: 요청 배열 할당 실패\n"); free(recs); return 1; }
+            recs = grown;
+            capacity *= 2;
+        }
+        recs[conc.count++] = rec;
+        total_pages += (rec.len_sectors > 0) ? lba_to_page_id(rec.lba + rec.len_sectors - 1) - lba_to_page_id(rec.lba) + 1 : 1;
+    }
+    conc.recs = recs;
+    conc.frame_count = buffer_size;
+    conc.frames = (ConcFrame*)calloc((size_t)buffer_size, sizeof(ConcFrame));
+    conc.stripes = (ConcStripe*)aligned_alloc(64, CONC_STRIPES * sizeof(ConcStripe));
+    if (conc.frames == NULL || conc.stripes == NULL) { fprintf(stderr, "오류: 동시 버퍼 풀 할당 실패\n"); return 1; }
+    for (int i = 0; i < CONC_STRIPES; i++) {
+        pthread_mutex_init(&conc.stripes[i].lock, NULL);
+        if (u64map_init(&conc.stripes[i].map, MAX(16ULL, 2ULL * buffer_size / CONC_STRIPES)) != 0) {
+            fprintf(stderr, "오류: 동시 버퍼 풀 색인 할당 실패\n"); return 1;
+        }
+    }
+    pthread_mutex_init(&conc.big_lock, NULL);
+
+    printf("동시 접근 버퍼 풀: 요청 %llu개 (%llu 페이지), 버퍼 %d 프레임, 색인 stripe %d개\n",
+           conc.count, total_pages, buffer_size, CONC_STRIPES);
+    if (ignored_policy_lines > 0) printf("  트레이스의 P 라인 %llu개는 무시했습니다 (행마다 정책 고정).\n", ignored_policy_lines);
+    printf(" %-24s %-14s %7s %12s %12s %8s %12s %12s %12s\n", "정책", "동기화", "스레드", "히트", "미스", "히트율", "교체", "요청/초", "페이지/초");
+    for (int t = 0; t < num_thread_counts; t++) {
+        conc_run_one(-1, thread_counts[t], total_pages);
+        for (int i = 0; i < num_policies; i++) conc_run_one(policies[i], thread_counts[t], total_pages);
+    }
 
+    for (int i = 0; i < CONC_STRIPES; i++) {
+        pthread_mutex_destroy(&conc.stripes[i].lock);
+        u64map_free(&conc.stripes[i].map);
+    }
+    pthread_mutex_destroy(&conc.big_lock);
+    free(conc.stripes);
+    free(conc.frames);
+    free(recs);
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--generate") == 0) return generate_trace_main(argc, argv);
     // 인수 개수 확인
     if (argc < 5) {
         fprintf(stderr, "사용법: %s <버퍼_크기> <초기_정책_이름> <워크로드_파일명> <존_크기_페이지>\n", argv[0]);
         // 사용 가능 정책 목록 업데이트
-        fprintf(stderr, "사용 가능 정책 (이름): CLOCK_PRO_T1_B4_LOGS_B2, CLOCK_PRO_T3_B2_LOGS_B4, CLOCK_T1, CLOCK_T3, FIFO, LFU, LFU_ARC, LRU, LRU_ARC\n");
-        fprintf(stderr, "워크로드 파일 내 정책 변경: P <정책코드> (0..8)\n"); // 정책 코드 범위 업데이트
+        fprintf(stderr, "사용 가능 정책 (이름): CLOCK_PRO_T1_B4_LOGS_B2, CLOCK_PRO_T3_B2_LOGS_B4, CLOCK_T1, CLOCK_T3, FIFO, LFU, LFU_ARC, LRU, LRU_ARC, CLOCK_PRO, S3_FIFO, SIEVE, LIRS\n");
+        fprintf(stderr, "워크로드 파일 내 정책 변경: P <정책코드> (0..8, 10 = CLOCK_PRO, 11 = S3_FIFO, 12 = SIEVE, 13 = LIRS; 9 는 예약)\n"); // 정책 코드 범위 업데이트
+        fprintf(stderr, "워크로드 요청 형식: <LBA> <r|w> [길이_섹터] (길이가 있으면 걸친 모든 페이지를 한 요청으로 처리)\n");
         fprintf(stderr, "존_크기_페이지: 존 하나당 페이지 수 (0이면 ZNS 비활성화)\n");
+        fprintf(stderr, "선택 옵션:\n");
+        fprintf(stderr, "  --fio-coalesce=<KB>   연속된 같은 방향 I/O를 최대 KB 크기까지 병합 (기본: 0, 병합 안 함)\n");
+        fprintf(stderr, "  --fio-window=<N>      병합 시 재정렬 윈도우 크기 (기본: %d, 최대: %d)\n", FIO_COALESCE_DEFAULT_WINDOW, FIO_COALESCE_MAX_WINDOW);
+        fprintf(stderr, "  --zns-max-open=<N>    동시에 open 가능한 Zone 수 (기본: 0, 제한 없음)\n");
+        fprintf(stderr, "  --zns-max-active=<N>  동시에 active(open+closed) 가능한 Zone 수 (기본: 0, 제한 없음)\n");
+        fprintf(stderr, "  --zns-events=<파일>   Zone open/close/finish/reset 이벤트 기록 파일\n");
+        fprintf(stderr, "  --zns-lsl=<N>         로그 구조 write-back 계층 활성, 예비 Zone N개 (기본: 0, 비활성)\n");
+        fprintf(stderr, "  --zns-zones=<N>       로그 구조 계층의 논리 Zone 수 (기본: %d)\n", MAX_ZONES);
+        fprintf(stderr, "  --zns-gc-threshold=<N> 여유 Zone 이 N개 이하가 되면 GC (기본: %d)\n", LSL_DEFAULT_GC_THRESHOLD);
+        fprintf(stderr, "  --flush-high=<%%>      더티 프레임 비율이 이 값에 도달하면 백그라운드 flush (기본: 0, 비활성)\n");
+        fprintf(stderr, "  --flush-low=<%%>       flush 를 멈추는 더티 프레임 비율 (기본: high 의 절반)\n");
+        fprintf(stderr, "  --flush-batch=<N>     flush batch 당 페이지 수 (기본: %d)\n", FLUSH_DEFAULT_BATCH);
+        fprintf(stderr, "  --flush-order=<lba|zone> flush 순서: LBA 정렬 또는 Zone 단위 묶음 (기본: lba)\n");
+        fprintf(stderr, "  --prefer-clean=<N>    희생자 선택 시 최대 N개의 더티 후보를 건너뛰고 clean 페이지 선택 (기본: 0, 최대: %d)\n", FLUSH_MAX_CLEAN_WINDOW);
+        fprintf(stderr, "  --zns-cost=<N>        정책 순서상 다음 N개 후보까지 순위 + write-back 비용으로 희생자 선택 (기본: 0, 최대: %d)\n", FLUSH_MAX_CLEAN_WINDOW);
+        fprintf(stderr, "  --zns-cost-penalty=<N> 비순차 write-back 이 될 더티 후보의 비용 (clean 0, 쓰기 포인터 순차 1, 기본: %d)\n", ZNS_COST_DEFAULT_PENALTY);
+        fprintf(stderr, "  --readahead=<N>       순차/stride 스트림 선반입, 최대 윈도우 N 페이지 (기본: 0, 비활성)\n");
+        fprintf(stderr, "  --ra-min=<N>          스트림 감지 직후 선반입 윈도우 (기본: %d)\n", RA_DEFAULT_MIN_WINDOW);
+        fprintf(stderr, "  --ra-streams=<N>      동시에 추적하는 스트림 수 (기본: %d, 최대: %d)\n", RA_DEFAULT_STREAMS, RA_MAX_STREAMS);
+        fprintf(stderr, "  --ra-region=<N>       stride 감지 영역 크기 (페이지, 기본: %d)\n", RA_DEFAULT_REGION_PAGES);
+        fprintf(stderr, "  --ra-max-pct=<%%>      참조되지 않은 선반입 페이지의 최대 버퍼 비율 (기본: %d)\n", RA_DEFAULT_MAX_PCT);
+        fprintf(stderr, "  --tinylfu=<N>         TinyLFU 승인 필터: 희생자보다 추정 빈도가 높은 미스 페이지만 적재, 노화 주기 N x 버퍼 크기 접근\n");
+        fprintf(stderr, "                        (기본: 0, 비활성, 권장: %d, 최대: %d)\n", TINYLFU_DEFAULT_SAMPLE_FACTOR, TINYLFU_MAX_SAMPLE_FACTOR);
+        fprintf(stderr, "  --tenants=<파일>      테넌트 분할: '<첫 페이지> <끝 페이지> <테넌트>' 줄의 맵 (맵 밖은 테넌트 0, 최대 %d 테넌트)\n", UCP_MAX_TENANTS);
+        fprintf(stderr, "                        UMON 히트 곡선으로 할당량을 주기적으로 다시 나누고 교체는 할당량 안에서\n");
+        fprintf(stderr, "  --ucp-interval=<N>    테넌트 할당량 재계산 주기 (접근 수, 기본: %d)\n", UCP_DEFAULT_INTERVAL);
+        fprintf(stderr, "  --dev-model=<nvme|zns|sata|hdd> 장치 지연/큐잉 모델 활성, 요청 지연 분포(p50/p99/p99.9)와 IOPS 출력\n");
+        fprintf(stderr, "  --dev-read-us=<N>, --dev-write-us=<N>, --dev-reset-us=<N>, --dev-xfer-us=<N>\n");
+        fprintf(stderr, "                        프리셋의 읽기/쓰기/Zone reset/추가 페이지 전송 시간 덮어쓰기 (us)\n");
+        fprintf(stderr, "  --dev-channels=<N>    장치 병렬 채널 수 (최대 %d), --dev-qd=<N> 장치 큐 깊이 (최대 %d)\n", DEV_MAX_CHANNELS, DEV_MAX_QUEUE_DEPTH);
+        fprintf(stderr, "  --dev-hit-ns=<N>      버퍼 히트 1 페이지 처리 시간 (기본: %d ns)\n", DEV_DEFAULT_HIT_NS);
+        fprintf(stderr, "  --replay=<closed|open> closed: 직전 요청 완료 후 다음 요청 도착 (기본), open: 트레이스 타임스탬프(@us)에 도착\n");
+        fprintf(stderr, "  --replay-speed=<%%>    open-loop 도착 간격 배속 (기본: 100, 200 이면 두 배 빠르게)\n");
+        fprintf(stderr, "  --timeseries=<파일>   초 단위 도착/완료/히트율/backlog/지연 CSV 기록 (--dev-model 필요)\n");
+        fprintf(stderr, "  --metrics=<파일>      구간별 지표(히트/미스, 교체, 고스트 히트 B1..B4, ZNS 위반, p/q, T1..T4) 기록\n");
+        fprintf(stderr, "  --metrics-every=<N>   N 요청마다 interval 행 기록 (기본: 100000, 0 이면 정책 구간 행만)\n");
+        fprintf(stderr, "  --metrics-format=<csv|json> 지표 형식 (기본: 파일 확장자가 .json/.jsonl 이면 json, 아니면 csv)\n");
+        fprintf(stderr, "  --label=<파일>        오라클 라벨 생성: 창마다 xg.c 특징과 라벨 클래스 정책(코드 0~8)의 히트 수, 최고 정책을 CSV 로 기록\n");
+        fprintf(stderr, "  --label-window=<N>    라벨 창 크기 (요청 수, 기본: %d)\n", LABEL_DEFAULT_WINDOW);
+        fprintf(stderr, "  --label-jobs=<N>      동시에 재생하는 자식 프로세스 수 (기본: CPU 수)\n");
+        fprintf(stderr, "  --label-follow=<best|정책> 다음 창의 예열 상태를 만드는 궤적 (기본: best, 창마다 최고 정책)\n");
+        fprintf(stderr, "  --label-warmup=<N>    라벨 전 초기 정책으로 예열할 요청 수 (기본: 0)\n");
+        fprintf(stderr, "  --checkpoint=<파일>   시뮬레이터 전체 상태와 트레이스 위치를 저장 (같은 빌드에서만 복원 가능)\n");
+        fprintf(stderr, "  --checkpoint-at=<N>   N번째 줄(바이너리는 레코드)까지 처리한 뒤 저장 (기본: 트레이스 끝)\n");
+        fprintf(stderr, "  --restore=<파일>      체크포인트에서 상태를 복원하고 저장된 위치부터 이어서 재생 (버퍼/존 크기와 계층 옵션은 같게)\n");
+        fprintf(stderr, "  --whatif=<정책,...|all> 분기 지점에서 정책마다 자식 프로세스로 나머지를 재생해 결과 비교\n");
+        fprintf(stderr, "  --whatif-at=<N>       N번째 줄까지 처리한 뒤 분기 (기본: 0, 시작 또는 복원 직후)\n");
+        fprintf(stderr, "  --whatif-requests=<N> 분기 후 재생할 요청 수 (기본: 0, 트레이스 끝까지)\n");
+        fprintf(stderr, "  --shards=<K>          페이지 해시로 K개 독립 캐시(각 버퍼/K 프레임)에 나눠 병렬 재생 (기본: 0, 비활성, 최대: %d)\n", SHARD_MAX);
+        fprintf(stderr, "  --shard-chunk=<N>     같은 샤드로 보내는 연속 페이지 수 (기본: 1, ZNS 활성 시 존 크기로 고정)\n");
+        fprintf(stderr, "  --concurrent=<N[,N...]> N개 스레드가 공유 버퍼 풀에 동시 접근: lock-free CLOCK 과 전역 mutex 정책의 히트율/처리량 비교\n");
+        fprintf(stderr, "  --concurrent-policies=<정책,...|all> 전역 mutex 로 돌릴 정책 (기본: all)\n");
+        fprintf(stderr, "  (워크로드 파일이 \"%s\" 헤더로 시작하면 바이너리 트레이스로 읽음)\n", TRACE_BINARY_MAGIC);
+        fprintf(stderr, "합성 트레이스 생성: %s --generate <출력_파일|-> --phase=<패턴>[,키=값...] ... (자세한 사용법은 인수 없이 실행)\n", argv[0]);
         return 1;
     }
 
@@ -889,22 +6470,8 @@ int main(int argc, char *argv[]) {
 
     // 초기 정책 이름 파싱
     char* initial_policy_arg_orig = argv[2];
-    char initial_policy_arg_lower[256];
-    strncpy(initial_policy_arg_lower, initial_policy_arg_orig, sizeof(initial_policy_arg_lower) -1);
-    initial_policy_arg_lower[sizeof(initial_policy_arg_lower)-1] = '\0';
-    for (char *p = initial_policy_arg_lower; *p; ++p) *p = tolower(*p);
-
-    // 정책 이름 비교 및 설정 (새로운 순서와 값에 맞게)
-    // enum 심볼을 사용하므로, strcmp만 정확하면 current_policy에 올바른 enum 값이 할당됨.
-    if (strcmp(initial_policy_arg_lower, "clock_pro_t1_b4_logs_b2") == 0) current_policy = CLOCK_PRO_T1_B4_LOGS_B2; // 0
-    else if (strcmp(initial_policy_arg_lower, "clock_pro_t3_b2_logs_b4") == 0) current_policy = CLOCK_PRO_T3_B2_LOGS_B4; // 1
-    else if (strcmp(initial_policy_arg_lower, "clock_t1") == 0) current_policy = CLOCK_T1; // 2
-    else if (strcmp(initial_policy_arg_lower, "clock_t3") == 0) current_policy = CLOCK_T3; // 3
-    else if (strcmp(initial_policy_arg_lower, "fifo") == 0) current_policy = FIFO;       // 4
-    else if (strcmp(initial_policy_arg_lower, "lfu") == 0) current_policy = LFU;         // 5
-    else if (strcmp(initial_policy_arg_lower, "lfu_arc") == 0) current_policy = LFU_ARC; // 6
-    else if (strcmp(initial_policy_arg_lower, "lru") == 0) current_policy = LRU;         // 7
-    else if (strcmp(initial_policy_arg_lower, "lru_arc") == 0) current_policy = LRU_ARC; // 8
+    int initial_policy_code = policy_code_from_name(initial_policy_arg_orig);
+    if (initial_policy_code >= 0) current_policy = (ReplacementPolicy)initial_policy_code;
     else {
         fprintf(stderr, "경고: 잘못된 초기 정책 이름 '%s'. 기본 정책인 FIFO로 설정합니다.\n", initial_policy_arg_orig);
         current_policy = FIFO; // 기본값 FIFO (새로운 값 4)
@@ -925,8 +6492,208 @@ int main(int argc, char *argv[]) {
     }
     zone_size_pages_global = val_zs;
 
+    // 선택 옵션 파싱 (--이름=값)
+    unsigned long long fio_coalesce_kb = 0;
+    unsigned long long fio_window = FIO_COALESCE_DEFAULT_WINDOW;
+    unsigned long long zns_max_open = 0, zns_max_active = 0;
+    unsigned long long lsl_spare_zones = 0, lsl_logical_zones = MAX_ZONES, lsl_gc_threshold = LSL_DEFAULT_GC_THRESHOLD;
+    const char *zns_event_path = NULL;
+    unsigned long long flush_high_pct = 0, flush_low_pct = ULLONG_MAX, flush_batch = FLUSH_DEFAULT_BATCH, prefer_clean = 0;
+    unsigned long long zns_cost_window = 0, zns_cost_penalty = ZNS_COST_DEFAULT_PENALTY;
+    const char *flush_order_name = "lba";
+    unsigned long long ra_max_window = 0, ra_min_window = RA_DEFAULT_MIN_WINDOW, ra_streams = RA_DEFAULT_STREAMS;
+    unsigned long long ra_region = RA_DEFAULT_REGION_PAGES, ra_max_pct = RA_DEFAULT_MAX_PCT;
+    unsigned long long tinylfu_factor = 0;
+    const char *tenant_map_path = NULL;
+    unsigned long long ucp_interval = UCP_DEFAULT_INTERVAL;
+    const char *dev_model_name = NULL;
+    unsigned long long dev_read_us = ULLONG_MAX, dev_write_us = ULLONG_MAX, dev_reset_us = ULLONG_MAX, dev_xfer_us = ULLONG_MAX;
+    unsigned long long dev_channels = 0, dev_qd = 0, dev_hit_ns = DEV_DEFAULT_HIT_NS;
+    const char *replay_mode = "closed", *timeseries_path = NULL;
+    unsigned long long replay_speed = 100;
+    const char *metrics_path = NULL, *metrics_format = NULL;
+    unsigned long long metrics_every = 100000;
+    const char *label_path = NULL, *label_follow = "best";
+    unsigned long long label_window = LABEL_DEFAULT_WINDOW, label_jobs = 0, label_warmup = 0;
+    const char *checkpoint_path = NULL, *restore_path = NULL, *whatif_list = NULL;
+    unsigned long long checkpoint_at = ULLONG_MAX, whatif_at = 0, whatif_requests = 0;
+    unsigned long long shard_count = 0, shard_chunk = 0;
+    const char *concurrent_list = NULL, *concurrent_policy_list = "all";
+    for (int arg_i = 5; arg_i < argc; arg_i++) {
+        const char *opt = argv[arg_i];
+        int matched = parse_ull_option(opt, "--fio-coalesce", &fio_coalesce_kb)
+                   || parse_ull_option(opt, "--fio-window", &fio_window)
+                   || parse_ull_option(opt, "--zns-max-open", &zns_max_open)
+                   || parse_ull_option(opt, "--zns-max-active", &zns_max_active)
+                   || parse_str_option(opt, "--zns-events", &zns_event_path)
+                   || parse_ull_option(opt, "--zns-lsl", &lsl_spare_zones)
+                   || parse_ull_option(opt, "--zns-zones", &lsl_logical_zones)
+                   || parse_ull_option(opt, "--zns-gc-threshold", &lsl_gc_threshold)
+                   || parse_ull_option(opt, "--flush-high", &flush_high_pct)
+                   || parse_ull_option(opt, "--flush-low", &flush_low_pct)
+                   || parse_ull_option(opt, "--flush-batch", &flush_batch)
+                   || parse_str_option(opt, "--flush-order", &flush_order_name)
+                   || parse_ull_option(opt, "--prefer-clean", &prefer_clean)
+                   || parse_ull_option(opt, "--zns-cost", &zns_cost_window)
+                   || parse_ull_option(opt, "--zns-cost-penalty", &zns_cost_penalty)
+                   || parse_ull_option(opt, "--readahead", &ra_max_window)
+                   || parse_ull_option(opt, "--ra-min", &ra_min_window)
+                   || parse_ull_option(opt, "--ra-streams", &ra_streams)
+                   || parse_ull_option(opt, "--ra-region", &ra_region)
+                   || parse_ull_option(opt, "--ra-max-pct", &ra_max_pct)
+                   || parse_ull_option(opt, "--tinylfu", &tinylfu_factor)
+                   || parse_str_option(opt, "--tenants", &tenant_map_path)
+                   || parse_ull_option(opt, "--ucp-interval", &ucp_interval)
+                   || parse_str_option(opt, "--dev-model", &dev_model_name)
+                   || parse_ull_option(opt, "--dev-read-us", &dev_read_us)
+                   || parse_ull_option(opt, "--dev-write-us", &dev_write_us)
+                   || parse_ull_option(opt, "--dev-reset-us", &dev_reset_us)
+                   || parse_ull_option(opt, "--dev-xfer-us", &dev_xfer_us)
+                   || parse_ull_option(opt, "--dev-channels", &dev_channels)
+                   || parse_ull_option(opt, "--dev-qd", &dev_qd)
+                   || parse_ull_option(opt, "--dev-hit-ns", &dev_hit_ns)
+                   || parse_str_option(opt, "--replay", &replay_mode)
+                   || parse_ull_option(opt, "--replay-speed", &replay_speed)
+                   || parse_str_option(opt, "--timeseries", &timeseries_path)
+                   || parse_str_option(opt, "--metrics", &metrics_path)
+                   || parse_ull_option(opt, "--metrics-every", &metrics_every)
+                   || parse_str_option(opt, "--metrics-format", &metrics_format)
+                   || parse_str_option(opt, "--label", &label_path)
+                   || parse_ull_option(opt, "--label-window", &label_window)
+                   || parse_ull_option(opt, "--label-jobs", &label_jobs)
+                   || parse_str_option(opt, "--label-follow", &label_follow)
+                   || parse_ull_option(opt, "--label-warmup", &label_warmup)
+                   || parse_str_option(opt, "--checkpoint", &checkpoint_path)
+                   || parse_ull_option(opt, "--checkpoint-at", &checkpoint_at)
+                   || parse_str_option(opt, "--restore", &restore_path)
+                   || parse_str_option(opt, "--whatif", &whatif_list)
+                   || parse_ull_option(opt, "--whatif-at", &whatif_at)
+                   || parse_ull_option(opt, "--whatif-requests", &whatif_requests)
+                   || parse_ull_option(opt, "--shards", &shard_count)
+                   || parse_ull_option(opt, "--shard-chunk", &shard_chunk)
+                   || parse_str_option(opt, "--concurrent", &concurrent_list)
+                   || parse_str_option(opt, "--concurrent-policies", &concurrent_policy_list);
+        if (!matched) {
+            fprintf(stderr, "오류: 알 수 없는 옵션 '%s'.\n", opt);
+            return 1;
+        }
+    }
+    if (fio_window > FIO_COALESCE_MAX_WINDOW) {
+        fprintf(stderr, "오류: --fio-window 는 %d 이하여야 합니다.\n", FIO_COALESCE_MAX_WINDOW);
+        return 1;
+    }
+    FlushOrder flush_order;
+    if (strcasecmp(flush_order_name, "lba") == 0) flush_order = FLUSH_ORDER_LBA;
+    else if (strcasecmp(flush_order_name, "zone") == 0) flush_order = FLUSH_ORDER_ZONE;
+    else { fprintf(stderr, "오류: 잘못된 flush 순서 '%s' (lba 또는 zone).\n", flush_order_name); return 1; }
+    if (flush_low_pct == ULLONG_MAX) flush_low_pct = flush_high_pct / 2;
+    if (flush_high_pct > 100 || (flush_high_pct > 0 && flush_low_pct >= flush_high_pct) || flush_batch == 0 || flush_batch > MAX_BUFFER_SIZE) {
+        fprintf(stderr, "오류: flush 설정이 잘못되었습니다 (0 <= low < high <= 100, batch > 0).\n");
+        return 1;
+    }
+    if (prefer_clean > FLUSH_MAX_CLEAN_WINDOW) {
+        fprintf(stderr, "오류: --prefer-clean 은 %d 이하여야 합니다.\n", FLUSH_MAX_CLEAN_WINDOW);
+        return 1;
+    }
+    clean_victim_window = (int)prefer_clean;
+    if (zns_cost_window > FLUSH_MAX_CLEAN_WINDOW || zns_cost_penalty == 0 || zns_cost_penalty > INT_MAX / 2) {
+        fprintf(stderr, "오류: --zns-cost 는 %d 이하, --zns-cost-penalty 는 1 이상이어야 합니다.\n", FLUSH_MAX_CLEAN_WINDOW);
+        return 1;
+    }
+    if (zns_cost_window > 0 && prefer_clean > 0) {
+        fprintf(stderr, "오류: --zns-cost 와 --prefer-clean 은 함께 쓸 수 없습니다 (--zns-cost 가 clean 후보도 고릅니다).\n");
+        return 1;
+    }
+    zns_cost.window = (int)zns_cost_window;
+    zns_cost.penalty = (int)zns_cost_penalty;
+    if (tinylfu_factor > TINYLFU_MAX_SAMPLE_FACTOR) {
+        fprintf(stderr, "오류: --tinylfu 는 %d 이하여야 합니다.\n", TINYLFU_MAX_SAMPLE_FACTOR);
+        return 1;
+    }
+    tinylfu.sample_factor = (int)tinylfu_factor; // initialize_buffer 에서 할당
+    if (tenant_map_path != NULL) {
+        if (ucp_interval == 0) { fprintf(stderr, "오류: --ucp-interval 은 1 이상이어야 합니다.\n"); return 1; }
+        ucp.interval = ucp_interval;
+        if (ucp_load_map(tenant_map_path) != 0) return 1; // UMON/할당량은 initialize_buffer 에서
+        if (ucp.num_tenants > buffer_size) {
+            fprintf(stderr, "오류: 버퍼 크기가 테넌트 수(%d)보다 작습니다.\n", ucp.num_tenants); return 1;
+        }
+    }
+    if (zns_max_open > INT_MAX || zns_max_active > INT_MAX || (zns_max_active > 0 && zns_max_open > zns_max_active)) {
+        fprintf(stderr, "오류: --zns-max-open 은 --zns-max-active 이하여야 합니다.\n");
+        return 1;
+    }
+
+    int label_follow_code = -1;
+    if (label_path != NULL) {
+        if (strcasecmp(label_follow, "best") != 0 && (label_follow_code = policy_code_from_name(label_follow)) < 0) {
+            fprintf(stderr, "오류: 잘못된 --label-follow '%s' (best 또는 정책 이름).\n", label_follow); return 1;
+        }
+        if (label_window == 0 || label_window > INT_MAX / 2) { fprintf(stderr, "오류: --label-window 는 1 이상이어야 합니다.\n"); return 1; }
+        if (label_jobs == 0) label_jobs = (unsigned long long)MAX(1L, sysconf(_SC_NPROCESSORS_ONLN));
+        if (zns_event_path != NULL || metrics_path != NULL || timeseries_path != NULL) {
+            fprintf(stderr, "오류: --label 은 --zns-events, --metrics, --timeseries 와 함께 쓸 수 없습니다.\n"); return 1;
+        }
+    }
+
+    int whatif_policies[NUM_POLICIES], whatif_count = 0;
+    if (whatif_list != NULL) {
+        if ((whatif_count = parse_policy_list(whatif_list, whatif_policies)) < 0) return 1;
+        if (whatif_count == 0) { fprintf(stderr, "오류: --whatif 에 정책이 없습니다.\n"); return 1; }
+        if (label_path != NULL || zns_event_path != NULL || metrics_path != NULL || timeseries_path != NULL) {
+            fprintf(stderr, "오류: --whatif 는 --label, --zns-events, --metrics, --timeseries 와 함께 쓸 수 없습니다.\n"); return 1;
+        }
+    }
+    if (label_path != NULL && (checkpoint_path != NULL || restore_path != NULL)) {
+        fprintf(stderr, "오류: --label 은 --checkpoint, --restore 와 함께 쓸 수 없습니다.\n"); return 1;
+    }
+    if (shard_count > 1) {
+        if (shard_count > SHARD_MAX || shard_count > (unsigned long long)buffer_size) {
+            fprintf(stderr, "오류: --shards 는 %d 이하이고 버퍼 크기 이하여야 합니다.\n", SHARD_MAX); return 1;
+        }
+        // Zone 하나가 한 샤드에만 속해야 샤드별 쓰기 포인터가 전체와 같음
+        if (zone_size_pages_global > 0) {
+            if (shard_chunk != 0 && shard_chunk != zone_size_pages_global) {
+                fprintf(stderr, "오류: ZNS 활성 시 --shard-chunk 는 존 크기(%llu)여야 합니다.\n", zone_size_pages_global); return 1;
+            }
+            shard_chunk = zone_size_pages_global;
+        }
+        if (label_path != NULL || whatif_list != NULL || checkpoint_path != NULL || restore_path != NULL ||
+            metrics_path != NULL || timeseries_path != NULL || zns_event_path != NULL || dev_model_name != NULL ||
+            ra_max_window > 0 || lsl_spare_zones > 0 || zns_max_open > 0 || zns_max_active > 0 || tenant_map_path != NULL) {
+            fprintf(stderr, "오류: --shards 는 라벨/what-if/체크포인트, 지표/시계열/Zone 이벤트 기록, 장치 모델, 선반입, "
+                            "로그 구조 계층, Zone open/active 제한, 테넌트 분할과 함께 쓸 수 없습니다 (샤드 사이에 공유되는 상태).\n");
+            return 1;
+        }
+        shard.count = (int)shard_count;
+        shard.chunk_pages = MAX(1ULL, shard_chunk);
+    }
+
+    int concurrent_threads[CONC_MAX_THREADS], concurrent_thread_count = 0;
+    int concurrent_policies[NUM_POLICIES], concurrent_policy_count = 0;
+    if (concurrent_list != NULL) {
+        char counts[256];
+        snprintf(counts, sizeof(counts), "%s", concurrent_list);
+        for (char *tok = strtok(counts, ","); tok != NULL && concurrent_thread_count < CONC_MAX_THREADS; tok = strtok(NULL, ",")) {
+            long n = strtol(tok, &endptr, 10);
+            if (endptr == tok || *endptr != '\0' || n <= 0 || n > CONC_MAX_THREADS) {
+                fprintf(stderr, "오류: 잘못된 --concurrent 스레드 수 '%s' (1..%d).\n", tok, CONC_MAX_THREADS); return 1;
+            }
+            concurrent_threads[concurrent_thread_count++] = (int)n;
+        }
+        if ((concurrent_policy_count = parse_policy_list(concurrent_policy_list, concurrent_policies)) < 0) return 1;
+        if (concurrent_thread_count == 0) { fprintf(stderr, "오류: --concurrent 에 스레드 수가 없습니다.\n"); return 1; }
+        if (label_path != NULL || whatif_list != NULL || shard.count > 1 || checkpoint_path != NULL || restore_path != NULL ||
+            metrics_path != NULL || timeseries_path != NULL || zns_event_path != NULL || dev_model_name != NULL ||
+            ra_max_window > 0 || flush_high_pct > 0 || lsl_spare_zones > 0 || tenant_map_path != NULL) {
+            fprintf(stderr, "오류: --concurrent 는 라벨/what-if/샤드/체크포인트, 지표/시계열/Zone 이벤트 기록, 장치 모델, 선반입, "
+                            "flusher, 로그 구조 계층, 테넌트 분할과 함께 쓸 수 없습니다.\n");
+            return 1;
+        }
+    }
+
     // 워크로드 파일 열기
-    FILE *infile = fopen(filename, "r");
+    FILE *infile = fopen(filename, "rb");
     if (infile == NULL) { fprintf(stderr, "오류: 워크로드 파일 '%s' 열기 실패: %s\n", filename, strerror(errno)); return 1;}
 
     // 로그 파일 이름 설정
@@ -939,10 +6706,18 @@ int main(int argc, char *argv[]) {
         snprintf(log_filename, sizeof(log_filename), "%s_%s_%d.fio.log",
                  filename, policy_names[current_policy], buffer_size);
     }
-    log_file = fopen(log_filename, "w");
-    if (log_file == NULL) { fprintf(stderr, "오류: 로그 파일 '%s' 열기 실패: %s\n", log_filename, strerror(errno)); fclose(infile); return 1;}
-    printf("FIO 트레이스를 다음 파일에 로깅합니다: %s\n", log_filename);
-    fprintf(log_file, "fio version 2 iolog\n%s add\n%s open\n", DEVICE_NAME, DEVICE_NAME);
+    if (label_path == NULL && concurrent_list == NULL) { // 라벨 생성/동시 접근 모드는 히트 수만 필요하므로 FIO 로그를 쓰지 않음
+        log_file = fopen(log_filename, "w");
+        if (log_file == NULL) { fprintf(stderr, "오류: 로그 파일 '%s' 열기 실패: %s\n", log_filename, strerror(errno)); fclose(infile); return 1;}
+        printf("FIO 트레이스를 다음 파일에 로깅합니다: %s\n", log_filename);
+        fprintf(log_file, "fio version 2 iolog\n%s add\n%s open\n", DEVICE_NAME, DEVICE_NAME);
+        if (fio_log_init(log_file, (int)fio_window, fio_coalesce_kb * 1024ULL) != 0) {
+            fprintf(stderr, "오류: FIO 로그 버퍼 할당 실패\n"); fclose(log_file); fclose(infile); return 1;
+        }
+        if (fio_log.window > 0) {
+            printf("FIO 로그 병합 활성: 최대 %llu 바이트, 윈도우 %d\n", fio_log.max_io_bytes, fio_log.window);
+        }
+    }
 
     // 시뮬레이션 정보 출력
     printf("--- 시뮬레이션 시작 (초기 정책: %s) ---\n", policy_names[current_policy]);
@@ -957,143 +6732,227 @@ int main(int argc, char *argv[]) {
            SECTORS_PER_PAGE, SECTOR_SIZE, (SECTORS_PER_PAGE * SECTOR_SIZE) / 1024);
 
     // 초기화
+#ifdef T30_PROFILE
+    prof_init();
+#endif
     initialize_buffer(); // previous_policy_for_state_carryover는 main에서 current_policy 설정 후 다시 설정됨.
     initialize_arc_state(1); // current_policy에 따라 ARC 상태 초기화
-    initialize_zone_write_pointers(); // Zone 쓰기 포인터 초기화
+    // Zone 상태 테이블 초기화 (희소 테이블, 접근 시점에 Zone 생성)
+    FILE *zns_event_file = NULL;
+    if (zone_size_pages_global > 0) {
+        if (zns_event_path != NULL) {
+            zns_event_file = fopen(zns_event_path, "w");
+            if (zns_event_file == NULL) { fprintf(stderr, "오류: Zone 이벤트 파일 '%s' 열기 실패: %s\n", zns_event_path, strerror(errno)); return 1; }
+        }
+        if (zns_init((int)zns_max_open, (int)zns_max_active, zns_event_file) != 0) {
+            fprintf(stderr, "오류: Zone 테이블 할당 실패\n"); return 1;
+        }
+        if (lsl_spare_zones > 0) {
+            if (zone_size_pages_global > UINT_MAX || lsl_init(lsl_logical_zones, lsl_spare_zones, lsl_gc_threshold) != 0) {
+                fprintf(stderr, "오류: 로그 구조 계층 초기화 실패 (예비 Zone 수는 GC 임계값보다 커야 합니다).\n"); return 1;
+            }
+            printf("로그 구조 write-back 계층 활성: 논리 Zone %llu개, 예비 Zone %llu개, GC 임계값 %llu\n",
+                   lsl_logical_zones, lsl_spare_zones, lsl_gc_threshold);
+        }
+    } else if (lsl_spare_zones > 0) {
+        fprintf(stderr, "오류: --zns-lsl 은 존 크기가 0보다 커야 합니다.\n"); return 1;
+    }
+    if (flush_high_pct > 0) {
+        if (flusher_init((int)flush_high_pct, (int)flush_low_pct, (int)flush_batch, flush_order) != 0) {
+            fprintf(stderr, "오류: flusher 초기화 실패\n"); return 1;
+        }
+        printf("백그라운드 flusher 활성: high %d / low %d 프레임, batch %d, 순서 %s\n",
+               flusher.high_mark, flusher.low_mark, flusher.batch_size, (flusher.order == FLUSH_ORDER_ZONE) ? "zone" : "lba");
+    }
+    if (tinylfu.enabled) {
+        printf("TinyLFU 승인 필터 활성: sketch %d x %llu 카운터, doorkeeper %llu 비트, 노화 주기 %llu 접근\n",
+               TINYLFU_ROWS, tinylfu.width_mask + 1, tinylfu.door_mask + 1, tinylfu.sample_size);
+    }
+    if (ucp.enabled) {
+        printf("테넌트 분할 활성: 테넌트 %d개 (구간 %d개), 할당 단위 %d조각, UMON 샘플 1/%d (스택 %d), 재할당 주기 %llu 접근\n",
+               ucp.num_tenants, ucp.num_ranges, ucp.bucket_count, 1 << UCP_SAMPLE_SHIFT, ucp.stack_cap, ucp.interval);
+    }
+    if (ra_max_window > 0) {
+        if (ra_max_window > MAX_BUFFER_SIZE || ra_min_window > ra_max_window || ra_region > INT_MAX ||
+            readahead_init((int)ra_min_window, (int)ra_max_window, (int)MIN(ra_streams, (unsigned long long)INT_MAX),
+                           (int)ra_region, (int)MIN(ra_max_pct, 101ULL)) != 0) {
+            fprintf(stderr, "오류: readahead 설정이 잘못되었습니다 (0 < min <= max, 0 < streams <= %d, 0 < pct <= 100).\n", RA_MAX_STREAMS);
+            return 1;
+        }
+        printf("선반입 활성: 윈도우 %d..%d 페이지, 스트림 %d개, 영역 %d 페이지, 미참조 상한 %d 프레임\n",
+               readahead.min_window, readahead.max_window, readahead.num_streams, readahead.region_pages, readahead.max_unused);
+    }
+    if (dev_model_name != NULL) {
+        const DevicePreset *preset = NULL;
+        for (size_t i = 0; i < sizeof(device_presets) / sizeof(device_presets[0]); i++) {
+            if (strcasecmp(dev_model_name, device_presets[i].name) == 0) preset = &device_presets[i];
+        }
+        if (preset == NULL) { fprintf(stderr, "오류: 알 수 없는 장치 모델 '%s' (nvme, zns, sata, hdd).\n", dev_model_name); return 1; }
+        DevicePreset cfg = *preset;
+        if (dev_read_us != ULLONG_MAX) cfg.read_ns = dev_read_us * 1000ULL;
+        if (dev_write_us != ULLONG_MAX) cfg.write_ns = dev_write_us * 1000ULL;
+        if (dev_reset_us != ULLONG_MAX) cfg.reset_ns = dev_reset_us * 1000ULL;
+        if (dev_xfer_us != ULLONG_MAX) cfg.xfer_ns = dev_xfer_us * 1000ULL;
+        if (dev_channels > 0) cfg.channels = (int)MIN(dev_channels, (unsigned long long)INT_MAX);
+        if (dev_qd > 0) cfg.queue_depth = (int)MIN(dev_qd, (unsigned long long)INT_MAX);
+        if (device_init(&cfg, dev_hit_ns) != 0) {
+            fprintf(stderr, "오류: 장치 모델 설정이 잘못되었습니다 (채널 1..%d, 큐 깊이 1..%d).\n", DEV_MAX_CHANNELS, DEV_MAX_QUEUE_DEPTH);
+            return 1;
+        }
+        printf("장치 모델 %s: 읽기 %.1f / 쓰기 %.1f / reset %.1f us, 추가 페이지 %.1f us, 채널 %d, 큐 깊이 %d, 히트 %llu ns\n",
+               cfg.name, cfg.read_ns / 1000.0, cfg.write_ns / 1000.0, cfg.reset_ns / 1000.0, cfg.xfer_ns / 1000.0,
+               cfg.channels, cfg.queue_depth, dev_hit_ns);
+    }
+    if (strcasecmp(replay_mode, "open") == 0) {
+        if (!device.enabled || replay_speed == 0 || replay_speed > 1000000) {
+            fprintf(stderr, "오류: --replay=open 은 --dev-model 과 0보다 큰 --replay-speed 가 필요합니다.\n"); return 1;
+        }
+        device.open_loop = 1;
+        device.speed_pct = (int)replay_speed;
+        printf("open-loop 재생: 트레이스 타임스탬프 기준 도착, 배속 %llu%%\n", replay_speed);
+    } else if (strcasecmp(replay_mode, "closed") != 0) {
+        fprintf(stderr, "오류: 잘못된 재생 모드 '%s' (closed 또는 open).\n", replay_mode); return 1;
+    }
+    if (timeseries_path != NULL) {
+        if (!device.enabled) { fprintf(stderr, "오류: --timeseries 는 --dev-model 이 필요합니다.\n"); return 1; }
+        timeseries.enabled = 1;
+    }
+    if (metrics_path != NULL) {
+        int json;
+        if (metrics_format != NULL) {
+            if (strcasecmp(metrics_format, "json") == 0) json = 1;
+            else if (strcasecmp(metrics_format, "csv") == 0) json = 0;
+            else { fprintf(stderr, "오류: 잘못된 지표 형식 '%s' (csv 또는 json).\n", metrics_format); return 1; }
+        } else {
+            const char *ext = strrchr(metrics_path, '.');
+            json = (ext != NULL && (strcasecmp(ext, ".json") == 0 || strcasecmp(ext, ".jsonl") == 0));
+        }
+        if (metrics_open(metrics_path, json, metrics_every) != 0) {
+            fprintf(stderr, "오류: 지표 파일 '%s' 열기 실패: %s\n", metrics_path, strerror(errno)); return 1;
+        }
+        printf("구간별 지표 기록: %s (%s, %llu 요청마다)\n", metrics_path, json ? "json" : "csv", metrics_every);
+    }
 
     // 워크로드 처리 루프
-    char line_buffer[256];
+    TraceReader trace;
+    TraceRecord rec;
     int line_num = 0;
     unsigned long long total_lba_requests_processed = 0;
+    unsigned long long total_range_pages = 0; // 요청들이 걸친 페이지 수 (길이 필드 포함)
+    if (trace_open(&trace, infile) != 0) { fclose(infile); return 1; }
+    if (restore_path != NULL) {
+        if (checkpoint_restore(restore_path, &trace, &total_lba_requests_processed, &total_range_pages) != 0) { fclose(infile); return 1; }
+        line_num = trace.line_num;
+        printf("체크포인트 '%s' 복원: 라인 %d, 요청 %llu개 처리 상태, 현재 정책 %s, 히트 %lld / 미스 %lld\n",
+               restore_path, line_num, total_lba_requests_processed, policy_names[current_policy], hits, misses);
+    }
 
-    printf("요청 처리 중 (형식: LBA Op 또는 P policy_code)...\n");
-    while (fgets(line_buffer, sizeof(line_buffer), infile) != NULL) {
-        line_num++;
-        char *trimmed_line = line_buffer;
-        while (isspace((unsigned char)*trimmed_line)) trimmed_line++;
-        char *end_of_line = trimmed_line + strlen(trimmed_line) - 1;
-        while (end_of_line > trimmed_line && isspace((unsigned char)*end_of_line)) end_of_line--;
-        *(end_of_line + 1) = '\0';
-
-        if (trimmed_line[0] == '\0' || trimmed_line[0] == '#') continue;
+    if (label_path != NULL) {
+        printf("오라클 라벨 생성: 창 %llu 요청, 병렬 작업 %llu개, 궤적 %s, 예열 %llu 요청\n",
+               label_window, label_jobs, (label_follow_code < 0) ? "best" : policy_names[label_follow_code], label_warmup);
+        int label_rc = label_run(&trace, label_path, label_window, (int)MIN(label_jobs, 4096ULL), label_follow_code, label_warmup);
+        fclose(infile);
+        return label_rc;
+    }
+    if (concurrent_list != NULL) {
+        int concurrent_rc = concurrent_run(&trace, concurrent_threads, concurrent_thread_count, concurrent_policies, concurrent_policy_count);
+        fclose(infile);
+        return concurrent_rc;
+    }
+    printf("요청 처리 중 (형식: [@시각_us] LBA Op [길이_섹터] 또는 P policy_code%s)...\n", trace.binary ? ", 바이너리" : "");
+    if (shard.count > 1) {
+        printf("해시 샤드 시뮬레이션: 샤드 %d개, 샤드당 %d~%d 프레임, 청크 %llu 페이지\n", shard.count,
+               buffer_size / shard.count, (buffer_size + shard.count - 1) / shard.count, shard.chunk_pages);
+        if (shard_run(&trace, log_filename, &total_lba_requests_processed, &total_range_pages) != 0) { fclose(infile); return 1; }
+        line_num = trace.line_num; // 트레이스를 모두 읽었으므로 아래 루프는 바로 끝남
+    }
+    int checkpoint_done = 0, whatif_child = -1;
+    unsigned long long whatif_start = 0;
+    // 요청마다 끼어드는 지점(구간 지표, 중간 체크포인트, what-if 분기)이 없으면 접근 요청을 모아 access_batch 로 처리
+    int batching = !metrics.enabled && whatif_count == 0 && (checkpoint_path == NULL || checkpoint_at == ULLONG_MAX);
+    TraceRecord batch_recs[ACCESS_BATCH];
+    int batch_lines[ACCESS_BATCH];
+    unsigned long long batch_pages[ACCESS_BATCH];
+    int pending_record = 0; // 배치를 모으다 읽은 P 레코드가 rec 에 남아 있음
+    while (1) {
+        if (checkpoint_path != NULL && !checkpoint_done && (unsigned long long)line_num >= checkpoint_at) {
+            if (checkpoint_save(checkpoint_path, &trace, total_lba_requests_processed, total_range_pages) == 0)
+                printf("체크포인트 저장: %s (라인 %d, 요청 %llu개)\n", checkpoint_path, line_num, total_lba_requests_processed);
+            checkpoint_done = 1;
+        }
+        if (whatif_count > 0 && whatif_child < 0 && (unsigned long long)line_num >= whatif_at) {
+            printf("what-if 분기: 라인 %d 에서 정책 %d개\n", line_num, whatif_count);
+            whatif_child = whatif_fork(&trace, filename, whatif_policies, whatif_count, total_lba_requests_processed);
+            if (whatif_child < 0) { // 부모: 결과 출력 후 종료 (자식들이 나머지를 재생)
+                if (log_file != NULL) { fio_log_close(); fprintf(log_file, "%s close\n", DEVICE_NAME); fclose(log_file); log_file = NULL; }
+                fclose(infile);
+                return 0;
+            }
+            whatif_start = total_lba_requests_processed;
+            checkpoint_path = NULL; // 자식끼리 같은 체크포인트 파일을 덮어쓰지 않도록
+        }
+        if (whatif_child >= 0 && whatif_requests > 0 && total_lba_requests_processed - whatif_start >= whatif_requests) break;
+        if (!pending_record && !trace_next(&trace, &rec)) break;
+        if (!pending_record) line_num = trace.line_num;
+        pending_record = 0;
 
         // 정책 변경 명령어 처리
-        if (toupper(trimmed_line[0]) == 'P' && (trimmed_line[1] == ' ' || trimmed_line[1] == '\t')) {
-            int new_policy_code; char cmd_char;
-            if (sscanf(trimmed_line, "%c %d", &cmd_char, &new_policy_code) == 2 && toupper(cmd_char) == 'P') {
-                // 수정된 정책 코드 유효 범위 확인: 0부터 8까지
-                if (new_policy_code >= CLOCK_PRO_T1_B4_LOGS_B2 && new_policy_code <= LRU_ARC) {
-                    ReplacementPolicy old_policy = current_policy;
-                    ReplacementPolicy new_policy = (ReplacementPolicy)new_policy_code;
-                    if (old_policy != new_policy) {
-                        printf("\nINFO: (라인 %d) 정책 변경 감지: %s ===> %s\n",
-                               line_num, policy_names[old_policy], policy_names[new_policy]);
-                        previous_policy_for_state_carryover = old_policy;
-                        current_policy = new_policy; // current_policy 업데이트
-
-                        int reset_arc_completely = 1;
-                        // 상태 이전 로직 (enum 심볼 사용으로 자동 대응)
-                        if ((old_policy == LRU && new_policy == LRU_ARC) || (old_policy == LRU_ARC && new_policy == LRU)) {
-                            reset_arc_completely = 0;
-                            printf("INFO: LRU <-> LRU_ARC 전환. p, B1, B2 상태를 이어받습니다.\n");
-                        }
-                        else if ((old_policy == LFU && new_policy == LFU_ARC) || (old_policy == LFU_ARC && new_policy == LFU)) {
-                            reset_arc_completely = 0;
-                            printf("INFO: LFU <-> LFU_ARC 전환. q, B3, B4 상태를 이어받습니다.\n");
-                        }
-
-                        initialize_arc_state(reset_arc_completely); // 변경된 current_policy에 따라 ARC 상태 다시 초기화/조정
-
-                        // 버퍼 프레임 상태 재설정 (list_type, ref_arc_list_type, t1/t2/t3/t4_size 조정)
-                        // 이 부분은 current_policy (new_policy)를 기준으로 동작하므로 enum 심볼에 의해 자동 대응.
-                        // 다만, 각 정책에 할당되는 list_type 값의 의도를 다시 한번 확인하는 것이 좋음.
-                        arc_state.t1_size = 0; arc_state.t2_size = 0;
-                        arc_state.t3_size = 0; arc_state.t4_size = 0;
-
-                        for (int i = 0; i < buffer_size; i++) {
-                            if (buffer[i].page_id != INVALID_PAGE) {
-                                buffer[i].ref_bit = 0; // 기본적으로 ref_bit 초기화
-                                buffer[i].ref_arc_list_type = 0; // 기본적으로 초기화
-
-                                if (new_policy == LRU) { // LRU는 7
-                                    buffer[i].list_type = 1; // LRU의 주 캐시 리스트 타입
-                                    if (old_policy == LRU_ARC && (buffer[i].list_type == 1 || buffer[i].list_type == 2)) { // 이전 list_type을 ref_arc_list_type으로 사용
-                                         buffer[i].ref_arc_list_type = buffer[i].list_type; // 이전 list_type 값이 1 또는 2였을 것임.
-                                    } else {
-                                        buffer[i].ref_arc_list_type = 1; // 기본 T1_ref
-                                    }
-                                    if(buffer[i].ref_arc_list_type == 1) arc_state.t1_size++; else arc_state.t2_size++;
-                                } else if (new_policy == LFU) { // LFU는 5
-                                    buffer[i].list_type = 3; // LFU의 주 캐시 리스트 타입
-                                    if (old_policy == LFU_ARC && (buffer[i].list_type == 3 || buffer[i].list_type == 4)) {
-                                         buffer[i].ref_arc_list_type = buffer[i].list_type;
-                                    } else {
-                                        buffer[i].ref_arc_list_type = 3; // 기본 T3_ref
-                                    }
-                                    if(buffer[i].ref_arc_list_type == 3) arc_state.t3_size++; else arc_state.t4_size++;
-                                } else if (new_policy == LRU_ARC) { // LRU_ARC는 8
-                                    if (old_policy == LRU && (buffer[i].ref_arc_list_type == 1 || buffer[i].ref_arc_list_type == 2)) {
-                                        buffer[i].list_type = buffer[i].ref_arc_list_type; // LRU의 ref_arc_list_type을 list_type으로
-                                    } else {
-                                        buffer[i].list_type = 1; // 기본 T1
-                                    }
-                                    if(buffer[i].list_type == 1) arc_state.t1_size++; else arc_state.t2_size++;
-                                } else if (new_policy == LFU_ARC) { // LFU_ARC는 6
-                                     if (old_policy == LFU && (buffer[i].ref_arc_list_type == 3 || buffer[i].ref_arc_list_type == 4)) {
-                                        buffer[i].list_type = buffer[i].ref_arc_list_type;
-                                    } else {
-                                        buffer[i].list_type = 3; // 기본 T3
-                                    }
-                                    if(buffer[i].list_type == 3) arc_state.t3_size++; else arc_state.t4_size++;
-                                } else if (new_policy == CLOCK_T1 || new_policy == CLOCK_PRO_T1_B4_LOGS_B2) { // CLOCK_T1=2, CLOCK_PRO_T1=0
-                                    buffer[i].list_type = 1; // T1 캐시
-                                    arc_state.t1_size++;
-                                    buffer[i].ref_bit = 1; // CLOCK 계열은 ref_bit 1로 시작
-                                } else if (new_policy == CLOCK_T3 || new_policy == CLOCK_PRO_T3_B2_LOGS_B4) { // CLOCK_T3=3, CLOCK_PRO_T3=1
-                                    buffer[i].list_type = 3; // T3 캐시
-                                    arc_state.t3_size++;
-                                    buffer[i].ref_bit = 1; // CLOCK 계열은 ref_bit 1로 시작
-                                } else if (new_policy == FIFO) { // FIFO는 4
-                                    buffer[i].list_type = 0; // FIFO는 별도 list_type 구분 없음 (또는 FIFO 고유값 사용)
-                                    // FIFO는 ref_bit 사용 안하므로 위에서 0으로 초기화된 값 유지.
-                                }
-                            }
-                        }
-                        arc_state.p_clk_hand = 0; arc_state.q_clk_hand = 0; global_clk_hand = 0;
-
-                        printf("--- 정책 변경 완료: %s ---\n", policy_names[current_policy]);
-                        // print_buffer_state();
-                    }
-                } else { fprintf(stderr, "경고: (라인 %d) 잘못된 정책 코드 %d. 유효 범위: %d-%d. 무시.\n", line_num, new_policy_code, CLOCK_PRO_T1_B4_LOGS_B2, LRU_ARC); }
-            } else { fprintf(stderr, "경고: (라인 %d) 잘못된 정책 변경 명령어 형식. 무시. 내용: [%s]\n", line_num, trimmed_line); }
+        if (rec.kind == TRACE_POLICY) {
+            if (whatif_child >= 0) continue; // what-if 자식은 분기 시 맡은 정책을 끝까지 유지
+            apply_policy_record(rec.policy_code, line_num, total_lba_requests_processed);
         }
-        // LBA 접근 요청 처리
-        else {
-            unsigned long long lba_address_val; char op_char_val_arr[3]; int operation_type_val;
-            if (sscanf(trimmed_line, "%llu %2s", &lba_address_val, op_char_val_arr) == 2) {
-                char op_char_val = tolower(op_char_val_arr[0]);
-                if (op_char_val == 'r') operation_type_val = OP_READ;
-                else if (op_char_val == 'w') operation_type_val = OP_WRITE;
-                else { fprintf(stderr, "경고: (라인 %d) 잘못된 작업 유형 '%c'. 건너<0xEB><0x9C><0x84>니다.\n", line_num, op_char_val_arr[0]); continue; }
-
-                unsigned long long page_id_val = lba_to_page_id(lba_address_val);
-                access_page(lba_address_val, page_id_val, operation_type_val); // ZNS 검사는 access_page -> handle_dirty_eviction -> write_fio_log 에서 처리됨
+        // LBA 접근 요청 처리 (배치)
+        else if (batching) {
+            int count = 0;
+            batch_recs[count] = rec;
+            batch_lines[count++] = line_num;
+            while (count < ACCESS_BATCH && trace_next(&trace, &rec)) {
+                if (rec.kind == TRACE_POLICY) { pending_record = 1; break; }
+                batch_recs[count] = rec;
+                batch_lines[count++] = trace.line_num;
+            }
+            access_batch(batch_recs, batch_lines, count, batch_pages);
+            for (int i = 0; i < count; i++) {
+                if (batch_pages[i] == 0) continue;
+                total_range_pages += batch_pages[i];
                 total_lba_requests_processed++;
-
-                if (total_lba_requests_processed > 0 && total_lba_requests_processed % 1000000 == 0) {
+                if (total_lba_requests_processed % 1000000 == 0) {
                      printf("  %llu개 LBA 요청 처리 완료 (현재 정책: %s)...\n", total_lba_requests_processed, policy_names[current_policy]);
                 }
-            } else { fprintf(stderr, "경고: (라인 %d) 잘못된 LBA 접근 요청 형식. 무시. 내용: [%s]\n", line_num, trimmed_line); }
+            }
+            line_num = pending_record ? trace.line_num : batch_lines[count - 1];
+        }
+        // LBA 접근 요청 처리
+        else {
+            unsigned long long request_pages = simulate_request(&rec, line_num);
+            if (request_pages == 0) continue;
+            total_range_pages += request_pages;
+            total_lba_requests_processed++;
+            if (metrics.enabled) metrics_emit_interval(total_lba_requests_processed, line_num);
+
+            if (total_lba_requests_processed > 0 && total_lba_requests_processed % 1000000 == 0) {
+                 printf("  %llu개 LBA 요청 처리 완료 (현재 정책: %s)...\n", total_lba_requests_processed, policy_names[current_policy]);
+            }
         }
     } // End while loop
 
+    if (checkpoint_path != NULL && !checkpoint_done) { // --checkpoint-at 이 트레이스 길이를 넘으면 끝 상태를 저장
+        if (checkpoint_save(checkpoint_path, &trace, total_lba_requests_processed, total_range_pages) == 0)
+            printf("체크포인트 저장: %s (라인 %d, 요청 %llu개)\n", checkpoint_path, line_num, total_lba_requests_processed);
+    }
+
     // 파일 읽기 오류 확인
     if (ferror(infile)) { fprintf(stderr, "\n워크로드 파일 '%s' 읽기 오류 발생: %s\n", filename, strerror(errno)); }
     printf("총 %llu개의 LBA 요청 처리 완료.\n", total_lba_requests_processed);
+    device_epoch_report(line_num);
+    metrics_emit_epoch(total_lba_requests_processed, line_num);
+    if (total_range_pages != total_lba_requests_processed) {
+        printf("다중 페이지 요청 포함: 총 %llu 페이지 접근.\n", total_range_pages);
+    }
 
     // 시뮬레이션 종료 전 더티 페이지 플러시
     printf("시뮬레이션 종료 시 남은 더티 페이지 플러시 중...\n");
-    int dirty_flushed = 0;
+    int dirty_flushed = shard.dirty_flushed;
     for (int i = 0; i < buffer_size; ++i) {
         if (buffer[i].page_id != INVALID_PAGE && buffer[i].is_dirty) {
              handle_dirty_eviction(i); // 내부적으로 ZNS 제약 검사 수행
@@ -1102,10 +6961,12 @@ int main(int argc, char *argv[]) {
     }
     if (dirty_flushed > 0) printf("%d개의 더티 페이지를 플러시했습니다.\n", dirty_flushed);
     else printf("플러시할 더티 페이지가 버퍼에 남아있지 않습니다.\n");
+    if (whatif_child >= 0) whatif_child_finish(total_lba_requests_processed);
 
     // 파일 닫기
-    if (log_file != NULL) { fprintf(log_file, "%s close\n", DEVICE_NAME); fclose(log_file); log_file = NULL; }
+    if (log_file != NULL) { fio_log_close(); fprintf(log_file, "%s close\n", DEVICE_NAME); fclose(log_file); log_file = NULL; }
     if (infile != NULL) fclose(infile);
+    if (zone_table.event_file != NULL) { fclose(zone_table.event_file); zone_table.event_file = NULL; }
 
     // 최종 상태 출력
     printf("--- 최종 상태 --- \n");
@@ -1118,19 +6979,7 @@ int main(int argc, char *argv[]) {
 
     // 요약 출력 시 사용할 초기 정책 이름 결정
     const char* summary_initial_policy_name_to_print = initial_policy_arg_orig;
-    int initial_policy_was_valid = 0;
-    // policy_names 배열과 그 크기가 변경되었으므로, num_policies도 이를 반영해야 함.
-    int num_policies = sizeof(policy_names) / sizeof(policy_names[0]); // 현재 9개 정책
-     for (int i = 0; i < num_policies; ++i) {
-        char temp_policy_name_lower[256];
-        strncpy(temp_policy_name_lower, policy_names[i], sizeof(temp_policy_name_lower) -1);
-        temp_policy_name_lower[sizeof(temp_policy_name_lower)-1] = '\0';
-        for(char *p_temp = temp_policy_name_lower; *p_temp; ++p_temp) *p_temp = tolower(*p_temp);
-        if (strcmp(initial_policy_arg_lower, temp_policy_name_lower) == 0) {
-            initial_policy_was_valid = 1;
-            break;
-        }
-    }
+    int initial_policy_was_valid = (initial_policy_code >= 0);
     if (!initial_policy_was_valid) {
         summary_initial_policy_name_to_print = policy_names[FIFO]; // FIFO는 이제 policy_names[4]
     }
@@ -1148,11 +6997,126 @@ int main(int argc, char *argv[]) {
     printf(" 총 LBA 요청 수:  %-12llu | 캐시 히트 수:   %-12lld\n", total_lba_requests_processed, hits);
     printf(" 캐시 미스 수:   %-12lld | 총 접근 수:     %-12lld (히트+미스)\n", misses, total_accesses);
     printf(" 히트율:        %6.2f%%\n", hit_rate);
+    if (fio_log.window > 0) {
+        printf(" FIO I/O 요청:   %-12llu | 병합 후 기록:   %-12llu\n", fio_log.ios_submitted, fio_log.ios_written);
+    }
+    if (zone_size_pages_global > 0) {
+        printf(" 사용된 Zone 수: %-12llu | ZNS 위반 수:    %-12llu\n", zone_table.used, zone_table.violations);
+        printf(" Zone open:     암시적 %llu / 명시적 %llu | close: 암시적 %llu / 명시적 %llu\n",
+               zone_table.implicit_opens, zone_table.explicit_opens, zone_table.implicit_closes, zone_table.explicit_closes);
+        printf(" Zone finish:   %-12llu | Zone reset:     %-12llu\n", zone_table.finishes, zone_table.resets);
+        printf(" 최대 open Zone: %-5d (한도 %d) | 최대 active Zone: %-5d (한도 %d)\n",
+               zone_table.peak_open, zone_table.max_open, zone_table.peak_active, zone_table.max_active);
+    }
+    printf(" 교체 시 동기 write-back: %-10llu | 종료 시 flush:  %-12d\n", dirty_eviction_stalls, dirty_flushed);
+    if (flusher.enabled) {
+        printf(" flusher 실행:   %-12llu | flush batch:    %-12llu | flush 페이지: %llu\n", flusher.runs, flusher.batches, flusher.pages);
+    }
+    if (clean_victim_window > 0) {
+        printf(" 청결 희생자 선호로 바뀐 희생자: %llu (윈도우 %d)\n", clean_victim_picks, clean_victim_window);
+    }
+    if (zns_cost.window > 0) {
+        printf(" ZNS 비용 인지로 바뀐 희생자: %llu (clean %llu / 순차 더티 %llu, 윈도우 %d, 비순차 비용 %d)\n",
+               zns_cost.picks, zns_cost.picked_clean, zns_cost.picked_seq, zns_cost.window, zns_cost.penalty);
+    }
+    if (zone_size_pages_global > 0 && !lsl.enabled) {
+        printf(" 교체 write-back: 순차 %-10llu | 비순차 %llu\n", evict_seq_writebacks, evict_nonseq_writebacks);
+    }
+    if (current_policy == CLOCK_PRO || clockpro.promotions + clockpro.demotions > 0) {
+        printf(" CLOCK-Pro:      승격 %-10llu | 강등 %-10llu | 시험 기간 재적재 %llu / 만료 %llu\n",
+               clockpro.promotions, clockpro.demotions, clockpro.test_refaults, clockpro.test_expired);
+        printf(" CLOCK-Pro 상태: cold 목표 %d | hot %d / cold %d / 비상주 %d\n",
+               clockpro.cold_target, clockpro.hot_count, clockpro.cold_count, clockpro.nonres_count);
+    }
+    if (current_policy == S3_FIFO || fifoq.small_to_main + fifoq.ghost_hits > 0) {
+        printf(" S3-FIFO:        S->M %-10llu | M 재삽입 %-10llu | G 적중 %llu (S %d / M %d)\n",
+               fifoq.small_to_main, fifoq.main_reinserts, fifoq.ghost_hits, fifoq.size[FIFOQ_SMALL], fifoq.size[FIFOQ_MAIN]);
+    }
+    if (current_policy == SIEVE || fifoq.sieve_passes > 0) {
+        printf(" SIEVE:          방문 비트로 건너뛴 프레임 %llu\n", fifoq.sieve_passes);
+    }
+    if (current_policy == LIRS || lirs.promotions + lirs.demotions > 0) {
+        printf(" LIRS:           승격 %-10llu | 강등 %-10llu | 비상주 재적재 %llu / 만료 %llu | 걷어낸 노드 %llu\n",
+               lirs.promotions, lirs.demotions, lirs.nonres_refaults, lirs.nonres_expired, lirs.pruned);
+        printf(" LIRS 상태:      LIR 목표 %d | LIR %d / HIR %d / 비상주 %d\n",
+               lirs.lir_target, lirs.lir_count, lirs.hir_count, lirs.nonres_count);
+    }
+    if (ucp.enabled) {
+        printf(" 테넌트 분할:    재할당 %llu회 (주기 %llu 접근)\n", ucp.reallocations, ucp.interval);
+        printf(" %6s %8s %8s %12s %12s %8s %12s %12s\n", "테넌트", "할당량", "점유", "히트", "미스", "히트율", "교체됨", "빼앗김");
+        for (int t = 0; t < ucp.num_tenants; t++) {
+            unsigned long long acc = ucp.hits[t] + ucp.misses[t];
+            printf(" %6d %8d %8d %12llu %12llu %7.2f%% %12llu %12llu\n", t, ucp.quota[t], ucp.occupancy[t], ucp.hits[t], ucp.misses[t],
+                   acc ? 100.0 * ucp.hits[t] / acc : 0.0, ucp.evicted[t], ucp.stolen[t]);
+        }
+    }
+    if (tinylfu.enabled) {
+        printf(" TinyLFU 승인:   %-12llu | 거절:           %-12llu | 노화:         %llu\n", tinylfu.admits, tinylfu.rejects, tinylfu.agings);
+        printf(" TinyLFU 절약 읽기: %-9llu | 미룬 더티 희생자: %-9llu | write-around: %llu\n",
+               tinylfu.saved_reads, tinylfu.kept_dirty, tinylfu.write_arounds);
+    }
+    if (readahead.enabled) {
+        printf(" 선반입 발생:    %-12llu | 선반입 페이지:  %-12llu | 선반입 I/O:   %llu\n", readahead.triggers, readahead.pages, readahead.ios);
+        printf(" 선반입 적중:    %-12llu | 낭비(미참조 축출): %-9llu | 적중률:       %.2f%%\n", readahead.hits, readahead.wasted,
+               (readahead.pages == 0) ? 0.0 : (double)readahead.hits / readahead.pages * 100.0);
+        printf(" 선반입이 밀어낸 더티 희생자: %llu (교체 시 동기 write-back 에 포함되지 않음)\n", readahead.dirty_evictions);
+    }
+    if (device.enabled) {
+        printf("------------------------------------------------------------------------------------\n");
+        unsigned long long sim_ns = MAX(device.now_ns, device.last_done_ns);
+        printf(" 장치 모델 %s (%s-loop): 시뮬레이션 시간 %.3f s, 요청 %.0f IOPS, 장치 I/O 읽기 %llu / 쓰기 %llu / reset %llu\n",
+               device.cfg.name, device.open_loop ? "open" : "closed", sim_ns / 1e9,
+               (sim_ns == 0) ? 0.0 : (double)total_lba_requests_processed * 1e9 / sim_ns,
+               device.ios[OP_READ], device.ios[OP_WRITE], device.ios[OP_TRIM]);
+        unsigned long long total_ios = device.ios[OP_READ] + device.ios[OP_WRITE] + device.ios[OP_TRIM];
+        printf(" 평균 장치 대기 %.1f us, 채널 사용률 %.1f%%\n",
+               (total_ios == 0) ? 0.0 : (double)device.queue_wait_ns / total_ios / 1000.0,
+               (sim_ns == 0) ? 0.0 : (double)device.busy_ns / ((double)sim_ns * device.cfg.channels) * 100.0);
+        printf(" %-24s %10s %10s %9s %9s %9s %10s %11s\n", "정책 (요청 지연, us)", "요청", "평균", "p50", "p99", "p99.9", "최대", "IOPS");
+        for (int i = 0; i < NUM_POLICIES; i++) {
+            if (device.policy_hist[i].count == 0) continue;
+            hist_print_row(policy_names[i], &device.policy_hist[i], device.policy_elapsed_ns[i]);
+        }
+        if (timeseries.enabled) {
+            unsigned long long backlog = 0, peak_backlog = 0, peak_sec = 0, peak_arrivals = 0;
+            for (unsigned long long i = 0; i < timeseries.count; i++) {
+                backlog += timeseries.buckets[i].arrivals - timeseries.buckets[i].completions;
+                if (backlog > peak_backlog) { peak_backlog = backlog; peak_sec = i; }
+                if (timeseries.buckets[i].arrivals > peak_arrivals) peak_arrivals = timeseries.buckets[i].arrivals;
+            }
+            if (timeseries_write(timeseries_path) != 0) fprintf(stderr, "오류: 시계열 파일 '%s' 쓰기 실패: %s\n", timeseries_path, strerror(errno));
+            printf(" 시계열 %llu 초 (%s): 최대 도착 %llu 요청/s, 최대 backlog %llu 요청 (%llu 초)\n",
+                   timeseries.count, timeseries_path, peak_arrivals, peak_backlog, peak_sec);
+        }
+    }
+    if (lsl.enabled) {
+        printf("------------------------------------------------------------------------------------\n");
+        printf(" 로그 구조 계층: 재배치된 페이지 %llu개, 리다이렉트 읽기 %llu회\n", lsl.lba_to_phys.count, lsl.redirected_reads);
+        printf(" 논리 Zone %llu개 범위 밖 제자리 쓰기: %llu 페이지 (아래 write-back/WA 에 포함되지 않음)\n", lsl.logical_zones, lsl.out_of_range_writes);
+        printf(" %-24s %12s %12s %8s %8s\n", "정책", "write-back", "GC 복사", "GC 횟수", "WA");
+        for (int i = 0; i < NUM_POLICIES; i++) {
+            if (lsl.host_writes[i] == 0 && lsl.gc_copies[i] == 0) continue;
+            double wa = (lsl.host_writes[i] == 0) ? 0.0 : (double)(lsl.host_writes[i] + lsl.gc_copies[i]) / lsl.host_writes[i];
+            printf(" %-24s %12llu %12llu %8llu %8.3f\n", policy_names[i], lsl.host_writes[i], lsl.gc_copies[i], lsl.gc_runs[i], wa);
+        }
+    }
+#ifdef T30_PROFILE
+    prof_report();
+#endif
     printf("------------------------------------------------------------------------------------\n");
     printf(" (참고: 미스 카운트에는 쓰기 미스 시 초기 필수 읽기(쓰기 할당)가 포함됩니다.)\n");
     printf(" (참고: ZNS 활성 시 비순차 쓰기는 stderr로 경고/오류 출력 후 로그에는 기록될 수 있습니다.)\n");
     printf(" (FIO 로그 생성됨: %s)\n", log_filename);
+    if (metrics.enabled) printf(" (지표 %llu 행 기록됨: %s)\n", metrics.rows, metrics_path);
     printf("====================================================================================\n");
 
+    metrics_close();
+    timeseries_free();
+    device_free();
+    readahead_free();
+    tinylfu_free();
+    flusher_free();
+    lsl_free();
+    zns_free();
     return 0;
 }
@@ -0,0 +1,267 @@
+// 트레이스 특징 추출 (xg.c 예측기와 test30 --label 라벨 생성기가 같은 코드를 사용)
+// log2 는 TRACE_FEATURES_LOG2 로 바꿀 수 있음 (libm 을 링크하지 않는 test30 용)
+// 헤더에 구현을 두므로 모든 함수는 static, 이름은 tf_ 로 시작 (포함하는 쪽의 이름과 겹치지 않게)
+#ifndef TRACE_FEATURES_H
+#define TRACE_FEATURES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#ifndef TRACE_FEATURES_LOG2
+#include <math.h>
+#define TRACE_FEATURES_LOG2(x) log2(x)
+#endif
+
+// ===================================================================
+// 1. 특징(Features) 구조체 정의
+// ===================================================================
+typedef struct {
+    double read_ratio;
+    double avg_reuse_distance;
+    double max_reuse_distance;
+    double access_locality;
+    double unique_address_ratio;
+    double entropy;
+    double rw_switch_rate;
+    double seq_access_ratio;
+} TraceFeatures;
+
+// ===================================================================
+// 2. 해시 테이블 구현
+// ===================================================================
+typedef struct TfHashNode {
+    long key;
+    int last_index;
+    int count;
+    struct TfHashNode* next;
+} TfHashNode;
+
+typedef struct TfHashTable {
+    int size;
+    int item_count;
+    TfHashNode** buckets;
+} TfHashTable;
+
+// 해시 함수
+static unsigned int tf_hash_function(long key, int size) {
+    return (unsigned int)(key % size);
+}
+
+// 새 해시 테이블 생성
+static TfHashTable* tf_create_hash_table(int size) {
+    TfHashTable* table = (TfHashTable*)malloc(sizeof(TfHashTable));
+    if (!table) {
+        perror("Failed to allocate TfHashTable");
+        exit(EXIT_FAILURE);
+    }
+    table->size = size;
+    table->item_count = 0;
+    table->buckets = (TfHashNode**)calloc(size, sizeof(TfHashNode*));
+    if (!table->buckets) {
+        perror("Failed to allocate TfHashTable buckets");
+        free(table);
+        exit(EXIT_FAILURE);
+    }
+    return table;
+}
+
+// 해시 테이블에 노드 삽입 또는 업데이트
+static TfHashNode* tf_insert_hash_node(TfHashTable* table, long key, int current_index) {
+    unsigned int bucket_index = tf_hash_function(key, table->size);
+    TfHashNode* current = table->buckets[bucket_index];
+    TfHashNode* prev = NULL;
+
+    while (current != NULL) {
+        if (current->key == key) {
+            current->count++;
+            return current;
+        }
+        prev = current;
+        current = current->next;
+    }
+
+    TfHashNode* newNode = (TfHashNode*)malloc(sizeof(TfHashNode));
+    if (!newNode) {
+        perror("Failed to allocate TfHashNode");
+        return NULL; 
+    }
+    newNode->key = key;
+    newNode->last_index = current_index;
+    newNode->count = 1;
+    newNode->next = NULL;
+
+    if (prev == NULL) {
+        table->buckets[bucket_index] = newNode;
+    } else {
+        prev->next = newNode;
+    }
+    table->item_count++;
+    return newNode;
+}
+
+// 해시 테이블에서 노드 검색
+static TfHashNode* tf_find_hash_node(TfHashTable* table, long key) {
+    unsigned int bucket_index = tf_hash_function(key, table->size);
+    TfHashNode* current = table->buckets[bucket_index];
+    while (current != NULL) {
+        if (current->key == key) {
+            return current;
+        }
+        current = current->next;
+    }
+    return NULL;
+}
+
+// 해시 테이블 메모리 해제
+static void tf_free_hash_table(TfHashTable* table) {
+    if (!table) return;
+    for (int i = 0; i < table->size; i++) {
+        TfHashNode* current = table->buckets[i];
+        while (current != NULL) {
+            TfHashNode* temp = current;
+            current = current->next;
+            free(temp);
+        }
+    }
+    free(table->buckets);
+    free(table);
+}
+
+// ===================================================================
+// 3. 트레이스 줄 파싱
+// ===================================================================
+// test30 의 trace_next 와 같은 텍스트 문법: "[@시각_us] LBA Op [길이_섹터]", 빈 줄/# 주석/P 명령은 접근이 아님.
+// 특징은 요청의 시작 LBA 와 작업 유형만 쓴다 (시각과 길이는 건너뜀). 접근 요청이면 1
+static int tf_parse_line(const char* line, long* lba, char* op) {
+    while (isspace((unsigned char)*line)) line++;
+    if (*line == '@') {
+        char* ts_end;
+        strtod(line + 1, &ts_end);
+        if (ts_end == line + 1 || !isspace((unsigned char)*ts_end)) return 0;
+        line = ts_end;
+        while (isspace((unsigned char)*line)) line++;
+    }
+    if (!isdigit((unsigned char)*line)) return 0;   // 빈 줄, 주석, P 명령
+    char op_str[3];
+    if (sscanf(line, "%ld %2s", lba, op_str) != 2) return 0;
+    if (op_str[0] != 'R' && op_str[0] != 'r' && op_str[0] != 'W' && op_str[0] != 'w') return 0;
+    *op = op_str[0];
+    return 1;
+}
+
+// ===================================================================
+// 4. 점진적 특징 추출 함수
+// ===================================================================
+static TraceFeatures tf_extract_features_incremental(char** lines, int start_line, int end_line) {
+    TraceFeatures features = {0};
+    
+    if (start_line >= end_line) return features;
+    
+    TfHashTable* lba_table = tf_create_hash_table(10000);
+    
+    long total_accesses = 0;
+    long read_count = 0;
+    long rw_switches = 0;
+    long sequential_accesses = 0;
+
+    char last_op = '\0', current_op;
+    long last_lba = -1, current_lba;
+
+    double* reuse_distances = NULL;
+    size_t reuse_capacity = 1024;
+    size_t reuse_count = 0;
+    reuse_distances = (double*)malloc(reuse_capacity * sizeof(double));
+    if (!reuse_distances) {
+        tf_free_hash_table(lba_table);
+        return features;
+    }
+
+    int current_index = 0;
+
+    for (int line_idx = start_line; line_idx < end_line; line_idx++) {
+        if (!tf_parse_line(lines[line_idx], &current_lba, &current_op)) {
+            continue;
+        }
+        total_accesses++;
+        
+        if (current_op == 'R' || current_op == 'r') {
+            read_count++;
+        }
+
+        if (last_op != '\0' && last_op != current_op) {
+            rw_switches++;
+        }
+        last_op = current_op;
+
+        if (last_lba != -1 && current_lba == last_lba + 1) {
+            sequential_accesses++;
+        }
+        
+        TfHashNode* node = tf_find_hash_node(lba_table, current_lba);
+        if (node == NULL) {
+            tf_insert_hash_node(lba_table, current_lba, current_index); 
+        } else {
+            if (reuse_count >= reuse_capacity) {
+                reuse_capacity *= 2;
+                double* new_rd = (double*)realloc(reuse_distances, reuse_capacity * sizeof(double));
+                if (!new_rd) {
+                    free(reuse_distances);
+                    tf_free_hash_table(lba_table);
+                    return features;
+                }
+                reuse_distances = new_rd;
+            }
+            reuse_distances[reuse_count++] = (double)(current_index - node->last_index);
+            node->last_index = current_index;
+            node->count++;
+        }
+        last_lba = current_lba;
+        current_index++;
+    }
+
+    // 특징 계산
+    if (total_accesses > 0) {
+        features.read_ratio = (double)read_count / total_accesses;
+        features.rw_switch_rate = (double)rw_switches / total_accesses;
+        features.seq_access_ratio = (double)sequential_accesses / total_accesses;
+        features.unique_address_ratio = (double)lba_table->item_count / total_accesses;
+        features.access_locality = 1.0 - features.unique_address_ratio;
+    }
+
+    // Reuse Distance 계산
+    if (reuse_count > 0) {
+        double sum_reuse = 0;
+        double max_reuse = 0;
+        for (size_t i = 0; i < reuse_count; i++) {
+            sum_reuse += reuse_distances[i];
+            if (reuse_distances[i] > max_reuse) {
+                max_reuse = reuse_distances[i];
+            }
+        }
+        features.avg_reuse_distance = sum_reuse / reuse_count;
+        features.max_reuse_distance = max_reuse;
+    }
+
+    // Entropy 계산
+    if (total_accesses > 0 && lba_table->item_count > 0) {
+        double entropy_val = 0;
+        for (int i = 0; i < lba_table->size; i++) {
+            TfHashNode* current_node = lba_table->buckets[i];
+            while (current_node != NULL) {
+                double p_x = (double)current_node->count / total_accesses;
+                if (p_x > 0) {
+                    entropy_val -= p_x * TRACE_FEATURES_LOG2(p_x);
+                }
+                current_node = current_node->next;
+            }
+        }
+        features.entropy = entropy_val;
+    }
+    
+    if (reuse_distances) free(reuse_distances);
+    tf_free_hash_table(lba_table);
+    return features;
+}
+
+#endif // TRACE_FEATURES_H
@@ -2,7 +2,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 #include <xgboost/c_api.h>
+#include "trace_features.h"   // TraceFeatures, tf_extract_features_incremental
 
 // ===================================================================
 // 0. Error Handling Macro for XGBoost Calls
@@ -16,122 +18,7 @@
 }
 
 // ===================================================================
-// 1. 특징(Features) 및 데이터 저장을 위한 구조체 정의
-// ===================================================================
-typedef struct {
-    double read_ratio;
-    double avg_reuse_distance;
-    double max_reuse_distance;
-    double access_locality;
-    double unique_address_ratio;
-    double entropy;
-    double rw_switch_rate;
-    double seq_access_ratio;
-} TraceFeatures;
-
-// ===================================================================
-// 2. 해시 테이블 구현
-// ===================================================================
-typedef struct HashNode {
-    long key;
-    int last_index;
-    int count;
-    struct HashNode* next;
-} HashNode;
-
-typedef struct HashTable {
-    int size;
-    int item_count;
-    HashNode** buckets;
-} HashTable;
-
-// 해시 함수
-unsigned int hash_function(long key, int size) {
-    return (unsigned int)(key % size);
-}
-
-// 새 해시 테이블 생성
-HashTable* create_hash_table(int size) {
-    HashTable* table = (HashTable*)malloc(sizeof(HashTable));
-    if (!table) {
-        perror("Failed to allocate HashTable");
-        exit(EXIT_FAILURE);
-    }
-    table->size = size;
-    table->item_count = 0;
-    table->buckets = (HashNode**)calloc(size, sizeof(HashNode*));
-    if (!table->buckets) {
-        perror("Failed to allocate HashTable buckets");
-        free(table);
-        exit(EXIT_FAILURE);
-    }
-    return table;
-}
-
-// 해시 테이블에 노드 삽입 또는 업데이트
-HashNode* insert_hash_node(HashTable* table, long key, int current_index) {
-    unsigned int bucket_index = hash_function(key, table->size);
-    HashNode* current = table->buckets[bucket_index];
-    HashNode* prev = NULL;
-
-    while (current != NULL) {
-        if (current->key == key) {
-            current->count++;
-            return current;
-        }
-        prev = current;
-        current = current->next;
-    }
-
-    HashNode* newNode = (HashNode*)malloc(sizeof(HashNode));
-    if (!newNode) {
-        perror("Failed to allocate HashNode");
-        return NULL; 
-    }
-    newNode->key = key;
-    newNode->last_index = current_index;
-    newNode->count = 1;
-    newNode->next = NULL;
-
-    if (prev == NULL) {
-        table->buckets[bucket_index] = newNode;
-    } else {
-        prev->next = newNode;
-    }
-    table->item_count++;
-    return newNode;
-}
-
-// 해시 테이블에서 노드 검색
-HashNode* find_hash_node(HashTable* table, long key) {
-    unsigned int bucket_index = hash_function(key, table->size);
-    HashNode* current = table->buckets[bucket_index];
-    while (current != NULL) {
-        if (current->key == key) {
-            return current;
-        }
-        current = current->next;
-    }
-    return NULL;
-}
-
-// 해시 테이블 메모리 해제
-void free_hash_table(HashTable* table) {
-    if (!table) return;
-    for (int i = 0; i < table->size; i++) {
-        HashNode* current = table->buckets[i];
-        while (current != NULL) {
-            HashNode* temp = current;
-            current = current->next;
-            free(temp);
-        }
-    }
-    free(table->buckets);
-    free(table);
-}
-
-// ===================================================================
-// 3. 라벨 인코더 구현
+// 1. 라벨 인코더 구현
 // ===================================================================
 typedef struct {
     char** labels;
@@ -245,121 +132,7 @@ void free_label_encoder(LabelEncoder* encoder) {
 }
 
 // ===================================================================
-// 4. 점진적 특징 추출 함수
-// ===================================================================
-TraceFeatures extract_features_incremental(char** lines, int start_line, int end_line) {
-    TraceFeatures features = {0};
-    
-    if (start_line >= end_line) return features;
-    
-    HashTable* lba_table = create_hash_table(10000);
-    
-    long total_accesses = 0;
-    long read_count = 0;
-    long rw_switches = 0;
-    long sequential_accesses = 0;
-
-    char last_op = '\0', current_op;
-    long last_lba = -1, current_lba;
-
-    double* reuse_distances = NULL;
-    size_t reuse_capacity = 1024;
-    size_t reuse_count = 0;
-    reuse_distances = (double*)malloc(reuse_capacity * sizeof(double));
-    if (!reuse_distances) {
-        free_hash_table(lba_table);
-        return features;
-    }
-
-    int current_index = 0;
-
-    for (int line_idx = start_line; line_idx < end_line; line_idx++) {
-        if (sscanf(lines[line_idx], "%ld %c", &current_lba, &current_op) != 2) {
-            continue;
-        }
-        total_accesses++;
-        
-        if (current_op == 'R' || current_op == 'r') {
-            read_count++;
-        }
-
-        if (last_op != '\0' && last_op != current_op) {
-            rw_switches++;
-        }
-        last_op = current_op;
-
-        if (last_lba != -1 && current_lba == last_lba + 1) {
-            sequential_accesses++;
-        }
-        
-        HashNode* node = find_hash_node(lba_table, current_lba);
-        if (node == NULL) {
-            insert_hash_node(lba_table, current_lba, current_index); 
-        } else {
-            if (reuse_count >= reuse_capacity) {
-                reuse_capacity *= 2;
-                double* new_rd = (double*)realloc(reuse_distances, reuse_capacity * sizeof(double));
-                if (!new_rd) {
-                    free(reuse_distances);
-                    free_hash_table(lba_table);
-                    return features;
-                }
-                reuse_distances = new_rd;
-            }
-            reuse_distances[reuse_count++] = (double)(current_index - node->last_index);
-            node->last_index = current_index;
-            node->count++;
-        }
-        last_lba = current_lba;
-        current_index++;
-    }
-
-    // 특징 계산
-    if (total_accesses > 0) {
-        features.read_ratio = (double)read_count / total_accesses;
-        features.rw_switch_rate = (double)rw_switches / total_accesses;
-        features.seq_access_ratio = (double)sequential_accesses / total_accesses;
-        features.unique_address_ratio = (double)lba_table->item_count / total_accesses;
-        features.access_locality = 1.0 - features.unique_address_ratio;
-    }
-
-    // Reuse Distance 계산
-    if (reuse_count > 0) {
-        double sum_reuse = 0;
-        double max_reuse = 0;
-        for (size_t i = 0; i < reuse_count; i++) {
-            sum_reuse += reuse_distances[i];
-            if (reuse_distances[i] > max_reuse) {
-                max_reuse = reuse_distances[i];
-            }
-        }
-        features.avg_reuse_distance = sum_reuse / reuse_count;
-        features.max_reuse_distance = max_reuse;
-    }
-
-    // Entropy 계산
-    if (total_accesses > 0 && lba_table->item_count > 0) {
-        double entropy_val = 0;
-        for (int i = 0; i < lba_table->size; i++) {
-            HashNode* current_node = lba_table->buckets[i];
-            while (current_node != NULL) {
-                double p_x = (double)current_node->count / total_accesses;
-                if (p_x > 0) {
-                    entropy_val -= p_x * log2(p_x);
-                }
-                current_node = current_node->next;
-            }
-        }
-        features.entropy = entropy_val;
-    }
-    
-    if (reuse_distances) free(reuse_distances);
-    free_hash_table(lba_table);
-    return features;
-}
-
-// ===================================================================
-// 5. 예측 함수
+// 2. 예측 함수
 // ===================================================================
 int predict_policy(TraceFeatures features, BoosterHandle booster) {
     float feature_array[8] = {
@@ -404,9 +177,122 @@ int predict_policy(TraceFeatures features, BoosterHandle booster) {
 }
 
 // ===================================================================
-// 6. 메인 함수
+// 3. 트레이스 로딩 및 벤치마크
+// ===================================================================
+
+// 트레이스 파일의 모든 라인을 메모리에 로드. 실패 시 NULL
+char** load_trace_lines(const char* trace_file, int* out_total_lines) {
+    FILE* fp = fopen(trace_file, "r");
+    if (!fp) {
+        perror("Failed to open trace file");
+        return NULL;
+    }
+
+    // 파일 라인 수 계산
+    char line_buffer[256];
+    int total_lines = 0;
+    while (fgets(line_buffer, sizeof(line_buffer), fp)) {
+        total_lines++;
+    }
+    rewind(fp);
+
+    // 모든 라인을 메모리에 저장
+    char** lines = (char**)malloc((total_lines > 0 ? total_lines : 1) * sizeof(char*));
+    if (!lines) {
+        perror("Failed to allocate lines array");
+        fclose(fp);
+        return NULL;
+    }
+
+    for (int i = 0; i < total_lines; i++) {
+        if (fgets(line_buffer, sizeof(line_buffer), fp)) {
+            int len = strlen(line_buffer);
+            lines[i] = (char*)malloc(len + 1);
+            strcpy(lines[i], line_buffer);
+        }
+    }
+    fclose(fp);
+    *out_total_lines = total_lines;
+    return lines;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// --bench 모드: 특징 추출 처리량과 1회 예측 지연을 측정해 "BENCH,이름,값,단위" 형식으로 출력
+int run_benchmark(const char* trace_file, const char* model_file, int window, int predict_calls) {
+    int total_lines = 0;
+    char** lines = load_trace_lines(trace_file, &total_lines);
+    if (!lines) return 1;
+    if (window <= 0 || window > total_lines) window = total_lines;
+
+    // 특징 추출: 트레이스를 window 라인씩 나눠 추출 (xg 의 세그먼트 처리와 같은 경로)
+    TraceFeatures features = {0};
+    long processed = 0;
+    double start = now_seconds();
+    for (int begin = 0; begin < total_lines; begin += window) {
+        int end = (begin + window < total_lines) ? begin + window : total_lines;
+        features = tf_extract_features_incremental(lines, begin, end);
+        processed += end - begin;
+    }
+    double elapsed = now_seconds() - start;
+    printf("BENCH,xg_feature_lines_per_sec,%.0f,lines/s\n", elapsed > 0 ? processed / elapsed : 0.0);
+    printf("BENCH,xg_feature_window,%d,lines\n", window);
+
+    // 예측 지연: 마지막 윈도우의 특징으로 predict_policy 를 반복 호출
+    if (model_file != NULL && predict_calls > 0) {
+        BoosterHandle booster;
+        safe_xgboost(XGBoosterCreate(NULL, 0, &booster));
+        safe_xgboost(XGBoosterLoadModel(booster, model_file));
+        double* lat = (double*)malloc(predict_calls * sizeof(double));
+        if (!lat) {
+            perror("Failed to allocate latency array");
+            return 1;
+        }
+        int predicted = predict_policy(features, booster); // 첫 호출(워밍업)은 제외
+        for (int i = 0; i < predict_calls; i++) {
+            double t0 = now_seconds();
+            predicted = predict_policy(features, booster);
+            lat[i] = (now_seconds() - t0) * 1e9;
+        }
+        qsort(lat, predict_calls, sizeof(double), compare_doubles);
+        double sum = 0;
+        for (int i = 0; i < predict_calls; i++) sum += lat[i];
+        printf("BENCH,xg_predict_mean_ns,%.0f,ns\n", sum / predict_calls);
+        printf("BENCH,xg_predict_p50_ns,%.0f,ns\n", lat[predict_calls / 2]);
+        printf("BENCH,xg_predict_p99_ns,%.0f,ns\n", lat[(int)(predict_calls * 0.99)]);
+        printf("BENCH,xg_predict_class,%d,class\n", predicted);
+        free(lat);
+        safe_xgboost(XGBoosterFree(booster));
+    }
+
+    for (int i = 0; i < total_lines; i++) {
+        free(lines[i]);
+    }
+    free(lines);
+    return 0;
+}
+
+// ===================================================================
+// 4. 메인 함수
 // ===================================================================
 int main(int argc, char *argv[]) {
+    // 벤치마크 모드: predictor --bench <trace> [model|-] [window] [predict_calls]
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        const char* bench_model = (argc > 3 && strcmp(argv[3], "-") != 0) ? argv[3] : NULL;
+        int bench_window = (argc > 4) ? atoi(argv[4]) : 10000;
+        int bench_calls = (argc > 5) ? atoi(argv[5]) : 1000;
+        return run_benchmark(argv[2], bench_model, bench_window, bench_calls);
+    }
+
     const char* trace_file = "detailed_zns_trace.txt";
     const char* model_file = "xgb_model.json";
     const char* encoder_file = "label_encoder.json";
@@ -431,37 +317,12 @@ int main(int argc, char *argv[]) {
     fclose(test_fp);
 
     // 전체 파일을 메모리에 로드
-    FILE* fp = fopen(trace_file, "r");
-    if (!fp) {
-        perror("Failed to open trace file");
-        return 1;
-    }
-
-    // 파일 라인 수 계산
-    char line_buffer[256];
     int total_lines = 0;
-    while (fgets(line_buffer, sizeof(line_buffer), fp)) {
-        total_lines++;
-    }
-    rewind(fp);
-
-    // 모든 라인을 메모리에 저장
-    char** lines = (char**)malloc(total_lines * sizeof(char*));
+    char** lines = load_trace_lines(trace_file, &total_lines);
     if (!lines) {
-        perror("Failed to allocate lines array");
-        fclose(fp);
         return 1;
     }
 
-    for (int i = 0; i < total_lines; i++) {
-        if (fgets(line_buffer, sizeof(line_buffer), fp)) {
-            int len = strlen(line_buffer);
-            lines[i] = (char*)malloc(len + 1);
-            strcpy(lines[i], line_buffer);
-        }
-    }
-    fclose(fp);
-
     // XGBoost 모델 로딩
     printf("Loading XGBoost model...\n");
     BoosterHandle booster;
@@ -495,7 +356,7 @@ int main(int argc, char *argv[]) {
         printf("Processing segment %d/10 (lines 0-%d)...\n", segment, end_line-1);
         
         // 현재 세그먼트까지의 특징 추출
-        TraceFeatures features = extract_features_incremental(lines, 0, end_line);
+        TraceFeatures features = tf_extract_features_incremental(lines, 0, end_line);
         
         // 정책 예측
         int current_policy = predict_policy(features, booster);